@@ -0,0 +1,299 @@
+// Bot decisions per second of the shared AI navigation data (src/ai_navigation.h) against a
+// breadth-first search per bot and decision, for several map sizes and bot counts.
+//
+//     ai_navigation_bench [--verify] [ticks] [block density]
+//
+// Bots start on random floor cells and are driven by AINavigation::decide: they drop bombs
+// next to breakable blocks (range 2, 60 tick fuse), flee blasts and walk toward the next
+// block; the map is refilled when most blocks are gone. The sparser the blocks (default 0.1),
+// the further a bot has to look for its next one. The shared figure includes keeping
+// the danger map and flow fields up to date (AINavigation::bombPlaced and update). The
+// per-bot search answers the same question on the same game state: a BFS from the bot to the
+// nearest safe cell or bomb spot, taking the danger of a cell from the shared danger map, so
+// it only pays for the path search itself. It runs for up to 256 bots per tick.
+//
+// --verify also builds a fresh AINavigation from the game state after every tick and compares
+// the incrementally updated danger map and flow fields with it cell by cell, and first checks
+// that a bot does not bomb itself into a dead end; the bench exits with 1 at the first
+// failure. The fresh builds are not part of the timings.
+#include "ai_navigation.h"
+#include "blast_system.h"
+#include "tile_grid.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+    const int BOMB_RANGE = 2;
+    const int BOMB_FUSE = 60;
+    const std::size_t BASELINE_BOTS = 256;
+
+    double secondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    struct Bot
+    {
+        int x;
+        int z;
+    };
+
+    // the next step toward the nearest goal cell with a fresh BFS
+    class PerBotSearch
+    {
+    public:
+        explicit PerBotSearch(const TileGrid& grid)
+            : grid(grid), visited(static_cast<std::size_t>(grid.width()) * grid.height(), 0),
+              firstStep(visited.size(), -1)
+        {
+        }
+
+        template <typename IsGoal, typename IsWalkable>
+        int firstStepToward(int x, int z, IsGoal isGoal, IsWalkable isWalkable)
+        {
+            if (++stamp == 0)
+            {
+                std::fill(visited.begin(), visited.end(), 0);
+                stamp = 1;
+            }
+            frontier.clear();
+            int start = grid.index(x, z);
+            if (isGoal(x, z))
+                return FlowField::NO_DIRECTION;
+            visited[start] = stamp;
+            frontier.push_back(start);
+            for (std::size_t next = 0; next < frontier.size(); next++)
+            {
+                int cell = frontier[next];
+                int cx = cell % grid.width(), cz = cell / grid.width();
+                for (int dir = 0; dir < 4; dir++)
+                {
+                    int nx = cx + TileGrid::DX[dir], nz = cz + TileGrid::DZ[dir];
+                    if (!grid.inBounds(nx, nz) || !isWalkable(nx, nz))
+                        continue;
+                    int neighbour = grid.index(nx, nz);
+                    if (visited[neighbour] == stamp)
+                        continue;
+                    visited[neighbour] = stamp;
+                    firstStep[neighbour] = cell == start ? dir : firstStep[cell];
+                    if (isGoal(nx, nz))
+                        return firstStep[neighbour];
+                    frontier.push_back(neighbour);
+                }
+            }
+            return FlowField::NO_DIRECTION;
+        }
+
+    private:
+        const TileGrid& grid;
+        std::vector<std::uint32_t> visited;
+        std::vector<int> firstStep;
+        std::vector<int> frontier;
+        std::uint32_t stamp = 0;
+    };
+
+    bool sameField(const FlowField& field, const FlowField& fresh, int cell)
+    {
+        return field.isWalkable(cell) == fresh.isWalkable(cell) && field.isGoal(cell) == fresh.isGoal(cell)
+            && field.distance(cell) == fresh.distance(cell);
+    }
+
+    // every cell of the incrementally updated navigation data against a fresh build
+    bool matchesRebuild(const AINavigation& navigation, const TileGrid& grid, const BlastSystem& blasts, int tick)
+    {
+        AINavigation fresh(grid, blasts);
+        for (int z = 0; z < grid.height(); z++)
+        {
+            for (int x = 0; x < grid.width(); x++)
+            {
+                int cell = grid.index(x, z);
+                const char* differs = NULL;
+                if (navigation.dangerMap().ticksUntilBlast(x, z) != fresh.dangerMap().ticksUntilBlast(x, z))
+                    differs = "danger map";
+                else if (!sameField(navigation.fleeField(), fresh.fleeField(), cell))
+                    differs = "flee field";
+                else if (!sameField(navigation.attackField(), fresh.attackField(), cell))
+                    differs = "attack field";
+                if (differs != NULL)
+                {
+                    std::printf("%dx%d tick %d: %s differs from a fresh AINavigation at (%d, %d)\n", grid.width(),
+                        grid.height(), tick, differs, x, z);
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // a bot next to a breakable block in a dead-end corridor must only drop a bomb when it can
+    // walk out of the blast: not with one free cell behind it (range 2 covers it), but once
+    // the corridor turns a corner within reach
+    bool escapesDeadEnds()
+    {
+        TileGrid grid(15, 15);
+        for (int z = 5; z <= 9; z++)
+            for (int x = 1; x <= 9; x++)
+                grid.setCell(x, z, CellType::RedBlock);
+        grid.setCell(2, 7, CellType::Breakable);
+        grid.setCell(3, 7, CellType::Floor);
+        grid.setCell(4, 7, CellType::Floor);
+        BlastSystem blasts(grid);
+        AINavigation pocket(grid, blasts);
+        if (pocket.decide(3, 7, BOMB_RANGE, BOMB_FUSE).placeBomb)
+        {
+            std::printf("a bot drops a bomb in a dead end its blast fills\n");
+            return false;
+        }
+
+        grid.setCell(5, 7, CellType::Floor);
+        grid.setCell(5, 8, CellType::Floor);
+        AINavigation corner(grid, blasts);
+        if (!corner.decide(3, 7, BOMB_RANGE, BOMB_FUSE).placeBomb)
+        {
+            std::printf("a bot does not drop a bomb next to a corner it can hide behind\n");
+            return false;
+        }
+        if (corner.decide(3, 7, BOMB_RANGE, 2).placeBomb)
+        {
+            std::printf("a bot drops a bomb whose fuse is too short to reach cover\n");
+            return false;
+        }
+        return true;
+    }
+
+    // false if --verify found a difference
+    bool benchArena(int size, std::size_t botCount, int ticks, float density, bool verify)
+    {
+        TileGrid grid(size, size);
+        grid.generateBreakableBlocks(1337, density);
+        std::size_t fullBlocks = grid.breakableCount();
+        BlastSystem blasts(grid);
+        AINavigation navigation(grid, blasts);
+        PerBotSearch search(grid);
+
+        std::vector<Bot> bots;
+        std::uint32_t random = 12345;
+        while (bots.size() < botCount)
+        {
+            random = random * 1664525u + 1013904223u;
+            int x = static_cast<int>((random >> 8) % static_cast<std::uint32_t>(size));
+            random = random * 1664525u + 1013904223u;
+            int z = static_cast<int>((random >> 8) % static_cast<std::uint32_t>(size));
+            if (!grid.isSolid(x, z))
+                bots.push_back({ x, z });
+        }
+
+        auto isWalkable = [&](int x, int z) { return !grid.isSolid(x, z) && !blasts.hasBomb(x, z); };
+        auto isSafe = [&](int x, int z) { return navigation.dangerMap().isSafe(grid.index(x, z)); };
+        auto isBombSpot = [&](int x, int z) { return navigation.attackField().isGoal(grid.index(x, z)); };
+
+        double sharedSeconds = 0.0, updateSeconds = 0.0, searchSeconds = 0.0;
+        std::size_t sharedDecisions = 0, searchDecisions = 0, bombs = 0, touched = 0, refills = 0;
+        long checksum = 0;
+        std::vector<BotDecision> decisions(bots.size());
+        for (int tick = 0; tick < ticks; tick++)
+        {
+            if (grid.breakableCount() < fullBlocks / 4)
+            {
+                grid.generateBreakableBlocks(static_cast<std::uint64_t>(tick), density);
+                blasts.clear();
+                navigation.rebuild();
+                navigation.takeTouchedCells();
+                refills++;
+            }
+
+            const BlastSystem::TickResult& result = blasts.tick();
+            auto start = std::chrono::steady_clock::now();
+            navigation.update(result);
+            double update = secondsSince(start);
+
+            start = std::chrono::steady_clock::now();
+            for (std::size_t i = 0; i < bots.size(); i++)
+            {
+                Bot& bot = bots[i];
+                decisions[i] = navigation.decide(bot.x, bot.z, BOMB_RANGE, BOMB_FUSE);
+                if (decisions[i].placeBomb && blasts.placeBomb(bot.x, bot.z, BOMB_RANGE, BOMB_FUSE))
+                {
+                    navigation.bombPlaced(bot.x, bot.z);
+                    bombs++;
+                }
+            }
+            sharedSeconds += update + secondsSince(start);
+            updateSeconds += update;
+            sharedDecisions += bots.size();
+            touched += navigation.takeTouchedCells();
+            if (verify && !matchesRebuild(navigation, grid, blasts, tick))
+                return false;
+
+            // the same decisions with a search per bot (bombs already placed this tick make
+            // their cells unsafe for it, which does not change the amount of work much)
+            start = std::chrono::steady_clock::now();
+            for (std::size_t i = 0; i < std::min(bots.size(), BASELINE_BOTS); i++)
+            {
+                const Bot& bot = bots[i];
+                bool inDanger = !isSafe(bot.x, bot.z);
+                int dir = inDanger ? search.firstStepToward(bot.x, bot.z, isSafe, isWalkable)
+                                   : search.firstStepToward(bot.x, bot.z, isBombSpot, isWalkable);
+                checksum += dir;
+            }
+            searchSeconds += secondsSince(start);
+            searchDecisions += std::min(bots.size(), BASELINE_BOTS);
+
+            for (std::size_t i = 0; i < bots.size(); i++)
+            {
+                int dir = decisions[i].direction;
+                if (dir == FlowField::NO_DIRECTION)
+                    continue;
+                int x = bots[i].x + TileGrid::DX[dir], z = bots[i].z + TileGrid::DZ[dir];
+                if (grid.inBounds(x, z) && isWalkable(x, z))
+                {
+                    bots[i].x = x;
+                    bots[i].z = z;
+                }
+            }
+        }
+
+        double shared = sharedDecisions / sharedSeconds;
+        double perBot = searchDecisions / searchSeconds;
+        std::printf("%4dx%-4d %5zu bots  shared %12.0f decisions/s (%.3f ms/tick updating, %6zu cells/tick)"
+                    "  per-bot BFS %11.0f decisions/s  x%.0f  [%zu bombs, %zu refills, %ld]\n",
+            size, size, bots.size(), shared, updateSeconds * 1000.0 / ticks, touched / static_cast<std::size_t>(ticks),
+            perBot, shared / perBot, bombs, refills, checksum);
+        return true;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    bool verify = argc > 1 && std::strcmp(argv[1], "--verify") == 0;
+    if (verify)
+    {
+        argc--;
+        argv++;
+    }
+    if (verify && !escapesDeadEnds())
+        return 1;
+    int ticks = argc > 1 ? std::max(1, std::atoi(argv[1])) : 600;
+    float density = argc > 2 ? std::min(std::max(static_cast<float>(std::atof(argv[2])), 0.01f), 1.0f) : 0.1f;
+    const int sizes[] = { 15, 64, 256 };
+    const std::size_t botCounts[] = { 4, 64, 1024, 4096 };
+    for (int size : sizes)
+    {
+        for (std::size_t bots : botCounts)
+        {
+            // at most one bot per four cells
+            if (bots * 4 <= static_cast<std::size_t>(size) * size && !benchArena(size, bots, ticks, density, verify))
+                return 1;
+        }
+    }
+    if (verify)
+        std::printf("bots kept out of dead ends; danger map and flow fields matched a fresh AINavigation after every tick\n");
+    return 0;
+}
@@ -0,0 +1,111 @@
+// Crowd animation cost under different pose cache / LOD policies: 1000 characters playing the
+// Mixamo-style clip, most of them in groups that started the loop at nearly the same time
+// (idle crowds), spread over 0-60 units from the camera with a quarter of them off screen.
+// Prints the AnimationSystem counters averaged per frame.
+#include "mixamo_rig.h"
+
+#include "animation_system.h"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace
+{
+    double secondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    AnimationLodPolicy::Level level(float maxDistance, int updateInterval, int skipLeafLevels)
+    {
+        AnimationLodPolicy::Level result;
+        result.maxDistance = maxDistance;
+        result.updateInterval = updateInterval;
+        result.skipLeafLevels = skipLeafLevels;
+        return result;
+    }
+}
+
+int main()
+{
+    const double MIN_SECONDS = 1.0;
+    const float DT = 1.0f / 60.0f;
+    const int CHARACTERS = 1000;
+    const int GROUP_SIZE = 20;
+
+    MixamoRig rig = buildMixamoRig();
+    Animation animation(rig.clip.get(), rig.root.get(), rig.boneInfoMap, rig.boneCount);
+
+    std::mt19937 generator(3);
+    std::uniform_real_distribution<float> clipTime(0.0f, animation.GetDuration());
+    std::uniform_real_distribution<float> groupJitter(0.0f, 0.2f);
+    std::uniform_real_distribution<float> distance(0.0f, 60.0f);
+    std::uniform_real_distribution<float> chance(0.0f, 1.0f);
+    std::vector<Animator> initial(CHARACTERS, Animator(&animation));
+    std::vector<float> distances(CHARACTERS);
+    std::vector<bool> onScreen(CHARACTERS);
+    float groupStart = 0.0f;
+    for (int i = 0; i < CHARACTERS; i++)
+    {
+        if (i % GROUP_SIZE == 0)
+            groupStart = clipTime(generator);
+        // four in five characters belong to an idle group, the rest play on their own
+        float start = chance(generator) < 0.8f ? groupStart + groupJitter(generator) : clipTime(generator);
+        initial[i].AdvanceTime(start / animation.GetTicksPerSecond());
+        distances[i] = distance(generator);
+        onScreen[i] = chance(generator) >= 0.25f;
+    }
+
+    AnimationLodPolicy none;
+    AnimationLodPolicy cache;
+    cache.poseQuantum = 0.5f;
+    AnimationLodPolicy lod;
+    lod.levels = { level(10.0f, 1, 0), level(30.0f, 2, 1), level(60.0f, 4, 2) };
+    lod.offScreen = level(0.0f, 8, 3);
+    AnimationLodPolicy both = lod;
+    both.poseQuantum = cache.poseQuantum;
+    struct Run
+    {
+        const char* name;
+        const AnimationLodPolicy* policy;
+    } runs[] = { { "none", &none }, { "cache", &cache }, { "lod", &lod }, { "cache+lod", &both } };
+
+    JobSystem jobs;
+    std::printf("%d characters, %d bones, %u worker threads\n", CHARACTERS, rig.boneCount, jobs.workerCount());
+    std::printf("%-10s %10s %12s %14s %10s %12s %12s\n", "policy", "ms/update", "palettes/fr", "bones/frame", "hit rate",
+        "skipped/fr", "cached poses");
+    for (const Run& run : runs)
+    {
+        std::vector<Animator> animators = initial;
+        AnimationSystem system(jobs);
+        system.setLodPolicy(*run.policy);
+        for (int i = 0; i < CHARACTERS; i++)
+        {
+            system.add(&animators[i]);
+            system.setLodInput(i, distances[i], onScreen[i]);
+        }
+
+        AnimationStats total;
+        std::size_t updates = 0;
+        auto start = std::chrono::steady_clock::now();
+        while (secondsSince(start) < MIN_SECONDS)
+        {
+            system.update(DT);
+            const AnimationStats& stats = system.stats();
+            total.palettesEvaluated += stats.palettesEvaluated;
+            total.cacheHits += stats.cacheHits;
+            total.cacheMisses += stats.cacheMisses;
+            total.skippedUpdates += stats.skippedUpdates;
+            total.bonesEvaluated += stats.bonesEvaluated;
+            total.cachedPoses += stats.cachedPoses;
+            updates++;
+        }
+        double ms = 1e3 * secondsSince(start) / updates;
+        std::printf("%-10s %10.3f %12.1f %14.1f %9.1f%% %12.1f %12.1f\n", run.name, ms, double(total.palettesEvaluated) / updates,
+            double(total.bonesEvaluated) / updates, 100.0 * total.cacheHitRate(), double(total.skippedUpdates) / updates,
+            double(total.cachedPoses) / updates);
+    }
+    return 0;
+}
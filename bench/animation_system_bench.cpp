@@ -0,0 +1,93 @@
+// AnimationSystem scaling: milliseconds per update of 10, 100 and 1000 characters playing the
+// Mixamo-style clip, from the calling thread alone up to one thread per core. Every run starts
+// from the same character states and its palette is checked against the single-thread run.
+//
+//     animation_system_bench [max threads]   (default: hardware threads)
+#include "mixamo_rig.h"
+
+#include "animation_system.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // FNV-1a over the palette bytes
+    unsigned long long hashPalette(const AnimationSystem& system)
+    {
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(system.palettes());
+        std::size_t size = system.size() * AnimationSystem::PALETTE_STRIDE * sizeof(glm::mat4);
+        unsigned long long hash = 1469598103934665603ull;
+        for (std::size_t i = 0; i < size; i++)
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+        return hash;
+    }
+
+    double secondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const double MIN_SECONDS = 0.5;
+    const float DT = 1.0f / 60.0f;
+    const int CHECK_FRAMES = 30;
+
+    int maxThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    if (argc > 1)
+        maxThreads = std::max(1, std::atoi(argv[1]));
+
+    MixamoRig rig = buildMixamoRig();
+    Animation animation(rig.clip.get(), rig.root.get(), rig.boneInfoMap, rig.boneCount);
+
+    std::printf("%-11s %-8s %12s %12s %9s %8s\n", "characters", "threads", "ms/update", "us/char", "speedup", "palette");
+    const int characterCounts[] = { 10, 100, 1000 };
+    for (int characters : characterCounts)
+    {
+        // staggered start times, so characters are not all in the same key interval
+        std::vector<Animator> initial(characters, Animator(&animation));
+        for (int i = 0; i < characters; i++)
+            initial[i].AdvanceTime(0.37f * i);
+
+        double singleThreadMs = 0.0;
+        unsigned long long expectedHash = 0;
+        for (int threads = 1; threads <= maxThreads; threads++)
+        {
+            JobSystem jobs(threads - 1); // the calling thread works too
+            std::vector<Animator> animators = initial;
+            AnimationSystem system(jobs);
+            for (Animator& animator : animators)
+                system.add(&animator);
+
+            for (int frame = 0; frame < CHECK_FRAMES; frame++)
+                system.update(DT);
+            unsigned long long hash = hashPalette(system);
+            if (threads == 1)
+                expectedHash = hash;
+
+            std::size_t updates = 0;
+            auto start = std::chrono::steady_clock::now();
+            while (secondsSince(start) < MIN_SECONDS)
+            {
+                system.update(DT);
+                updates++;
+            }
+            double ms = 1e3 * secondsSince(start) / updates;
+            if (threads == 1)
+                singleThreadMs = ms;
+
+            std::printf("%-11d %-8d %12.3f %12.2f %8.2fx %8s\n", characters, threads, ms, 1e3 * ms / characters,
+                singleThreadMs / ms, hash == expectedHash ? "same" : "DIFFERS");
+            if (hash != expectedHash)
+                return 1;
+        }
+    }
+    return 0;
+}
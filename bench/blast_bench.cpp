@@ -0,0 +1,91 @@
+// Stress test of BlastSystem (src/blast_system.h): thousands of bombs ticking on a large map,
+// with the population topped up every tick, measured in ticks per second. Also checks that a
+// long chain of bombs goes off within a single tick.
+//
+//     blast_bench [map size] [bombs] [ticks]
+//
+// Defaults to 512x512 cells, 4096 bombs and 2000 ticks. The breakable blocks are regenerated
+// whenever fewer than a quarter of them are left, so the blasts keep hitting blocks.
+#include "blast_system.h"
+#include "tile_grid.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace
+{
+    // one bomb on every free cell of row z, all with a long fuse except the first
+    bool benchChain(int size)
+    {
+        TileGrid grid(size, size);
+        BlastSystem blasts(grid);
+        int z = 1; // row 1 is free of red blocks
+        int placed = 0;
+        for (int x = 1; x < size - 1; x++)
+            placed += blasts.placeBomb(x, z, 1, x == 1 ? 1 : 1000);
+
+        auto start = std::chrono::steady_clock::now();
+        const BlastSystem::TickResult& result = blasts.tick();
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        bool ok = result.detonated == static_cast<unsigned int>(placed) && blasts.bombCount() == 0;
+        std::printf("chain: %d bombs in a row, %u went off in one tick (%.3f ms, %zu blast cells) %s\n", placed, result.detonated, ms,
+            result.blast.size(), ok ? "ok" : "FAILED");
+        return ok;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    int size = argc > 1 ? std::max(16, std::atoi(argv[1])) : 512;
+    int bombs = argc > 2 ? std::max(1, std::atoi(argv[2])) : 4096;
+    int ticks = argc > 3 ? std::max(1, std::atoi(argv[3])) : 2000;
+    const int RANGE = 3, MAX_FUSE = 180;
+
+    TileGrid grid(size, size);
+    grid.generateBreakableBlocks(1337, 0.6f);
+    std::size_t initialBreakables = grid.breakableCount();
+    BlastSystem blasts(grid);
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> cell(0, size - 1), fuse(1, MAX_FUSE);
+
+    // keep the population at the target: bombs go on random free cells
+    auto refill = [&]() {
+        for (int attempt = 0; blasts.bombCount() < static_cast<std::size_t>(bombs) && attempt < bombs * 8; attempt++)
+            blasts.placeBomb(cell(gen), cell(gen), RANGE, fuse(gen));
+    };
+    refill();
+    std::printf("%dx%d map, %zu bombs (range %d, fuse 1..%d ticks), %d ticks\n", size, size, blasts.bombCount(), RANGE, MAX_FUSE, ticks);
+
+    unsigned long long detonated = 0, destroyed = 0, blastCells = 0;
+    unsigned int maxDetonated = 0, regenerations = 0;
+    double tickSeconds = 0.0;
+    for (int tick = 0; tick < ticks; tick++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        const BlastSystem::TickResult& result = blasts.tick();
+        tickSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        detonated += result.detonated;
+        destroyed += result.destroyed.size();
+        blastCells += result.blast.size() + result.destroyed.size();
+        maxDetonated = std::max(maxDetonated, result.detonated);
+
+        if (grid.breakableCount() < initialBreakables / 4)
+        {
+            grid.generateBreakableBlocks(1337 + tick, 0.6f);
+            blasts.clear();
+            regenerations++;
+        }
+        refill();
+    }
+
+    std::printf("%.0f ticks/s (%.3f ms per tick, refills not timed)\n", ticks / tickSeconds, tickSeconds * 1000.0 / ticks);
+    std::printf("%llu bombs went off (up to %u in one tick), %llu blocks destroyed, %llu cells blasted, %u map regenerations\n",
+        detonated, maxDetonated, destroyed, blastCells, regenerations);
+    std::printf("%.1f ns per blasted cell\n", blastCells ? tickSeconds * 1.0e9 / blastCells : 0.0);
+
+    return benchChain(size) ? 0 : 1;
+}
@@ -0,0 +1,262 @@
+// Bone palette upload of 1, 50 and 500 skinned characters per frame, three ways:
+//
+//   per bone       Animator::MAX_BONES string-keyed setMat4("finalBonesMatrices[i]") per
+//                  character, as in the LearnOpenGL skinning sample
+//   uniform array  one glUniformMatrix4fv of the rig's bones per character
+//   palette ring   every palette written into the frame's region of a BonePaletteBuffer
+//                  (src/bone_palette_buffer.h), one paletteOffset uniform per draw
+//
+//     bone_palette_bench [frames]
+//
+// Palettes come from an AnimationSystem playing the Mixamo-style clip, updated outside the
+// timing. Upload is the CPU time spent getting the palettes to GL, frame the upload plus the
+// draws; GL calls count the upload calls only (the draws are the same for every path). Each
+// character is a small skinned cylinder drawn into a 64x64 hidden window, and the last frame of
+// the uniform array and palette ring paths is compared pixel for pixel.
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <glm/gtc/matrix_inverse.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <learnopengl/filesystem.h>
+#include <learnopengl/shader_m.h>
+#include <learnopengl/mesh.h>
+
+#include "animation_system.h"
+#include "bone_palette_buffer.h"
+#include "frame_uniforms.h"
+#include "gl_context.h"
+#include "mixamo_rig.h"
+#include "shader_manager.h"
+#include "synthetic_character.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+    const float DT = 1.0f / 60.0f;
+    const int VIEWPORT = 64;
+
+    enum Path
+    {
+        PER_BONE = 0,
+        UNIFORM_ARRAY,
+        PALETTE_RING,
+        PATH_COUNT
+    };
+
+    const char* pathName(int path)
+    {
+        static const char* names[PATH_COUNT] = { "per bone", "uniform array", "palette ring" };
+        return names[path];
+    }
+
+    struct Samples
+    {
+        std::vector<double> uploadMs;
+        std::vector<double> frameMs;
+        unsigned long long glCalls = 0;
+        unsigned int stalls = 0;
+    };
+
+    double median(std::vector<double> values)
+    {
+        std::sort(values.begin(), values.end());
+        return values[values.size() / 2];
+    }
+
+    double msSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    std::vector<unsigned char> readPixels()
+    {
+        std::vector<unsigned char> pixels(VIEWPORT * VIEWPORT * 4);
+        glReadPixels(0, 0, VIEWPORT, VIEWPORT, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+        return pixels;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    int frames = argc > 1 ? std::max(1, std::atoi(argv[1])) : 100;
+
+    GLFWwindow* window = createHiddenContext("bone_palette_bench", VIEWPORT, VIEWPORT);
+    if (window == NULL)
+        return -1;
+    glViewport(0, 0, VIEWPORT, VIEWPORT);
+    glEnable(GL_DEPTH_TEST);
+
+    ShaderManager shaderManager;
+    std::unique_ptr<Shader> uniformShader = shaderManager.build(FileSystem::getPath("shaders/model.vs"),
+        FileSystem::getPath("shaders/model.fs"), { "SKINNED", "BONE_UNIFORMS" });
+    std::unique_ptr<Shader> ringShader = shaderManager.build(FileSystem::getPath("shaders/model.vs"),
+        FileSystem::getPath("shaders/model.fs"), { "SKINNED" });
+    for (Shader* shader : { uniformShader.get(), ringShader.get() })
+    {
+        shader->bindUniformBlock(FrameUniforms::BLOCK_NAME, FrameUniforms::BINDING_POINT);
+        shader->use();
+        shader->setInt("texture_diffuse1", 0);
+    }
+    ringShader->setInt(BonePaletteBuffer::SAMPLER_NAME, static_cast<int>(BonePaletteBuffer::TEXTURE_UNIT));
+    UniformHandle uniformModel = uniformShader->uniform("model");
+    UniformHandle uniformNormalMatrix = uniformShader->uniform("normalMatrix");
+    UniformHandle uniformBones = uniformShader->uniform("finalBonesMatrices");
+    UniformHandle ringModel = ringShader->uniform("model");
+    UniformHandle ringNormalMatrix = ringShader->uniform("normalMatrix");
+    UniformHandle ringOffset = ringShader->uniform(BonePaletteBuffer::OFFSET_NAME);
+
+    FrameUniforms frameUniforms;
+    glm::vec3 eye(0.0f, 900.0f, 1600.0f);
+    frameUniforms.setCamera(glm::perspective(glm::radians(45.0f), 1.0f, 10.0f, 5000.0f), glm::lookAt(eye, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f)), eye);
+    frameUniforms.setLight(glm::vec3(0.0f, 1000.0f, 1000.0f), glm::vec3(1.0f));
+    frameUniforms.upload();
+
+    // white stand-in for the diffuse texture, so the shading shows the skinned normals
+    unsigned int white;
+    unsigned char whitePixel[4] = { 255, 255, 255, 255 };
+    glGenTextures(1, &white);
+    glBindTexture(GL_TEXTURE_2D, white);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, whitePixel);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+
+    MixamoRig rig = buildMixamoRig();
+    Animation animation(rig.clip.get(), rig.root.get(), rig.boneInfoMap, rig.boneCount);
+    const std::size_t bones = static_cast<std::size_t>(rig.boneCount);
+    ModelCache::MeshData body = makeCharacterMesh(8, 12, rig.boneCount, {});
+    Mesh mesh(body.vertices, body.indices, {}, VertexFormat::CompactSkinned);
+
+    const int characterCounts[] = { 1, 50, 500 };
+    BonePaletteBuffer palettes(500 * bones);
+    GLStateCache stateCache;
+
+    std::printf("%d frames, %zu of %d bone matrices used per character, median per frame\n", frames, bones, Animator::MAX_BONES);
+    std::printf("%-11s %-14s %11s %11s %14s\n", "characters", "path", "upload ms", "frame ms", "upload calls");
+    for (int characters : characterCounts)
+    {
+        JobSystem jobs(0);
+        AnimationSystem system(jobs);
+        std::vector<Animator> animators(characters, Animator(&animation));
+        std::vector<glm::mat4> transforms;
+        std::vector<glm::mat3> normalMatrices;
+        for (int i = 0; i < characters; i++)
+        {
+            animators[i].AdvanceTime(0.37f * i);
+            system.add(&animators[i]);
+            transforms.push_back(glm::translate(glm::mat4(1.0f), glm::vec3((i % 25 - 12) * 60.0f, 0.0f, (i / 25 - 10) * 60.0f)));
+            normalMatrices.push_back(glm::inverseTranspose(glm::mat3(transforms.back())));
+        }
+        std::vector<GLint> offsets(characters);
+
+        // each returns the upload milliseconds and leaves the frame's draws submitted
+        std::function<double()> paths[PATH_COUNT] = {
+            [&]() {
+                double uploadMs = 0.0;
+                uniformShader->use();
+                for (int i = 0; i < characters; i++)
+                {
+                    auto start = std::chrono::steady_clock::now();
+                    const glm::mat4* palette = system.paletteOf(i);
+                    for (int bone = 0; bone < Animator::MAX_BONES; bone++)
+                        uniformShader->setMat4("finalBonesMatrices[" + std::to_string(bone) + "]", palette[bone]);
+                    uploadMs += msSince(start);
+                    uniformShader->setMat4(uniformModel, transforms[i]);
+                    uniformShader->setMat3(uniformNormalMatrix, normalMatrices[i]);
+                    mesh.Draw(*uniformShader);
+                }
+                return uploadMs;
+            },
+            [&]() {
+                double uploadMs = 0.0;
+                uniformShader->use();
+                for (int i = 0; i < characters; i++)
+                {
+                    auto start = std::chrono::steady_clock::now();
+                    glUniformMatrix4fv(uniformBones.location, static_cast<GLsizei>(bones), GL_FALSE, &system.paletteOf(i)[0][0][0]);
+                    uploadMs += msSince(start);
+                    uniformShader->setMat4(uniformModel, transforms[i]);
+                    uniformShader->setMat3(uniformNormalMatrix, normalMatrices[i]);
+                    mesh.Draw(*uniformShader);
+                }
+                return uploadMs;
+            },
+            [&]() {
+                auto start = std::chrono::steady_clock::now();
+                palettes.beginFrame();
+                for (int i = 0; i < characters; i++)
+                    offsets[i] = palettes.write(system.paletteOf(i), bones);
+                palettes.finish();
+                stateCache.invalidate();
+                palettes.bind(stateCache);
+                double uploadMs = msSince(start);
+                ringShader->use();
+                for (int i = 0; i < characters; i++)
+                {
+                    ringShader->setInt(ringOffset, offsets[i]);
+                    ringShader->setMat4(ringModel, transforms[i]);
+                    ringShader->setMat3(ringNormalMatrix, normalMatrices[i]);
+                    mesh.Draw(*ringShader);
+                }
+                return uploadMs;
+            },
+        };
+
+        Samples samples[PATH_COUNT];
+        std::vector<unsigned char> lastFrame[PATH_COUNT];
+        for (int frame = 0; frame < frames; frame++)
+        {
+            system.update(DT);
+            for (int path = 0; path < PATH_COUNT; path++)
+            {
+                glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+                glActiveTexture(GL_TEXTURE0);
+                glBindTexture(GL_TEXTURE_2D, white);
+                glFinish();
+                auto start = std::chrono::steady_clock::now();
+                samples[path].uploadMs.push_back(paths[path]());
+                samples[path].frameMs.push_back(msSince(start));
+                if (path == PER_BONE)
+                    samples[path].glCalls += static_cast<unsigned long long>(characters) * Animator::MAX_BONES;
+                else if (path == UNIFORM_ARRAY)
+                    samples[path].glCalls += characters;
+                else
+                {
+                    samples[path].glCalls += palettes.stats().glCalls + characters;
+                    samples[path].stalls += palettes.stats().stalls;
+                }
+                if (frame == frames - 1)
+                    lastFrame[path] = readPixels();
+                glFinish();
+            }
+        }
+
+        for (int path = 0; path < PATH_COUNT; path++)
+        {
+            std::printf("%-11d %-14s %11.4f %11.4f %14.1f", characters, pathName(path), median(samples[path].uploadMs),
+                median(samples[path].frameMs), static_cast<double>(samples[path].glCalls) / frames);
+            if (path == PALETTE_RING)
+                std::printf("   %u fence stalls", samples[path].stalls);
+            std::printf("\n");
+        }
+        if (lastFrame[UNIFORM_ARRAY] != lastFrame[PALETTE_RING])
+        {
+            std::printf("palette ring frame differs from the uniform array frame\n");
+            return 1;
+        }
+    }
+
+    palettes.release();
+    frameUniforms.release();
+    glDeleteTextures(1, &white);
+    glfwTerminate();
+    return 0;
+}
@@ -0,0 +1,331 @@
+// Movement resolution throughput of the CollisionWorld (src/collision_world.h) with 16, 256
+// and 4096 moving players, against the same swept resolution testing every pair of bodies.
+//
+//     collision_bench [ticks]
+//
+// Players (0.75 cells wide) walk the map along the axes at 24 units (about 0.1 cells) per
+// tick, block each other, blocks and bombs, turn when stopped and now and then at random, and
+// drop bombs whose blasts clear the breakable blocks. There is one pickup per two players;
+// a touched pickup moves to another free cell. The map grows with the player count to keep
+// roughly eight floor cells per player. Both resolvers get the same moves every tick and must
+// end up with the same positions. The query line times queryRadius (2 cells around a player)
+// and raycast (8 cells ahead of a player), 64 each per tick.
+#include "blast_system.h"
+#include "collision_world.h"
+#include "tile_grid.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+    typedef CollisionWorld::Body Body;
+
+    const std::int32_t SPEED = 24;
+    const std::int32_t PLAYER_HALF = 96;
+    const std::int32_t PICKUP_HALF = 64;
+    const int BOMB_RANGE = 2;
+    const int BOMB_FUSE = 120;
+    const int QUERIES_PER_TICK = 64;
+
+    std::uint64_t nextRandom(std::uint64_t& state)
+    {
+        std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    double median(std::vector<double> values)
+    {
+        std::sort(values.begin(), values.end());
+        return values[values.size() / 2];
+    }
+
+    // the resolution rules of CollisionWorld::resolve, testing every body against every other
+    class PairwiseWorld
+    {
+    public:
+        explicit PairwiseWorld(const CollisionWorld& world) : world(world) {}
+
+        std::vector<Body> bodies;
+        std::vector<std::int32_t> moveX, moveZ;
+        std::size_t contacts = 0;
+
+        void resolve()
+        {
+            for (std::size_t i = 0; i < bodies.size(); i++)
+            {
+                Body& b = bodies[i];
+                std::int32_t start[4] = { b.x - b.halfX, b.x + b.halfX, b.z - b.halfZ, b.z + b.halfZ };
+                for (int axis = 0; axis < 2; axis++)
+                {
+                    std::int32_t wanted = axis == 0 ? moveX[i] : moveZ[i];
+                    if (wanted != 0)
+                        (axis == 0 ? b.x : b.z) += sweep(i, axis, wanted, start);
+                }
+                moveX[i] = moveZ[i] = 0;
+            }
+            contacts = 0;
+            for (std::size_t i = 0; i < bodies.size(); i++)
+            {
+                for (std::size_t j = 0; j < bodies.size(); j++)
+                {
+                    const Body& a = bodies[i];
+                    const Body& b = bodies[j];
+                    if (j == i || !(a.touchMask & b.layer) || ((b.touchMask & a.layer) && j < i))
+                        continue;
+                    contacts += std::abs(a.x - b.x) <= a.halfX + b.halfX && std::abs(a.z - b.z) <= a.halfZ + b.halfZ;
+                }
+            }
+        }
+
+    private:
+        const CollisionWorld& world; // for its cell lookups
+
+        bool blocks(const Body& b, int x, int z, const std::int32_t start[4]) const
+        {
+            const std::int32_t U = CollisionWorld::UNITS_PER_CELL;
+            if (world.cellBlocks(x, z, b.blockMask & CollisionWorld::LAYER_BLOCK))
+                return true;
+            if (!world.cellBlocks(x, z, b.blockMask & CollisionWorld::LAYER_BOMB))
+                return false;
+            return !(start[0] < x * U + U && x * U < start[1] && start[2] < z * U + U && z * U < start[3]);
+        }
+
+        std::int32_t sweep(std::size_t i, int axis, std::int32_t wanted, const std::int32_t start[4]) const
+        {
+            const Body& b = bodies[i];
+            const std::int32_t U = CollisionWorld::UNITS_PER_CELL;
+            std::int32_t minA = axis == 0 ? b.x - b.halfX : b.z - b.halfZ;
+            std::int32_t maxA = axis == 0 ? b.x + b.halfX : b.z + b.halfZ;
+            std::int32_t minC = axis == 0 ? b.z - b.halfZ : b.x - b.halfX;
+            std::int32_t maxC = axis == 0 ? b.z + b.halfZ : b.x + b.halfX;
+            int c0 = CollisionWorld::cellOf(minC), c1 = CollisionWorld::cellOf(maxC - 1);
+            auto lineBlocks = [&](int a) {
+                for (int c = c0; c <= c1; c++)
+                    if (axis == 0 ? blocks(b, a, c, start) : blocks(b, c, a, start))
+                        return true;
+                return false;
+            };
+            std::int32_t allowed = wanted;
+            if (wanted > 0)
+            {
+                for (int a = CollisionWorld::cellOf(maxA - 1) + 1; a <= CollisionWorld::cellOf(maxA + wanted - 1); a++)
+                    if (lineBlocks(a))
+                    {
+                        allowed = a * U - maxA;
+                        break;
+                    }
+            }
+            else
+            {
+                for (int a = CollisionWorld::cellOf(minA) - 1; a >= CollisionWorld::cellOf(minA + wanted); a--)
+                    if (lineBlocks(a))
+                    {
+                        allowed = (a + 1) * U - minA;
+                        break;
+                    }
+            }
+            std::uint8_t bodyMask = b.blockMask & ~(CollisionWorld::LAYER_BLOCK | CollisionWorld::LAYER_BOMB);
+            for (std::size_t j = 0; j < bodies.size() && bodyMask != 0; j++)
+            {
+                const Body& other = bodies[j];
+                if (j == i || !(other.layer & bodyMask))
+                    continue;
+                std::int32_t otherMinA = axis == 0 ? other.x - other.halfX : other.z - other.halfZ;
+                std::int32_t otherMaxA = axis == 0 ? other.x + other.halfX : other.z + other.halfZ;
+                std::int32_t otherMinC = axis == 0 ? other.z - other.halfZ : other.x - other.halfX;
+                std::int32_t otherMaxC = axis == 0 ? other.z + other.halfZ : other.x + other.halfX;
+                if (!(minC < otherMaxC && otherMinC < maxC))
+                    continue;
+                if (wanted > 0 && otherMinA >= maxA)
+                    allowed = std::min(allowed, otherMinA - maxA);
+                else if (wanted < 0 && otherMaxA <= minA)
+                    allowed = std::max(allowed, otherMaxA - minA);
+            }
+            return allowed;
+        }
+    };
+
+    struct Result
+    {
+        int mapSize;
+        double resolveMs;
+        double pairwiseMs;
+        double pairTests;
+        double contacts;
+        double radiusNs;
+        double rayNs;
+        bool identical;
+    };
+
+    Result run(int players, int ticks)
+    {
+        Result result = {};
+        int mapSize = 15;
+        while ((mapSize - 2) * (mapSize - 2) * 3 / 4 < players * 8)
+            mapSize += 2;
+        result.mapSize = mapSize;
+
+        TileGrid grid(mapSize, mapSize);
+        std::uint64_t random = 1337;
+        grid.generateBreakableBlocks(nextRandom(random), 0.3f);
+        BlastSystem bombs(grid);
+        CollisionWorld world(grid, &bombs);
+        PairwiseWorld pairwise(world);
+
+        // distinct free cells for the players, then the pickups
+        std::vector<int> freeCells;
+        for (int z = 0; z < mapSize; z++)
+            for (int x = 0; x < mapSize; x++)
+                if (!grid.isSolid(x, z))
+                    freeCells.push_back(grid.index(x, z));
+        for (std::size_t i = freeCells.size(); i > 1; i--)
+            std::swap(freeCells[i - 1], freeCells[nextRandom(random) % i]);
+        int pickups = players / 2;
+
+        auto placeOn = [&](int cell, Body& body) {
+            body.x = CollisionWorld::cellCentre(cell % mapSize);
+            body.z = CollisionWorld::cellCentre(cell / mapSize);
+        };
+        std::vector<int> ids;
+        std::vector<int> direction(players);
+        for (int i = 0; i < players + pickups; i++)
+        {
+            Body body;
+            placeOn(freeCells[i], body);
+            if (i < players)
+            {
+                body.halfX = body.halfZ = PLAYER_HALF;
+                body.layer = CollisionWorld::LAYER_PLAYER;
+                body.blockMask = CollisionWorld::LAYER_BLOCK | CollisionWorld::LAYER_BOMB | CollisionWorld::LAYER_PLAYER;
+                body.touchMask = CollisionWorld::LAYER_PICKUP;
+                direction[i] = static_cast<int>(nextRandom(random) % 4);
+            }
+            else
+            {
+                body.halfX = body.halfZ = PICKUP_HALF;
+                body.layer = CollisionWorld::LAYER_PICKUP;
+                body.blockMask = 0;
+            }
+            ids.push_back(world.add(body));
+            pairwise.bodies.push_back(body);
+        }
+        pairwise.moveX.assign(ids.size(), 0);
+        pairwise.moveZ.assign(ids.size(), 0);
+
+        std::vector<double> resolveMs, pairwiseMs, radiusNs, rayNs;
+        std::vector<int> found;
+        double pairTests = 0.0, contacts = 0.0;
+        result.identical = true;
+        for (int tick = 0; tick < ticks; tick++)
+        {
+            // steering: turn when stopped or at random, sometimes drop a bomb
+            for (int i = 0; i < players; i++)
+            {
+                std::uint64_t draw = nextRandom(random);
+                if (world.blocked(ids[i]) || draw % 64 == 0)
+                    direction[i] = static_cast<int>((draw >> 8) % 4);
+                if ((draw >> 16) % 600 == 0)
+                {
+                    const Body& body = world.body(ids[i]);
+                    bombs.placeBomb(CollisionWorld::cellOf(body.x), CollisionWorld::cellOf(body.z), BOMB_RANGE, BOMB_FUSE);
+                }
+                std::int32_t dx = TileGrid::DX[direction[i]] * SPEED, dz = TileGrid::DZ[direction[i]] * SPEED;
+                world.setMove(ids[i], dx, dz);
+                pairwise.moveX[i] = dx;
+                pairwise.moveZ[i] = dz;
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            const std::vector<CollisionWorld::Contact>& touched = world.resolve();
+            resolveMs.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+            pairTests += world.stats().pairTests;
+            contacts += touched.size();
+
+            start = std::chrono::steady_clock::now();
+            pairwise.resolve();
+            pairwiseMs.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+            for (int i = 0; i < players && result.identical; i++)
+            {
+                const Body& a = world.body(ids[i]);
+                result.identical = a.x == pairwise.bodies[i].x && a.z == pairwise.bodies[i].z;
+            }
+            result.identical = result.identical && pairwise.contacts == touched.size();
+
+            // queries around and ahead of the first players
+            start = std::chrono::steady_clock::now();
+            for (int q = 0; q < QUERIES_PER_TICK; q++)
+            {
+                const Body& body = world.body(ids[q % players]);
+                world.queryRadius(body.x, body.z, 2 * CollisionWorld::UNITS_PER_CELL, CollisionWorld::LAYER_PLAYER | CollisionWorld::LAYER_PICKUP, found);
+            }
+            radiusNs.push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / QUERIES_PER_TICK);
+            start = std::chrono::steady_clock::now();
+            for (int q = 0; q < QUERIES_PER_TICK; q++)
+            {
+                int i = q % players;
+                const Body& body = world.body(ids[i]);
+                CollisionWorld::RayHit hit;
+                world.raycast(static_cast<float>(body.x), static_cast<float>(body.z), static_cast<float>(TileGrid::DX[direction[i]]),
+                    static_cast<float>(TileGrid::DZ[direction[i]]), 8.0f * CollisionWorld::UNITS_PER_CELL, CollisionWorld::LAYER_ALL, hit, ids[i]);
+            }
+            rayNs.push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / QUERIES_PER_TICK);
+
+            // touched pickups move on to another free cell, in both worlds
+            for (const CollisionWorld::Contact& contact : touched)
+            {
+                int pickup = contact.other;
+                if (!(world.body(pickup).layer & CollisionWorld::LAYER_PICKUP))
+                    continue;
+                int cell = freeCells[nextRandom(random) % freeCells.size()];
+                if (grid.isSolid(cell % mapSize, cell / mapSize))
+                    continue;
+                Body body = world.body(pickup);
+                placeOn(cell, body);
+                world.setPosition(pickup, body.x, body.z);
+                pairwise.bodies[pickup] = body; // nothing is removed, so ids are the body order
+            }
+            bombs.tick();
+        }
+
+        result.resolveMs = median(resolveMs);
+        result.pairwiseMs = median(pairwiseMs);
+        result.pairTests = pairTests / ticks;
+        result.contacts = contacts / ticks;
+        result.radiusNs = median(radiusNs);
+        result.rayNs = median(rayNs);
+        return result;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    int ticks = argc > 1 ? std::max(1, std::atoi(argv[1])) : 120;
+    const int playerCounts[] = { 16, 256, 4096 };
+
+    std::printf("%d ticks, median per tick\n", ticks);
+    std::printf("%-8s %-9s %11s %14s %13s %12s %10s %11s %9s\n", "players", "map", "resolve ms", "bodies/s", "pairwise ms",
+        "pair tests", "contacts", "radius ns", "ray ns");
+    bool identical = true;
+    for (int players : playerCounts)
+    {
+        Result r = run(players, ticks);
+        int bodies = players + players / 2;
+        char size[16];
+        std::snprintf(size, sizeof(size), "%dx%d", r.mapSize, r.mapSize);
+        std::printf("%-8d %-9s %11.4f %14.0f %13.4f %12.1f %10.1f %11.1f %9.1f\n", players, size, r.resolveMs,
+            bodies / (r.resolveMs / 1000.0), r.pairwiseMs, r.pairTests, r.contacts, r.radiusNs, r.rayNs);
+        if (!r.identical)
+        {
+            std::printf("  the pairwise resolver ended up with different positions or contacts\n");
+            identical = false;
+        }
+    }
+    return identical ? 0 : 1;
+}
@@ -0,0 +1,42 @@
+#ifndef GL_CONTEXT_H
+#define GL_CONTEXT_H
+
+// GL 3.3 core context for the benchmarks: a hidden GLFW window whose context is made current
+// and loaded through GLAD. Nothing is shown on screen; the benchmarks draw into the window's
+// default framebuffer or their own framebuffers and read back what they need.
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <cstdio>
+
+// returns NULL, after printing why and terminating GLFW, if there is no usable context
+inline GLFWwindow* createHiddenContext(const char* title, int width = 64, int height = 64)
+{
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+#ifdef __APPLE__
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+#endif
+
+    GLFWwindow* window = glfwCreateWindow(width, height, title, NULL, NULL);
+    if (window == NULL)
+    {
+        std::printf("Failed to create GLFW window\n");
+        glfwTerminate();
+        return NULL;
+    }
+    glfwMakeContextCurrent(window);
+    glfwSwapInterval(0); // buffer swaps in timed loops must not wait for vsync
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    {
+        std::printf("Failed to initialize GLAD\n");
+        glfwTerminate();
+        return NULL;
+    }
+    return window;
+}
+
+#endif
@@ -0,0 +1,221 @@
+// Keyframe sampling cost by clip length and bone count: the original Bone (linear key scan
+// from key 0, three mat4 products per bone) against the SoA tracks with per-instance cursors,
+// after resampling to a uniform rate, and under random seeks (binary search). Each "pose"
+// samples every bone once and produces its local matrix.
+#include <learnopengl/bone.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // the Bone sampling code before the keyframe engine, kept verbatim for comparison
+    class LegacyBone
+    {
+    public:
+        explicit LegacyBone(const aiNodeAnim* channel)
+        {
+            for (unsigned int i = 0; i < channel->mNumPositionKeys; ++i)
+                m_Positions.push_back({ AssimpGLMHelpers::GetGLMVec(channel->mPositionKeys[i].mValue), (float)channel->mPositionKeys[i].mTime });
+            for (unsigned int i = 0; i < channel->mNumRotationKeys; ++i)
+                m_Rotations.push_back({ AssimpGLMHelpers::GetGLMQuat(channel->mRotationKeys[i].mValue), (float)channel->mRotationKeys[i].mTime });
+            for (unsigned int i = 0; i < channel->mNumScalingKeys; ++i)
+                m_Scales.push_back({ AssimpGLMHelpers::GetGLMVec(channel->mScalingKeys[i].mValue), (float)channel->mScalingKeys[i].mTime });
+        }
+
+        void Update(float animationTime)
+        {
+            glm::mat4 translation = InterpolatePosition(animationTime);
+            glm::mat4 rotation = InterpolateRotation(animationTime);
+            glm::mat4 scale = InterpolateScaling(animationTime);
+            m_LocalTransform = translation * rotation * scale;
+        }
+        glm::mat4 GetLocalTransform() { return m_LocalTransform; }
+
+    private:
+        struct KeyVec3 { glm::vec3 value; float timeStamp; };
+        struct KeyQuat { glm::quat value; float timeStamp; };
+
+        template<typename Key>
+        static int GetIndex(const std::vector<Key>& keys, float animationTime)
+        {
+            for (int index = 0; index < (int)keys.size() - 1; ++index)
+            {
+                if (animationTime < keys[index + 1].timeStamp)
+                    return index;
+            }
+            return (int)keys.size() - 2;
+        }
+
+        static float GetScaleFactor(float lastTimeStamp, float nextTimeStamp, float animationTime)
+        {
+            return (animationTime - lastTimeStamp) / (nextTimeStamp - lastTimeStamp);
+        }
+
+        glm::mat4 InterpolatePosition(float animationTime)
+        {
+            int p0Index = GetIndex(m_Positions, animationTime);
+            float scaleFactor = GetScaleFactor(m_Positions[p0Index].timeStamp, m_Positions[p0Index + 1].timeStamp, animationTime);
+            return glm::translate(glm::mat4(1.0f), glm::mix(m_Positions[p0Index].value, m_Positions[p0Index + 1].value, scaleFactor));
+        }
+
+        glm::mat4 InterpolateRotation(float animationTime)
+        {
+            int p0Index = GetIndex(m_Rotations, animationTime);
+            float scaleFactor = GetScaleFactor(m_Rotations[p0Index].timeStamp, m_Rotations[p0Index + 1].timeStamp, animationTime);
+            glm::quat finalRotation = glm::slerp(m_Rotations[p0Index].value, m_Rotations[p0Index + 1].value, scaleFactor);
+            return glm::toMat4(glm::normalize(finalRotation));
+        }
+
+        glm::mat4 InterpolateScaling(float animationTime)
+        {
+            int p0Index = GetIndex(m_Scales, animationTime);
+            float scaleFactor = GetScaleFactor(m_Scales[p0Index].timeStamp, m_Scales[p0Index + 1].timeStamp, animationTime);
+            return glm::scale(glm::mat4(1.0f), glm::mix(m_Scales[p0Index].value, m_Scales[p0Index + 1].value, scaleFactor));
+        }
+
+        std::vector<KeyVec3> m_Positions;
+        std::vector<KeyQuat> m_Rotations;
+        std::vector<KeyVec3> m_Scales;
+        glm::mat4 m_LocalTransform = glm::mat4(1.0f);
+    };
+
+    // one channel with `keys` keys on every component; interior key times are jittered so the
+    // clip is not on a uniform grid (as with hand-keyed or reduced clips)
+    std::unique_ptr<aiNodeAnim> makeChannel(unsigned int keys, std::mt19937& generator)
+    {
+        std::uniform_real_distribution<float> jitter(-0.3f, 0.3f), angle(-0.5f, 0.5f);
+        std::unique_ptr<aiNodeAnim> channel(new aiNodeAnim());
+        channel->mNumPositionKeys = channel->mNumRotationKeys = channel->mNumScalingKeys = keys;
+        channel->mPositionKeys = new aiVectorKey[keys];
+        channel->mRotationKeys = new aiQuatKey[keys];
+        channel->mScalingKeys = new aiVectorKey[keys];
+        for (unsigned int k = 0; k < keys; k++)
+        {
+            double time = (k == 0 || k == keys - 1) ? k : k + jitter(generator);
+            channel->mPositionKeys[k].mTime = channel->mRotationKeys[k].mTime = channel->mScalingKeys[k].mTime = time;
+            channel->mPositionKeys[k].mValue = aiVector3D(angle(generator), 1.0f + angle(generator), angle(generator));
+            glm::vec3 axis = glm::normalize(glm::vec3(angle(generator), angle(generator), 1.0f));
+            float half = angle(generator);
+            channel->mRotationKeys[k].mValue = aiQuaternion(std::cos(half), axis.x * std::sin(half), axis.y * std::sin(half), axis.z * std::sin(half));
+            channel->mScalingKeys[k].mValue = aiVector3D(1.0f + 0.1f * angle(generator), 1.0f, 1.0f);
+        }
+        return channel;
+    }
+
+    double secondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // microseconds per call of pose(), run for at least minSeconds
+    template<typename Pose>
+    double microsecondsPerPose(double minSeconds, Pose pose)
+    {
+        std::size_t count = 0;
+        auto start = std::chrono::steady_clock::now();
+        while (secondsSince(start) < minSeconds)
+        {
+            for (int i = 0; i < 16; i++, count++)
+                pose();
+        }
+        return 1e6 * secondsSince(start) / count;
+    }
+}
+
+int main()
+{
+    const double MIN_SECONDS = 0.25;
+    const float TICKS_PER_FRAME = 0.5f; // 30 ticks/s clip played at 60 fps
+
+#ifdef BONE_USE_SSE
+    std::printf("compose: SSE, 4 bones per op\n");
+#else
+    std::printf("compose: scalar\n");
+#endif
+    std::printf("%-6s %-6s %12s %12s %12s %12s %12s\n", "bones", "keys", "legacy us", "cursor us", "uniform us", "seek us", "max error");
+    const int boneCounts[] = { 20, 65, 200 };
+    const unsigned int keyCounts[] = { 30, 300, 3000 };
+    float checksum = 0.0f;
+    for (int bones : boneCounts)
+    {
+        for (unsigned int keys : keyCounts)
+        {
+            std::mt19937 generator(bones * 7919u + keys);
+            std::vector<LegacyBone> legacyBones;
+            std::vector<Bone> cursorBones;
+            for (int b = 0; b < bones; b++)
+            {
+                std::unique_ptr<aiNodeAnim> channel = makeChannel(keys, generator);
+                legacyBones.emplace_back(channel.get());
+                cursorBones.emplace_back("bone" + std::to_string(b), b, channel.get());
+            }
+            std::vector<Bone> uniformBones = cursorBones;
+            for (Bone& bone : uniformBones)
+                bone.ResampleUniform(1.0f);
+
+            const float duration = (float)(keys - 1);
+            std::vector<BoneCursor> cursors(bones);
+            LocalPose pose;
+            pose.Resize(bones);
+            std::vector<glm::mat4> locals(bones);
+
+            // both samplers must agree before their speed means anything
+            float maxError = 0.0f;
+            float time = 0.0f;
+            for (int frame = 0; frame < 200; frame++, time = std::fmod(time + 3.7f, duration))
+            {
+                for (int b = 0; b < bones; b++)
+                    cursorBones[b].Sample(time, cursors[b], pose, b);
+                ComposeLocalTransforms(pose, bones, locals.data());
+                for (int b = 0; b < bones; b++)
+                {
+                    legacyBones[b].Update(time);
+                    glm::mat4 expected = legacyBones[b].GetLocalTransform();
+                    for (int column = 0; column < 4; column++)
+                        for (int row = 0; row < 4; row++)
+                            maxError = std::max(maxError, std::fabs(expected[column][row] - locals[b][column][row]));
+                }
+            }
+
+            time = 0.0f;
+            double legacyUs = microsecondsPerPose(MIN_SECONDS, [&]() {
+                time = std::fmod(time + TICKS_PER_FRAME, duration);
+                for (LegacyBone& bone : legacyBones)
+                {
+                    bone.Update(time);
+                    checksum += bone.GetLocalTransform()[3][1];
+                }
+            });
+            auto sampled = [&](std::vector<Bone>& channels) {
+                for (int b = 0; b < bones; b++)
+                    channels[b].Sample(time, cursors[b], pose, b);
+                ComposeLocalTransforms(pose, bones, locals.data());
+                checksum += locals[bones - 1][3][1];
+            };
+            double cursorUs = microsecondsPerPose(MIN_SECONDS, [&]() {
+                time = std::fmod(time + TICKS_PER_FRAME, duration);
+                sampled(cursorBones);
+            });
+            double uniformUs = microsecondsPerPose(MIN_SECONDS, [&]() {
+                time = std::fmod(time + TICKS_PER_FRAME, duration);
+                sampled(uniformBones);
+            });
+            std::uniform_real_distribution<float> anywhere(0.0f, duration);
+            double seekUs = microsecondsPerPose(MIN_SECONDS, [&]() {
+                time = anywhere(generator);
+                sampled(cursorBones);
+            });
+
+            std::printf("%-6d %-6u %12.2f %12.2f %12.2f %12.2f %12.2g\n", bones, keys, legacyUs, cursorUs, uniformUs, seekUs, maxError);
+        }
+    }
+    std::printf("(checksum %g)\n", checksum);
+    return 0;
+}
@@ -0,0 +1,127 @@
+// Triangle counts and CPU meshing cost of the chunked map geometry (src/map_mesher.h) against
+// the instanced cubes it replaces (12 triangles per floor tile and per block), plus how many
+// chunks the default camera keeps after frustum culling.
+//
+//     map_mesher_bench [map size]...
+//
+// Defaults to the 15x15 arena and a 512x512 map. Only CPU work: the chunks are meshed with
+// MapMesher::buildChunk, nothing is uploaded. Frame times of the same maps come from the game
+// itself: PlayableCharacter --headless --map-size <n>.
+#include "map_mesher.h"
+#include "tile_grid.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+    double millisecondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void benchMap(int size)
+    {
+        TileGrid grid(size, size);
+        grid.generateBreakableBlocks(1337, 0.6f);
+
+        MapLayout layout;
+        layout.originX = layout.originZ = -(size - 1) / 2.0f;
+        int chunksPerSide = (size + MapMesher::CHUNK_SIZE - 1) / MapMesher::CHUNK_SIZE;
+
+        // the instanced renderer draws a floor cube per cell and a cube per block
+        std::size_t blocks = 0;
+        for (int z = 0; z < size; z++)
+            for (int x = 0; x < size; x++)
+                blocks += grid.isSolid(x, z);
+        std::size_t cubeTriangles = (static_cast<std::size_t>(size) * size + blocks) * 12;
+
+        // full mesh; the median of a few runs
+        std::vector<MapMesher::ChunkGeometry> chunks(static_cast<std::size_t>(chunksPerSide) * chunksPerSide);
+        std::vector<double> times;
+        for (int run = 0; run < 5; run++)
+        {
+            auto start = std::chrono::steady_clock::now();
+            for (int cz = 0; cz < chunksPerSide; cz++)
+                for (int cx = 0; cx < chunksPerSide; cx++)
+                    MapMesher::buildChunk(grid, layout, cx, cz, chunks[static_cast<std::size_t>(cz) * chunksPerSide + cx]);
+            times.push_back(millisecondsSince(start));
+        }
+        std::sort(times.begin(), times.end());
+        double fullMs = times[times.size() / 2];
+
+        std::size_t triangles = 0, vertices = 0;
+        for (const MapMesher::ChunkGeometry& chunk : chunks)
+        {
+            triangles += chunk.indices.size() / 3;
+            vertices += chunk.vertices.size();
+        }
+
+        // destroy every breakable block of the first chunk row one at a time, remeshing only
+        // the chunk that holds it (and its neighbour across a chunk edge)
+        std::vector<std::pair<int, int>> targets;
+        for (const auto& position : grid.breakablePositions())
+        {
+            if (position.second < MapMesher::CHUNK_SIZE)
+                targets.push_back(position);
+        }
+        MapMesher::ChunkGeometry scratch;
+        std::size_t remeshes = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (const auto& target : targets)
+        {
+            grid.destroyBlock(target.first, target.second);
+            int cx = target.first / MapMesher::CHUNK_SIZE, cz = target.second / MapMesher::CHUNK_SIZE;
+            MapMesher::buildChunk(grid, layout, cx, cz, scratch);
+            remeshes++;
+            int edgeX = target.first % MapMesher::CHUNK_SIZE;
+            if ((edgeX == 0 && cx > 0) || (edgeX == MapMesher::CHUNK_SIZE - 1 && cx + 1 < chunksPerSide))
+            {
+                MapMesher::buildChunk(grid, layout, edgeX == 0 ? cx - 1 : cx + 1, cz, scratch);
+                remeshes++;
+            }
+        }
+        double destroyMs = targets.empty() ? 0.0 : millisecondsSince(start) / targets.size();
+
+        // the game's camera: a 15x15 window of the map centre
+        float viewSize = static_cast<float>(std::min(size, 15));
+        glm::vec3 cameraPos(0.0f, viewSize * 1.2f, viewSize * 1.1f);
+        Frustum frustum(glm::perspective(glm::radians(45.0f), 800.0f / 600.0f, 0.1f, 200.0f)
+            * glm::lookAt(cameraPos, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f)));
+        std::size_t visibleChunks = 0, visibleTriangles = 0;
+        start = std::chrono::steady_clock::now();
+        for (const MapMesher::ChunkGeometry& chunk : chunks)
+        {
+            if (frustum.intersects(chunk.boundsMin, chunk.boundsMax))
+            {
+                visibleChunks++;
+                visibleTriangles += chunk.indices.size() / 3;
+            }
+        }
+        double cullMs = millisecondsSince(start);
+
+        std::printf("%dx%d map, %zu blocks, %zu chunks\n", size, size, blocks, chunks.size());
+        std::printf("  instanced cubes   %9zu triangles\n", cubeTriangles);
+        std::printf("  meshed chunks     %9zu triangles (%.1f%%), %zu vertices, %.3f ms to mesh all\n", triangles,
+            100.0 * triangles / cubeTriangles, vertices, fullMs);
+        std::printf("  after culling     %9zu triangles in %zu chunks (%.3f ms to cull)\n", visibleTriangles, visibleChunks, cullMs);
+        std::printf("  destroyed block   %.3f ms to remesh (%zu blocks, %zu chunk meshes)\n", destroyMs, targets.size(), remeshes);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::vector<int> sizes;
+    for (int i = 1; i < argc; i++)
+        sizes.push_back(std::max(5, std::atoi(argv[i])));
+    if (sizes.empty())
+        sizes = { 15, 512 };
+    for (int size : sizes)
+        benchMap(size);
+    return 0;
+}
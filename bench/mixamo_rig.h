@@ -0,0 +1,143 @@
+#ifndef MIXAMO_RIG_H
+#define MIXAMO_RIG_H
+
+// Synthetic stand-in for a Mixamo character used by the animation benchmarks: the 65 bone
+// "mixamorig:" hierarchy under the usual non-bone RootNode/Armature nodes, with one clip
+// that keys translation, rotation and scale of every bone on every frame (as Mixamo FBX
+// exports do). Built in memory so the benchmarks need no asset files.
+#include <assimp/scene.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <learnopengl/animdata.h>
+
+#include <cmath>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+struct MixamoRig
+{
+    std::unique_ptr<aiNode> root;
+    std::unique_ptr<aiAnimation> clip;
+    std::map<std::string, BoneInfo> boneInfoMap;
+    int boneCount = 0;
+};
+
+namespace MixamoRigDetail
+{
+    inline aiNode* addNode(aiNode* parent, const std::string& name, const glm::vec3& offset)
+    {
+        aiNode* node = new aiNode();
+        node->mName.Set(name);
+        node->mTransformation.a4 = offset.x;
+        node->mTransformation.b4 = offset.y;
+        node->mTransformation.c4 = offset.z;
+        node->mParent = parent;
+        if (parent)
+        {
+            aiNode** children = new aiNode*[parent->mNumChildren + 1];
+            for (unsigned int i = 0; i < parent->mNumChildren; i++)
+                children[i] = parent->mChildren[i];
+            children[parent->mNumChildren] = node;
+            delete[] parent->mChildren;
+            parent->mChildren = children;
+            parent->mNumChildren++;
+        }
+        return node;
+    }
+
+    inline aiNode* addChain(aiNode* parent, const std::string& prefix, const std::vector<std::string>& names,
+        const glm::vec3& step, std::vector<aiNode*>& bones)
+    {
+        for (const std::string& name : names)
+        {
+            parent = addNode(parent, prefix + name, step);
+            bones.push_back(parent);
+        }
+        return parent;
+    }
+}
+
+// keyframes per channel at 30 ticks per second
+inline MixamoRig buildMixamoRig(unsigned int keyframes = 60, unsigned int seed = 7)
+{
+    using namespace MixamoRigDetail;
+    const std::string prefix = "mixamorig:";
+
+    MixamoRig rig;
+    rig.root.reset(new aiNode());
+    rig.root->mName.Set("RootNode");
+    aiNode* armature = addNode(rig.root.get(), "Armature", glm::vec3(0.0f));
+
+    std::vector<aiNode*> bones;
+    aiNode* hips = addChain(armature, prefix, { "Hips" }, glm::vec3(0.0f, 1.0f, 0.0f), bones);
+    aiNode* spine = addChain(hips, prefix, { "Spine", "Spine1", "Spine2" }, glm::vec3(0.0f, 0.1f, 0.0f), bones);
+    addChain(spine, prefix, { "Neck", "Head", "HeadTop_End" }, glm::vec3(0.0f, 0.1f, 0.0f), bones);
+    const char* sides[] = { "Left", "Right" };
+    for (int s = 0; s < 2; s++)
+    {
+        std::string side = sides[s];
+        float sign = s == 0 ? 1.0f : -1.0f;
+        aiNode* hand = addChain(spine, prefix, { side + "Shoulder", side + "Arm", side + "ForeArm", side + "Hand" },
+            glm::vec3(sign * 0.15f, 0.0f, 0.0f), bones);
+        const char* fingers[] = { "Thumb", "Index", "Middle", "Ring", "Pinky" };
+        for (const char* finger : fingers)
+        {
+            std::string name = side + "Hand" + finger;
+            addChain(hand, prefix, { name + "1", name + "2", name + "3", name + "4" }, glm::vec3(sign * 0.02f, 0.0f, 0.0f), bones);
+        }
+        addChain(hips, prefix, { side + "UpLeg", side + "Leg", side + "Foot", side + "ToeBase", side + "Toe_End" },
+            glm::vec3(sign * 0.1f, -0.2f, 0.0f), bones);
+    }
+
+    // bind pose offsets: inverse of the accumulated bind translation
+    for (aiNode* bone : bones)
+    {
+        glm::vec3 bindPosition(0.0f);
+        for (const aiNode* node = bone; node; node = node->mParent)
+            bindPosition += glm::vec3(node->mTransformation.a4, node->mTransformation.b4, node->mTransformation.c4);
+        BoneInfo info;
+        info.id = rig.boneCount++;
+        info.offset = glm::translate(glm::mat4(1.0f), -bindPosition);
+        rig.boneInfoMap[bone->mName.data] = info;
+    }
+
+    // one looping clip, every bone keyed on every frame
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<float> angle(-0.4f, 0.4f);
+    rig.clip.reset(new aiAnimation());
+    rig.clip->mTicksPerSecond = 30.0;
+    rig.clip->mDuration = keyframes - 1;
+    rig.clip->mNumChannels = static_cast<unsigned int>(bones.size());
+    rig.clip->mChannels = new aiNodeAnim*[bones.size()];
+    for (std::size_t b = 0; b < bones.size(); b++)
+    {
+        aiNodeAnim* channel = new aiNodeAnim();
+        channel->mNodeName = bones[b]->mName;
+        channel->mNumPositionKeys = channel->mNumRotationKeys = channel->mNumScalingKeys = keyframes;
+        channel->mPositionKeys = new aiVectorKey[keyframes];
+        channel->mRotationKeys = new aiQuatKey[keyframes];
+        channel->mScalingKeys = new aiVectorKey[keyframes];
+        float phase = angle(generator);
+        for (unsigned int k = 0; k < keyframes; k++)
+        {
+            double time = k;
+            const aiMatrix4x4& bind = bones[b]->mTransformation;
+            channel->mPositionKeys[k].mTime = time;
+            channel->mPositionKeys[k].mValue = aiVector3D(bind.a4, bind.b4 + 0.01f * std::sin(phase + k * 0.2f), bind.c4);
+            // rotation about a random axis, as a normalised quaternion
+            glm::vec3 axis = glm::normalize(glm::vec3(angle(generator), angle(generator), angle(generator)) + glm::vec3(0.0f, 0.0f, 0.01f));
+            float half = 0.5f * angle(generator);
+            channel->mRotationKeys[k].mTime = time;
+            channel->mRotationKeys[k].mValue = aiQuaternion(std::cos(half), axis.x * std::sin(half), axis.y * std::sin(half), axis.z * std::sin(half));
+            channel->mScalingKeys[k].mTime = time;
+            channel->mScalingKeys[k].mValue = aiVector3D(1.0f, 1.0f, 1.0f);
+        }
+        rig.clip->mChannels[b] = channel;
+    }
+    return rig;
+}
+
+#endif
@@ -0,0 +1,257 @@
+// CPU load time of models and clips through Assimp against their baked .bmdl containers
+// (src/model_cache.h): everything Model and Animation do before the GL upload, which both paths
+// share.
+//
+//     model_load_bench [model file]...
+//
+// A file without an up-to-date .bmdl is baked first, like tools/model_baker would. Without
+// arguments a synthetic Mixamo-sized character (bench/synthetic_character.h) is baked to a
+// temporary directory; there is no source file to import then, so the Assimp side only
+// covers the conversion from an in-memory aiScene, not the parsing.
+#include "synthetic_character.h"
+
+#include <learnopengl/bone.h>
+
+#include <assimp/Importer.hpp>
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace
+{
+    const int RUNS = 10;
+
+    // median wall time of fn in milliseconds
+    double timeMs(const std::function<void()>& fn)
+    {
+        std::vector<double> times;
+        for (int run = 0; run < RUNS; run++)
+        {
+            auto start = std::chrono::steady_clock::now();
+            fn();
+            times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+        std::sort(times.begin(), times.end());
+        return times[times.size() / 2];
+    }
+
+    template<typename T>
+    KeyTrack<T> toTrack(const ModelCache::KeysView<T>& keys)
+    {
+        KeyTrack<T> track;
+        track.times.assign(keys.times, keys.times + keys.count);
+        track.values.assign(keys.values, keys.values + keys.count);
+        return track;
+    }
+
+    // the CPU-side objects Model and Animation build from a scene: vertex and index vectors
+    // for Mesh, the bone map and one Bone per channel; returns a checksum so nothing is elided
+    std::size_t materialise(const ModelCache::SceneView& scene)
+    {
+        std::size_t checksum = 0;
+        for (const ModelCache::MeshView& mesh : scene.meshes)
+        {
+            std::vector<Vertex> vertices(mesh.vertices, mesh.vertices + mesh.vertexCount);
+            std::vector<unsigned int> indices(mesh.indices, mesh.indices + mesh.indexCount);
+            checksum += vertices.size() + indices.size() + mesh.textures.size();
+        }
+        std::map<std::string, BoneInfo> boneInfoMap;
+        for (const ModelCache::BoneView& bone : scene.bones)
+            boneInfoMap[bone.name] = bone.info;
+        std::vector<Bone> bones;
+        for (const ModelCache::ChannelView& channel : scene.channels)
+        {
+            auto found = boneInfoMap.find(channel.name);
+            int id = found != boneInfoMap.end() ? found->second.id : -1;
+            bones.push_back(Bone(channel.name, id, toTrack(channel.positions), toTrack(channel.rotations), toTrack(channel.scales)));
+        }
+        return checksum + boneInfoMap.size() + bones.size() + scene.nodes.size();
+    }
+
+    // the baked view reproduces what the import produced
+    bool identical(const ModelCache::SceneView& a, const ModelCache::SceneView& b)
+    {
+        if (a.meshes.size() != b.meshes.size() || a.bones.size() != b.bones.size() || a.boneCount != b.boneCount
+            || a.nodes.size() != b.nodes.size() || a.channels.size() != b.channels.size() || a.hasAnimation != b.hasAnimation
+            || a.duration != b.duration || a.ticksPerSecond != b.ticksPerSecond)
+            return false;
+        for (std::size_t m = 0; m < a.meshes.size(); m++)
+        {
+            const ModelCache::MeshView& x = a.meshes[m];
+            const ModelCache::MeshView& y = b.meshes[m];
+            if (x.vertexCount != y.vertexCount || x.indexCount != y.indexCount || x.skinned != y.skinned
+                || x.textures.size() != y.textures.size()
+                || std::memcmp(x.vertices, y.vertices, x.vertexCount * sizeof(Vertex)) != 0
+                || std::memcmp(x.indices, y.indices, x.indexCount * sizeof(unsigned int)) != 0)
+                return false;
+            for (std::size_t t = 0; t < x.textures.size(); t++)
+            {
+                if (std::strcmp(x.textures[t].type, y.textures[t].type) != 0 || std::strcmp(x.textures[t].path, y.textures[t].path) != 0)
+                    return false;
+            }
+        }
+        for (std::size_t i = 0; i < a.bones.size(); i++)
+        {
+            if (std::strcmp(a.bones[i].name, b.bones[i].name) != 0 || a.bones[i].info.id != b.bones[i].info.id
+                || a.bones[i].info.offset != b.bones[i].info.offset)
+                return false;
+        }
+        for (std::size_t i = 0; i < a.nodes.size(); i++)
+        {
+            if (std::strcmp(a.nodes[i].name, b.nodes[i].name) != 0 || a.nodes[i].parent != b.nodes[i].parent
+                || a.nodes[i].childCount != b.nodes[i].childCount || a.nodes[i].transformation != b.nodes[i].transformation)
+                return false;
+        }
+        for (std::size_t i = 0; i < a.channels.size(); i++)
+        {
+            const ModelCache::ChannelView& x = a.channels[i];
+            const ModelCache::ChannelView& y = b.channels[i];
+            if (std::strcmp(x.name, y.name) != 0 || x.positions.count != y.positions.count || x.rotations.count != y.rotations.count
+                || x.scales.count != y.scales.count
+                || std::memcmp(x.positions.times, y.positions.times, x.positions.count * sizeof(float)) != 0
+                || std::memcmp(x.positions.values, y.positions.values, x.positions.count * sizeof(glm::vec3)) != 0
+                || std::memcmp(x.rotations.times, y.rotations.times, x.rotations.count * sizeof(float)) != 0
+                || std::memcmp(x.rotations.values, y.rotations.values, x.rotations.count * sizeof(glm::quat)) != 0
+                || std::memcmp(x.scales.times, y.scales.times, x.scales.count * sizeof(float)) != 0
+                || std::memcmp(x.scales.values, y.scales.values, x.scales.count * sizeof(glm::vec3)) != 0)
+                return false;
+        }
+        return true;
+    }
+
+    double bakedLoadMs(const std::string& sourcePath, std::size_t& checksum)
+    {
+        return timeMs([&]() {
+            ModelCache::BakedModel baked;
+            if (ModelCache::openBaked(sourcePath, baked))
+                checksum += materialise(baked.view());
+        });
+    }
+
+    void report(const char* name, double importMs, double bakedMs, const ModelCache::SceneData& data, bool same)
+    {
+        std::size_t vertices = 0;
+        for (const ModelCache::MeshData& mesh : data.meshes)
+            vertices += mesh.vertices.size();
+        std::printf("%-40s %8zu verts %4zu channels  assimp %9.3f ms  baked %8.3f ms  %6.1fx  %s\n", name, vertices,
+            data.channels.size(), importMs, bakedMs, bakedMs > 0.0 ? importMs / bakedMs : 0.0, same ? "identical" : "MISMATCH");
+    }
+
+    bool benchFile(const std::string& path)
+    {
+        std::size_t checksum = 0;
+        ModelCache::SceneData data;
+        bool imported = false;
+        // Model's import, then Animation's (a clip file is imported once more, without meshes)
+        double modelMs = timeMs([&]() {
+            Assimp::Importer importer;
+            const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_CalcTangentSpace);
+            imported = scene && !(scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE) && scene->mRootNode;
+            if (imported)
+                ModelCache::extractScene(scene, data);
+            checksum += materialise(data.view());
+        });
+        if (!imported)
+        {
+            std::printf("%s: import failed\n", path.c_str());
+            return false;
+        }
+        double clipMs = 0.0;
+        if (data.hasAnimation)
+        {
+            clipMs = timeMs([&]() {
+                Assimp::Importer importer;
+                ModelCache::SceneData clip;
+                const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate);
+                if (scene && scene->mRootNode)
+                    ModelCache::extractScene(scene, clip, false);
+                checksum += materialise(clip.view());
+            });
+        }
+
+        ModelCache::BakedModel existing;
+        if (!ModelCache::openBaked(path, existing))
+        {
+            uint64_t sourceSize, sourceHash;
+            if (!TextureCache::hashFile(path, sourceSize, sourceHash)
+                || !ModelCache::writeBaked(ModelCache::bakedPath(path), data.view(), sourceSize, sourceHash)
+                || !ModelCache::openBaked(path, existing))
+            {
+                std::printf("%s: bake failed\n", path.c_str());
+                return false;
+            }
+            std::printf("baked %s\n", ModelCache::bakedPath(path).c_str());
+        }
+        bool same = identical(data.view(), existing.view());
+        double bakedMs = bakedLoadMs(path, checksum);
+        report(path.c_str(), modelMs + clipMs, bakedMs, data, same);
+        std::printf("  (assimp: model %.3f ms + clip %.3f ms; checksum %zu)\n", modelMs, clipMs, checksum);
+        return same;
+    }
+
+    bool benchSynthetic()
+    {
+        MixamoRig rig = buildMixamoRig();
+        aiScene scene;
+        scene.mRootNode = rig.root.release();
+        scene.mNumAnimations = 1;
+        scene.mAnimations = new aiAnimation*[1];
+        scene.mAnimations[0] = rig.clip.release();
+
+        std::size_t checksum = 0;
+        ModelCache::SceneData data;
+        double convertMs = timeMs([&]() {
+            ModelCache::extractScene(&scene, data, false);
+            checksum += materialise(data.view());
+        });
+        data.meshes.push_back(makeCharacterMesh(120, 160, rig.boneCount, { { "texture_diffuse", "Ch32_1001_Diffuse.png" },
+            { "texture_normal", "Ch32_1001_Normal.png" }, { "texture_specular", "Ch32_1001_Specular.png" } }));
+        data.boneInfoMap = rig.boneInfoMap;
+        data.boneCount = rig.boneCount;
+
+        std::filesystem::path directory = std::filesystem::temp_directory_path() / "palbom_model_load_bench";
+        std::filesystem::create_directories(directory);
+        std::string source = (directory / "synthetic_character.fbx").string();
+        const std::size_t SOURCE_BYTES = 256 * 1024;
+        ModelCache::BakedModel baked;
+        if (!writeSyntheticCharacter(source, data, SOURCE_BYTES) || !ModelCache::openBaked(source, baked))
+        {
+            std::printf("synthetic bake failed\n");
+            return false;
+        }
+        uint64_t sourceSize, sourceHash;
+        bool same = identical(data.view(), baked.view());
+        double bakedMs = bakedLoadMs(source, checksum);
+        double hashMs = timeMs([&]() { TextureCache::hashFile(source, sourceSize, sourceHash); });
+        std::size_t vertices = data.meshes[0].vertices.size();
+        std::printf("synthetic character: %zu verts, %zu channels, %.1f KiB container, %s\n", vertices, data.channels.size(),
+            baked.file.size() / 1024.0, same ? "identical" : "MISMATCH");
+        std::printf("  baked load %.3f ms (of which %.3f ms hashing the %zu KiB stand-in source)\n", bakedMs, hashMs, SOURCE_BYTES / 1024);
+        std::printf("  aiScene -> SceneData for the clip alone, without parsing: %.3f ms\n", convertMs);
+        std::printf("  pass model files to compare against a real Assimp import (checksum %zu)\n", checksum);
+
+        std::error_code error;
+        std::filesystem::remove_all(directory, error);
+        return same;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::printf("median of %d loads, CPU work before the GL upload\n", RUNS);
+    bool ok = true;
+    if (argc < 2)
+        ok = benchSynthetic();
+    for (int i = 1; i < argc; i++)
+        ok = benchFile(argv[i]) && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,146 @@
+// Cost of the profiler instrumentation (src/profiler.h) per zone and per counter update, on
+// 1 and 4 threads at once, with the profiler built in but not capturing and while capturing.
+// Renders nothing and needs no GL context (the GPU zones are not measured).
+//
+//     profiler_bench [zones per thread]
+//
+// Every zone encloses a tiny loop so the compiler cannot drop it; the "bare" line runs the same
+// loop without instrumentation (its wall time per iteration) and is subtracted from the others.
+// With more threads than cores the figures grow with the threads sharing a core. A capturing
+// zone is dominated by its two steady_clock reads, so it costs a few clock reads wherever those
+// are slow (virtual machines without a vDSO clock). The capturing lines include publishing the
+// thread buffers; the export line times writeChromeTrace for the zones of a 4 thread run.
+#include "profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <thread>
+#include <vector>
+
+#if PALBOM_PROFILER
+
+namespace
+{
+    volatile unsigned int sink = 0;
+
+    void work(int i)
+    {
+        unsigned int value = static_cast<unsigned int>(i);
+        for (int k = 0; k < 8; k++)
+            value = value * 1664525u + 1013904223u;
+        sink = value;
+    }
+
+    enum Mode
+    {
+        BARE = 0,
+        ZONE,
+        NESTED_ZONES,
+        COUNTER
+    };
+
+    void run(Mode mode, int zones)
+    {
+        for (int i = 0; i < zones; i++)
+        {
+            if (mode == BARE)
+            {
+                work(i);
+            }
+            else if (mode == ZONE)
+            {
+                PROFILE_ZONE("zone");
+                work(i);
+            }
+            else if (mode == NESTED_ZONES)
+            {
+                // counted as one zone: half the iterations, two zones each
+                if (i % 2 == 1)
+                    continue;
+                PROFILE_ZONE("outer");
+                work(i);
+                PROFILE_ZONE("inner");
+                work(i + 1);
+            }
+            else
+            {
+                PROFILE_COUNT("bench counter", 1);
+                work(i);
+            }
+        }
+    }
+
+    // nanoseconds per iteration with the given number of threads running at once
+    double measure(Mode mode, int zones, int threads)
+    {
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; t++)
+            workers.emplace_back(run, mode, zones);
+        for (std::thread& worker : workers)
+            worker.join();
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        return ns / zones;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    int zones = argc > 1 ? std::max(1000, std::atoi(argv[1])) : 200000;
+    Profiler& profiler = Profiler::instance();
+    const int threadCounts[] = { 1, 4 };
+    const char* modeNames[] = { "bare loop", "zone", "nested zones", "counter" };
+
+    std::printf("%d iterations per thread, ns per iteration above the bare loop\n", zones);
+    std::printf("%-14s %-8s %14s %14s\n", "", "threads", "not capturing", "capturing");
+    for (int threads : threadCounts)
+    {
+        measure(BARE, zones, threads); // warm-up
+        double bare = measure(BARE, zones, threads);
+        std::printf("%-14s %-8d %14.2f %14s\n", modeNames[BARE], threads, bare, "(ns total)");
+        for (int mode = ZONE; mode <= COUNTER; mode++)
+        {
+            profiler.setCapturing(false);
+            double idle = measure(static_cast<Mode>(mode), zones, threads) - bare;
+            profiler.clear();
+            profiler.setCapturing(true);
+            double capturing = measure(static_cast<Mode>(mode), zones, threads) - bare;
+            profiler.setCapturing(false);
+            std::printf("%-14s %-8d %14.2f %14.2f\n", modeNames[mode], threads, idle, capturing);
+        }
+        profiler.endFrame();
+    }
+
+    // export the zones of one more capturing run on 4 threads
+    profiler.clear();
+    profiler.setCapturing(true);
+    measure(ZONE, zones, 4);
+    profiler.setCapturing(false);
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "palbom_profiler_bench.json";
+    auto start = std::chrono::steady_clock::now();
+    bool written = profiler.writeChromeTrace(path.string());
+    double exportMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::uintmax_t bytes = written ? std::filesystem::file_size(path) : 0;
+    std::error_code error;
+    std::filesystem::remove(path, error);
+    if (!written)
+    {
+        std::printf("Failed to write %s\n", path.string().c_str());
+        return 1;
+    }
+    std::printf("export of %d zones: %.1f ms, %.1f MiB of trace JSON\n", 4 * zones, exportMs, bytes / (1024.0 * 1024.0));
+    return 0;
+}
+
+#else
+
+int main()
+{
+    std::printf("profiler_bench needs a build with PALBOM_PROFILER=ON\n");
+    return 0;
+}
+
+#endif
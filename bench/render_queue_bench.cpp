@@ -0,0 +1,192 @@
+// CPU cost and GL state calls of drawing many small textured models the immediate way
+// (Model::Draw, which binds every texture, sampler and VAO of every mesh) against submitting
+// them to a RenderQueue that sorts the frame and skips repeated state (src/render_queue.h).
+//
+//     render_queue_bench [models] [frames]
+//
+// Three synthetic prop kinds of two meshes each, textured with pairs of the 1k map textures
+// and shared through a ResourceManager, are drawn round robin into a 64x64 hidden window, so
+// the measurement is dominated by the draw submission, not the rasterisation.
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <glm/gtc/matrix_inverse.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <learnopengl/filesystem.h>
+#include <learnopengl/model_animation.h>
+
+#include "frame_uniforms.h"
+#include "gl_context.h"
+#include "render_queue.h"
+#include "resource_manager.h"
+#include "synthetic_character.h"
+#include "texture_loader.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+    const int PROP_KINDS = 3;
+
+    // write the prop kinds with copies of the map textures next to them; returns their paths
+    std::vector<std::string> prepareProps(const std::filesystem::path& directory)
+    {
+        std::filesystem::create_directories(directory);
+        const char* sources[] = { "assets/Floor/concrete_wall_07_basecolor_1k.png", "assets/Unbreakable_Block/tudor_wall_01_basecolor_1k.png",
+            "assets/Breakable_Block/wood_05_baseColor_1k.png" };
+        const char* names[] = { "concrete.png", "tudor.png", "wood.png" };
+        std::error_code error;
+        for (int i = 0; i < 3; i++)
+            std::filesystem::copy_file(FileSystem::getPath(sources[i]), directory / names[i], std::filesystem::copy_options::overwrite_existing, error);
+
+        std::vector<std::string> paths;
+        for (int kind = 0; kind < PROP_KINDS; kind++)
+        {
+            // a body and a trim mesh; the kinds share textures in different combinations
+            ModelCache::SceneData data;
+            for (int part = 0; part < 2; part++)
+            {
+                ModelCache::MeshData mesh = makeCharacterMesh(6 + kind, 12, 2,
+                    { { "texture_diffuse", names[(kind + part) % 3] }, { "texture_normal", names[(kind + part + 1) % 3] } });
+                mesh.skinned = false;
+                data.meshes.push_back(mesh);
+            }
+            std::string path = (directory / ("prop" + std::to_string(kind) + ".fbx")).generic_string();
+            if (!writeSyntheticCharacter(path, data, 4096))
+                return {};
+            paths.push_back(path);
+        }
+        return paths;
+    }
+
+    // median CPU milliseconds of frame(), which must leave its draws submitted to GL
+    double medianFrameMs(int frames, const std::function<void()>& frame)
+    {
+        std::vector<double> times;
+        for (int i = 0; i < frames; i++)
+        {
+            glFinish();
+            auto start = std::chrono::steady_clock::now();
+            frame();
+            times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+        glFinish();
+        std::sort(times.begin(), times.end());
+        return times[times.size() / 2];
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    int models = argc > 1 ? std::max(1, std::atoi(argv[1])) : 300;
+    int frames = argc > 2 ? std::max(1, std::atoi(argv[2])) : 50;
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "palbom_render_queue_bench";
+
+    GLFWwindow* window = createHiddenContext("render_queue_bench");
+    if (window == NULL)
+        return -1;
+    glEnable(GL_DEPTH_TEST);
+
+    std::vector<std::string> paths = prepareProps(directory);
+    if (paths.empty())
+    {
+        std::printf("failed to write the synthetic props\n");
+        return -1;
+    }
+
+    TextureLoader textureLoader;
+    ResourceManager resources(textureLoader);
+    Shader& shader = resources.shader(resources.acquireShader(FileSystem::getPath("shaders/model.vs").c_str(),
+        FileSystem::getPath("shaders/model.fs").c_str()));
+    shader.bindUniformBlock(FrameUniforms::BLOCK_NAME, FrameUniforms::BINDING_POINT);
+    UniformHandle modelUniform = shader.uniform("model");
+    UniformHandle normalMatrixUniform = shader.uniform("normalMatrix");
+    FrameUniforms frameUniforms;
+    frameUniforms.setCamera(glm::perspective(glm::radians(45.0f), 1.0f, 1.0f, 1000.0f),
+        glm::lookAt(glm::vec3(0.0f, 200.0f, 400.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f)), glm::vec3(0.0f, 200.0f, 400.0f));
+    frameUniforms.upload();
+
+    std::vector<std::unique_ptr<Model>> kinds;
+    for (const std::string& path : paths)
+        kinds.emplace_back(new Model(path, false, nullptr, true, &resources));
+    textureLoader.finish();
+
+    // props on a grid, kinds interleaved in submission order
+    std::vector<glm::mat4> transforms;
+    std::vector<glm::mat3> normalMatrices;
+    for (int i = 0; i < models; i++)
+    {
+        transforms.push_back(glm::translate(glm::mat4(1.0f), glm::vec3((i % 20 - 10) * 30.0f, 0.0f, (i / 20) * -30.0f)));
+        normalMatrices.push_back(glm::inverseTranspose(glm::mat3(transforms.back())));
+    }
+    std::size_t meshesPerFrame = 0;
+    for (int i = 0; i < models; i++)
+        meshesPerFrame += kinds[i % PROP_KINDS]->meshes.size();
+    std::printf("%d models (%zu meshes) per frame, median of %d frames\n", models, meshesPerFrame, frames);
+
+    // immediate: every mesh binds its own textures, samplers and VAO
+    double immediateMs = medianFrameMs(frames, [&]() {
+        shader.use();
+        for (int i = 0; i < models; i++)
+        {
+            shader.setMat4(modelUniform, transforms[i]);
+            shader.setMat3(normalMatrixUniform, normalMatrices[i]);
+            kinds[i % PROP_KINDS]->Draw(shader);
+        }
+    });
+    // per mesh: glActiveTexture + glUniform1i + glBindTexture per texture, the VAO bind and
+    // the final glActiveTexture; plus the one program bind (the model and normal matrices and
+    // the useNormalMap flag are not state calls on either side)
+    std::size_t immediateCalls = 1;
+    for (int i = 0; i < models; i++)
+    {
+        for (const Mesh& mesh : kinds[i % PROP_KINDS]->meshes)
+            immediateCalls += 3 * mesh.textures.size() + 2;
+    }
+
+    // queued: submitted in the same order, sorted, and executed through the state cache
+    RenderQueue queue;
+    GLStateCache stateCache;
+    double queuedMs = medianFrameMs(frames, [&]() {
+        stateCache.invalidate();
+        RenderCommand command;
+        command.modelLocation = modelUniform.location;
+        command.normalMatrixLocation = normalMatrixUniform.location;
+        for (int i = 0; i < models; i++)
+        {
+            command.model = transforms[i];
+            command.normalMatrix = normalMatrices[i];
+            kinds[i % PROP_KINDS]->Submit(queue, shader, command);
+        }
+        queue.execute(stateCache);
+    });
+    const RenderStats& stats = queue.stats();
+
+    std::printf("immediate: %8.3f ms/frame, ~%zu state calls\n", immediateMs, immediateCalls);
+    std::printf("queued:    %8.3f ms/frame, %u submitted, %u draw calls, %u state calls issued, %u elided\n", queuedMs,
+        stats.submitted, stats.drawCalls, stats.stateChanges(), stats.elidedStateChanges());
+    for (unsigned int i = 0; i < RenderStats::STATE_COUNT; i++)
+    {
+        std::printf("  %-13s %6u issued %6u elided\n", RenderStats::stateName(static_cast<RenderState>(i)), stats.changes[i],
+            stats.elided[i]);
+    }
+
+    for (auto& kind : kinds)
+        kind->release();
+    frameUniforms.release();
+    resources.release();
+    textureLoader.release();
+    std::error_code error;
+    std::filesystem::remove_all(directory, error);
+    glfwTerminate();
+    return 0;
+}
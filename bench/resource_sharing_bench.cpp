@@ -0,0 +1,146 @@
+// GPU memory and load time of many characters loaded from the same file, each with its own
+// textures and vertex buffers (as before the ResourceManager) against all of them sharing one
+// set through a ResourceManager, plus the deferred destruction once they are released.
+//
+//     resource_sharing_bench [characters] [model file]
+//
+// Defaults to 64 characters of a synthetic baked character (bench/synthetic_character.h)
+// textured with three of the 1k map textures. Renders nothing; the hidden window only
+// provides the GL context.
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <learnopengl/filesystem.h>
+#include <learnopengl/model_animation.h>
+
+#include "gl_context.h"
+#include "resource_manager.h"
+#include "synthetic_character.h"
+#include "texture_loader.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+    double millisecondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    double mebibytes(std::size_t bytes)
+    {
+        return bytes / (1024.0 * 1024.0);
+    }
+
+    // write the synthetic character with copies of the map textures next to it; returns its path
+    std::string prepareSynthetic(const std::filesystem::path& directory)
+    {
+        std::filesystem::create_directories(directory);
+        const char* sources[] = { "assets/Floor/concrete_wall_07_basecolor_1k.png", "assets/Unbreakable_Block/tudor_wall_01_basecolor_1k.png",
+            "assets/Breakable_Block/wood_05_baseColor_1k.png" };
+        const char* names[] = { "body_diffuse.png", "body_normal.png", "body_specular.png" };
+        std::error_code error;
+        for (int i = 0; i < 3; i++)
+            std::filesystem::copy_file(FileSystem::getPath(sources[i]), directory / names[i], std::filesystem::copy_options::overwrite_existing, error);
+
+        ModelCache::SceneData data = buildSyntheticCharacter(true,
+            { { "texture_diffuse", names[0] }, { "texture_normal", names[1] }, { "texture_specular", names[2] } });
+        std::string path = (directory / "synthetic_character.fbx").generic_string();
+        return writeSyntheticCharacter(path, data) ? path : std::string();
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    int characters = argc > 1 ? std::atoi(argv[1]) : 64;
+    std::filesystem::path syntheticDirectory = std::filesystem::temp_directory_path() / "palbom_resource_sharing_bench";
+
+    GLFWwindow* window = createHiddenContext("resource_sharing_bench");
+    if (window == NULL)
+        return -1;
+
+    std::string path = argc > 2 ? argv[2] : prepareSynthetic(syntheticDirectory);
+    if (path.empty())
+    {
+        std::printf("failed to write the synthetic character\n");
+        return -1;
+    }
+    TextureLoader textureLoader;
+    std::printf("%d characters of %s\n", characters, path.c_str());
+
+    // one manager per character: nothing is shared, as with plain Model instances
+    {
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::unique_ptr<ResourceManager>> managers;
+        std::vector<std::unique_ptr<Model>> models;
+        for (int i = 0; i < characters; i++)
+        {
+            managers.emplace_back(new ResourceManager(textureLoader));
+            models.emplace_back(new Model(path, false, nullptr, false, managers.back().get()));
+        }
+        textureLoader.finish();
+        glFinish();
+        double loadMs = millisecondsSince(start);
+
+        ResourceReport total;
+        for (const auto& manager : managers)
+        {
+            ResourceReport report = manager->report();
+            total.textures.count += report.textures.count;
+            total.textures.bytes += report.textures.bytes;
+            total.meshes.count += report.meshes.count;
+            total.meshes.bytes += report.meshes.bytes;
+        }
+        std::printf("unshared: %7.1f ms load, %3zu textures %8.2f MiB, %3zu meshes %8.2f MiB, total %8.2f MiB\n", loadMs,
+            total.textures.count, mebibytes(total.textures.bytes), total.meshes.count, mebibytes(total.meshes.bytes),
+            mebibytes(total.totalBytes()));
+        for (const auto& manager : managers)
+            manager->release();
+    }
+
+    // one manager for everyone
+    {
+        ResourceManager resources(textureLoader);
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::unique_ptr<Model>> models;
+        for (int i = 0; i < characters; i++)
+            models.emplace_back(new Model(path, false, nullptr, false, &resources));
+        textureLoader.finish();
+        glFinish();
+        double loadMs = millisecondsSince(start);
+
+        ResourceReport report = resources.report();
+        std::printf("shared:   %7.1f ms load, %3zu textures %8.2f MiB, %3zu meshes %8.2f MiB, total %8.2f MiB\n", loadMs,
+            report.textures.count, mebibytes(report.textures.bytes), report.meshes.count, mebibytes(report.meshes.bytes),
+            mebibytes(report.totalBytes()));
+        report.print(std::cout, 4);
+
+        // deferred destruction: nothing is deleted until DESTROY_DELAY_FRAMES frames after the last release
+        for (auto& model : models)
+            model->release();
+        models.clear();
+        for (uint64_t frame = 1; frame <= ResourceManager::DESTROY_DELAY_FRAMES; frame++)
+        {
+            std::size_t destroyed = resources.collectGarbage();
+            std::printf("frame %llu after release: %zu objects deleted, %zu resident\n", static_cast<unsigned long long>(frame), destroyed,
+                resources.report().entries.size());
+        }
+        resources.release();
+    }
+
+    textureLoader.release();
+    if (argc <= 2)
+    {
+        std::error_code error;
+        std::filesystem::remove_all(syntheticDirectory, error);
+    }
+    glfwTerminate();
+    return 0;
+}
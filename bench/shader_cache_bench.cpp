@@ -0,0 +1,115 @@
+// Time to build every shader program variant of the game with the ShaderManager
+// (src/shader_manager.h): compiled from source with a cold (empty) program binary cache, then
+// created from the cached binaries with a warm one. Renders nothing; a hidden window provides
+// the context.
+//
+//     shader_cache_bench [rounds]
+//
+// Each round starts from an empty cache directory. Drivers with their own shader cache hide
+// most of the compile cost after the first run (the "no cache" line of the first round);
+// Mesa only offers program binaries while its cache is on, so point it at an empty
+// directory for cold numbers instead, e.g. MESA_SHADER_CACHE_DIR=$(mktemp -d). The startup
+// section of the headless report (PlayableCharacter --headless) shows the same for the
+// programs the game loads.
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <learnopengl/filesystem.h>
+
+#include "gl_context.h"
+#include "shader_manager.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+    struct Variant
+    {
+        const char* vertex;
+        const char* fragment;
+        std::vector<std::string> defines;
+    };
+
+    // builds every variant once; returns the milliseconds taken until the driver finished
+    double buildAll(ShaderManager& manager, const std::vector<Variant>& variants)
+    {
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::unique_ptr<Shader>> programs;
+        for (const Variant& variant : variants)
+            programs.push_back(manager.build(FileSystem::getPath(variant.vertex), FileSystem::getPath(variant.fragment), variant.defines));
+        glFinish();
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        for (const std::unique_ptr<Shader>& program : programs)
+            glDeleteProgram(program->ID);
+        return ms;
+    }
+
+    double median(std::vector<double> values)
+    {
+        std::sort(values.begin(), values.end());
+        return values[values.size() / 2];
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    int rounds = argc > 1 ? std::max(1, std::atoi(argv[1])) : 5;
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "palbom_shader_cache_bench";
+
+    GLFWwindow* window = createHiddenContext("shader_cache_bench");
+    if (window == NULL)
+        return -1;
+
+    const std::vector<Variant> variants = {
+        { "shaders/tile.vs", "shaders/tile.fs", {} },
+        { "shaders/model.vs", "shaders/model.fs", {} },
+        { "shaders/model.vs", "shaders/model.fs", { "SKINNED" } },
+        { "shaders/skybox.vs", "shaders/skybox.fs", {} },
+    };
+
+    // compiling without any cache, for reference
+    std::vector<double> uncached;
+    for (int round = 0; round < rounds; round++)
+    {
+        ShaderManager manager;
+        uncached.push_back(buildAll(manager, variants));
+    }
+
+    std::vector<double> cold, warm;
+    unsigned int hits = 0;
+    for (int round = 0; round < rounds; round++)
+    {
+        std::error_code error;
+        std::filesystem::remove_all(directory, error);
+        ShaderManager coldManager;
+        if (!coldManager.enableBinaryCache(directory.string(), (GLADloadproc)glfwGetProcAddress))
+        {
+            std::printf("program binaries are not supported by %s\n", glGetString(GL_RENDERER));
+            glfwTerminate();
+            return 1;
+        }
+        cold.push_back(buildAll(coldManager, variants));
+
+        ShaderManager warmManager;
+        warmManager.enableBinaryCache(directory.string(), (GLADloadproc)glfwGetProcAddress);
+        warm.push_back(buildAll(warmManager, variants));
+        hits = warmManager.statistics().cacheHits;
+    }
+    std::error_code error;
+    std::filesystem::remove_all(directory, error);
+
+    std::printf("%zu programs on %s, median of %d rounds\n", variants.size(), glGetString(GL_RENDERER), rounds);
+    std::printf("  no cache     %8.2f ms\n", median(uncached));
+    std::printf("  cold cache   %8.2f ms (compile, link and store the binaries)\n", median(cold));
+    std::printf("  warm cache   %8.2f ms (%u of %zu programs from binaries)\n", median(warm), hits, variants.size());
+
+    glfwTerminate();
+    return 0;
+}
@@ -0,0 +1,23 @@
+#version 330 core
+// bench/tile_renderer.h: one cube mesh drawn per tile with per-instance matrices, lit by
+// shaders/tile.fs like the chunked map geometry of the game
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+layout (location = 2) in vec2 aTexCoord;
+layout (location = 3) in mat4 aModel;        // per-instance model matrix (occupies locations 3-6)
+layout (location = 7) in mat3 aNormalMatrix; // per-instance transpose(inverse(mat3(model))), computed on the CPU (locations 7-9)
+
+out vec3 FragPos;
+out vec3 Normal;
+out vec2 TexCoord;
+
+#include "../../shaders/include/frame_uniforms.glsl"
+
+void main()
+{
+    FragPos = vec3(aModel * vec4(aPos, 1.0));
+    Normal = aNormalMatrix * aNormal; // Transform normal to world space
+    TexCoord = aTexCoord;
+    
+    gl_Position = projection * view * vec4(FragPos, 1.0);
+}
@@ -0,0 +1,145 @@
+// Skeleton evaluation throughput on a Mixamo-style rig: Animator::EvaluatePose over the
+// compiled node array against the recursive, string keyed CalculateBoneTransform it replaced.
+#include "mixamo_rig.h"
+
+#include <learnopengl/animation.h>
+#include <learnopengl/animator.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // the Animator evaluation before the skeleton was compiled, kept verbatim for comparison
+    class LegacyAnimator
+    {
+    public:
+        LegacyAnimator(Animation* animation)
+            : m_FinalBoneMatrices(Animator::MAX_BONES, glm::mat4(1.0f)), m_CurrentAnimation(animation)
+        {
+        }
+
+        void Evaluate(float time)
+        {
+            m_CurrentTime = time;
+            CalculateBoneTransform(&m_CurrentAnimation->GetRootNode(), glm::mat4(1.0f));
+        }
+
+        void CalculateBoneTransform(const AssimpNodeData* node, glm::mat4 parentTransform)
+        {
+            std::string nodeName = node->name;
+            glm::mat4 nodeTransform = node->transformation;
+
+            Bone* Bone = m_CurrentAnimation->FindBone(nodeName);
+
+            if (Bone)
+            {
+                Bone->Update(m_CurrentTime);
+                nodeTransform = Bone->GetLocalTransform();
+            }
+
+            glm::mat4 globalTransformation = parentTransform * nodeTransform;
+
+            auto boneInfoMap = m_CurrentAnimation->GetBoneIDMap();
+            if (boneInfoMap.find(nodeName) != boneInfoMap.end())
+            {
+                int index = boneInfoMap[nodeName].id;
+                glm::mat4 offset = boneInfoMap[nodeName].offset;
+                m_FinalBoneMatrices[index] = globalTransformation * offset;
+            }
+
+            for (int i = 0; i < node->childrenCount; i++)
+                CalculateBoneTransform(&node->children[i], globalTransformation);
+        }
+
+        std::vector<glm::mat4> GetFinalBoneMatrices()
+        {
+            return m_FinalBoneMatrices;
+        }
+
+    private:
+        std::vector<glm::mat4> m_FinalBoneMatrices;
+        Animation* m_CurrentAnimation;
+        float m_CurrentTime = 0.0f;
+    };
+
+    double secondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+int main()
+{
+    const double MIN_SECONDS = 1.0;
+    const float DT = 1.0f / 60.0f;
+
+    MixamoRig rig = buildMixamoRig();
+    Animation animation(rig.clip.get(), rig.root.get(), rig.boneInfoMap, rig.boneCount);
+    std::printf("rig: %d bones, %zu nodes, %.0f ticks at %.0f ticks/s\n", rig.boneCount, animation.GetSkeleton().size(),
+        animation.GetDuration(), animation.GetTicksPerSecond());
+
+    // both paths must produce the same palette before their speed means anything
+    LegacyAnimator legacy(&animation);
+    Animator animator(&animation);
+    float maxError = 0.0f;
+    float time = 0.0f;
+    for (int frame = 0; frame < 120; frame++)
+    {
+        animator.UpdateAnimation(DT);
+        time = std::fmod(time + animation.GetTicksPerSecond() * DT, animation.GetDuration());
+        legacy.Evaluate(time);
+        std::vector<glm::mat4> expected = legacy.GetFinalBoneMatrices();
+        const std::vector<glm::mat4>& actual = animator.GetFinalBoneMatrices();
+        for (int bone = 0; bone < rig.boneCount; bone++)
+            for (int column = 0; column < 4; column++)
+                for (int row = 0; row < 4; row++)
+                    maxError = std::max(maxError, std::fabs(expected[bone][column][row] - actual[bone][column][row]));
+    }
+    std::printf("max difference to legacy: %g\n", maxError);
+    if (maxError > 1e-4f)
+        return 1;
+
+    // legacy: recursive walk, then the by-value palette copy the render loop made each frame
+    float checksum = 0.0f;
+    std::size_t legacyCount = 0;
+    auto start = std::chrono::steady_clock::now();
+    while (secondsSince(start) < MIN_SECONDS)
+    {
+        for (int i = 0; i < 256; i++, legacyCount++)
+        {
+            time = std::fmod(time + animation.GetTicksPerSecond() * DT, animation.GetDuration());
+            legacy.Evaluate(time);
+            std::vector<glm::mat4> transforms = legacy.GetFinalBoneMatrices();
+            checksum += transforms[rig.boneCount - 1][3][1];
+        }
+    }
+    double legacySeconds = secondsSince(start);
+
+    // compiled: UpdateAnimation's linear pass, read back by reference; EvaluatePose into a
+    // caller-provided span is the same loop
+    std::size_t compiledCount = 0;
+    start = std::chrono::steady_clock::now();
+    while (secondsSince(start) < MIN_SECONDS)
+    {
+        for (int i = 0; i < 256; i++, compiledCount++)
+        {
+            animator.UpdateAnimation(DT);
+            const std::vector<glm::mat4>& transforms = animator.GetFinalBoneMatrices();
+            checksum += transforms[rig.boneCount - 1][3][1];
+        }
+    }
+    double compiledSeconds = secondsSince(start);
+
+    double legacyMicroseconds = 1e6 * legacySeconds / legacyCount;
+    double compiledMicroseconds = 1e6 * compiledSeconds / compiledCount;
+    std::printf("%-10s %14s %14s\n", "path", "poses/s", "us/pose");
+    std::printf("%-10s %14.0f %14.2f\n", "legacy", legacyCount / legacySeconds, legacyMicroseconds);
+    std::printf("%-10s %14.0f %14.2f\n", "compiled", compiledCount / compiledSeconds, compiledMicroseconds);
+    std::printf("speedup %.1fx   (checksum %g)\n", legacyMicroseconds / compiledMicroseconds, checksum);
+    return 0;
+}
@@ -0,0 +1,99 @@
+#ifndef SYNTHETIC_CHARACTER_H
+#define SYNTHETIC_CHARACTER_H
+
+// Synthetic Mixamo-sized character for the benchmarks that load models: the rig and clip of
+// bench/mixamo_rig.h plus a skinned body mesh, written as a baked .bmdl next to a stand-in
+// source file, so Model and Animation load it like a baked FBX without any asset files.
+#include "mixamo_rig.h"
+#include "model_cache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+// a cylinder of rings around the spine, each vertex weighted to the two nearest of the rig's bones
+inline ModelCache::MeshData makeCharacterMesh(int rings, int segments, int boneCount,
+    const std::vector<std::pair<std::string, std::string>>& textures)
+{
+    ModelCache::MeshData mesh;
+    mesh.skinned = true;
+    mesh.textures = textures;
+    for (int r = 0; r <= rings; r++)
+    {
+        float v = float(r) / rings;
+        for (int s = 0; s <= segments; s++)
+        {
+            float u = float(s) / segments, angle = u * 6.2831853f;
+            Vertex vertex;
+            vertex.Normal = glm::vec3(std::cos(angle), 0.0f, std::sin(angle));
+            vertex.Position = vertex.Normal * 20.0f + glm::vec3(0.0f, v * 180.0f, 0.0f);
+            vertex.TexCoords = glm::vec2(u, v);
+            vertex.Tangent = glm::vec3(-std::sin(angle), 0.0f, std::cos(angle));
+            vertex.Bitangent = glm::cross(vertex.Normal, vertex.Tangent);
+            float along = v * (boneCount - 1);
+            int bone = std::min(boneCount - 2, static_cast<int>(along));
+            float weight = along - bone;
+            vertex.m_BoneIDs[0] = bone;
+            vertex.m_Weights[0] = 1.0f - weight;
+            vertex.m_BoneIDs[1] = bone + 1;
+            vertex.m_Weights[1] = weight;
+            for (int i = 2; i < MAX_BONE_INFLUENCE; i++)
+            {
+                vertex.m_BoneIDs[i] = -1;
+                vertex.m_Weights[i] = 0.0f;
+            }
+            mesh.vertices.push_back(vertex);
+        }
+    }
+    for (int r = 0; r < rings; r++)
+    {
+        for (int s = 0; s < segments; s++)
+        {
+            unsigned int a = r * (segments + 1) + s, b = a + segments + 1;
+            unsigned int quad[] = { a, b, a + 1, a + 1, b, b + 1 };
+            mesh.indices.insert(mesh.indices.end(), quad, quad + 6);
+        }
+    }
+    return mesh;
+}
+
+// rig, clip and a 19.5k vertex body; the mesh is left out with includeMesh false
+inline ModelCache::SceneData buildSyntheticCharacter(bool includeMesh,
+    const std::vector<std::pair<std::string, std::string>>& textures = {})
+{
+    MixamoRig rig = buildMixamoRig();
+    aiScene scene;
+    scene.mRootNode = rig.root.release();
+    scene.mNumAnimations = 1;
+    scene.mAnimations = new aiAnimation*[1];
+    scene.mAnimations[0] = rig.clip.release();
+
+    ModelCache::SceneData data;
+    ModelCache::extractScene(&scene, data, false);
+    if (includeMesh)
+        data.meshes.push_back(makeCharacterMesh(120, 160, rig.boneCount, textures));
+    data.boneInfoMap = rig.boneInfoMap;
+    data.boneCount = rig.boneCount;
+    return data;
+}
+
+// write sourceBytes of filler as sourcePath (hashed like a real FBX of that size) and data
+// as its .bmdl
+inline bool writeSyntheticCharacter(const std::string& sourcePath, const ModelCache::SceneData& data, std::size_t sourceBytes = 256 * 1024)
+{
+    FILE* file = std::fopen(sourcePath.c_str(), "wb");
+    if (file == NULL)
+        return false;
+    std::vector<unsigned char> filler(sourceBytes, 0x5a);
+    bool ok = std::fwrite(filler.data(), 1, filler.size(), file) == filler.size();
+    ok = std::fclose(file) == 0 && ok;
+
+    uint64_t sourceSize, sourceHash;
+    return ok && TextureCache::hashFile(sourcePath, sourceSize, sourceHash)
+        && ModelCache::writeBaked(ModelCache::bakedPath(sourcePath), data.view(), sourceSize, sourceHash);
+}
+
+#endif
@@ -0,0 +1,102 @@
+// Arena generation throughput: the TileGrid generator (+ validation) against the old
+// mt19937 / lambda based generator that filled a vector of positions.
+#include "tile_grid.h"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    // the generator main.cpp used before TileGrid, generalised to any map size
+    void legacyGenerate(int mapSize, std::vector<std::pair<int, int>>& positions, std::mt19937& generator)
+    {
+        auto isRedBlock = [&](int x, int z) {
+            return x >= 2 && x <= mapSize - 3 && x % 2 == 0 && z >= 2 && z <= mapSize - 3 && z % 2 == 0;
+        };
+        auto isGreenCell = [&](int x, int z) {
+            return ((x == 1 || x == 2) && (z == 1 || z == 2))
+                || ((x == mapSize - 3 || x == mapSize - 2) && (z == mapSize - 3 || z == mapSize - 2));
+        };
+        auto isWhiteCell = [&](int x, int z) {
+            if (x == 0 || x == mapSize - 1 || z == 0 || z == mapSize - 1)
+                return false;
+            return !isRedBlock(x, z) && !isGreenCell(x, z);
+        };
+
+        positions.clear();
+        std::uniform_real_distribution<float> dis(0.0f, 1.0f);
+        for (int x = 1; x < mapSize - 1; x++)
+            for (int z = 1; z < mapSize - 1; z++)
+                if (isWhiteCell(x, z) && dis(generator) < 0.6f)
+                    positions.push_back({ x, z });
+    }
+
+    double secondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+int main()
+{
+    const double MIN_SECONDS = 0.5;
+
+    std::printf("%-8s %18s %18s %20s %10s\n", "map", "legacy arenas/s", "grid arenas/s", "grid+validate /s", "valid");
+    const int sizes[] = { 15, 31, 63, 127 };
+    for (int mapSize : sizes)
+    {
+        // legacy generator
+        std::vector<std::pair<int, int>> positions;
+        std::mt19937 generator(1);
+        std::size_t legacyCount = 0;
+        std::size_t checksum = 0;
+        auto start = std::chrono::steady_clock::now();
+        while (secondsSince(start) < MIN_SECONDS)
+        {
+            for (int i = 0; i < 256; i++, legacyCount++)
+            {
+                legacyGenerate(mapSize, positions, generator);
+                checksum += positions.size();
+            }
+        }
+        double legacyRate = legacyCount / secondsSince(start);
+
+        // TileGrid generator
+        TileGrid grid(mapSize, mapSize);
+        std::uint64_t seed = 1;
+        std::size_t gridCount = 0;
+        start = std::chrono::steady_clock::now();
+        while (secondsSince(start) < MIN_SECONDS)
+        {
+            for (int i = 0; i < 256; i++, gridCount++)
+            {
+                grid.generateBreakableBlocks(seed++);
+                checksum += grid.breakableCount();
+            }
+        }
+        double gridRate = gridCount / secondsSince(start);
+
+        // TileGrid generator + validation, as matchmaking would pre-generate arenas
+        std::size_t validatedCount = 0;
+        std::size_t validCount = 0;
+        start = std::chrono::steady_clock::now();
+        while (secondsSince(start) < MIN_SECONDS)
+        {
+            for (int i = 0; i < 256; i++, validatedCount++)
+            {
+                grid.generateBreakableBlocks(seed++);
+                validCount += grid.validate();
+            }
+        }
+        double validatedRate = validatedCount / secondsSince(start);
+
+        char label[16];
+        std::snprintf(label, sizeof(label), "%dx%d", mapSize, mapSize);
+        std::printf("%-8s %18.0f %18.0f %20.0f %9.1f%%   (checksum %zu)\n", label, legacyRate, gridRate, validatedRate,
+            100.0 * validCount / validatedCount, checksum);
+    }
+    return 0;
+}
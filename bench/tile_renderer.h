@@ -0,0 +1,226 @@
+#ifndef TILE_RENDERER_H
+#define TILE_RENDERER_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_inverse.hpp>
+
+#include "render_queue.h"
+
+#include <cstddef>
+#include <vector>
+
+// block categories of the map; each one is drawn with a single instanced draw call
+enum class TileCategory
+{
+    Floor = 0,
+    Border,
+    RedBlock,
+    Breakable,
+    Count
+};
+
+// Draws the map blocks with one glDrawElementsInstanced call per category.
+// Every category keeps its own per-instance model matrix buffer which is only
+// rebuilt (setInstances) or patched (updateInstance/removeInstance) when the grid
+// changes, never per frame. The model matrix is fed to the vertex shader as an
+// instanced mat4 attribute at locations 3..6, followed by its normal matrix
+// (computed here once per instance) as a mat3 at locations 7..9 (see bench/shaders/tile_instanced.vs).
+class TileRenderer
+{
+public:
+    static constexpr unsigned int MODEL_ATTRIBUTE_LOCATION = 3;
+    static constexpr unsigned int NORMAL_MATRIX_ATTRIBUTE_LOCATION = 7;
+    static constexpr unsigned int CATEGORY_COUNT = static_cast<unsigned int>(TileCategory::Count);
+
+    // vertexBuffer/elementBuffer hold the shared block mesh (position, normal, texcoord; 8 floats per vertex)
+    TileRenderer(unsigned int vertexBuffer, unsigned int elementBuffer, unsigned int indexCount)
+        : indexCount(indexCount)
+    {
+        for (unsigned int i = 0; i < CATEGORY_COUNT; i++)
+            setupCategory(batches[i], vertexBuffer, elementBuffer);
+    }
+
+    TileRenderer(const TileRenderer&) = delete;
+    TileRenderer& operator=(const TileRenderer&) = delete;
+
+    // de-allocate the GL objects; must be called while the context is still current
+    void release()
+    {
+        for (unsigned int i = 0; i < CATEGORY_COUNT; i++)
+        {
+            glDeleteVertexArrays(1, &batches[i].VAO);
+            glDeleteBuffers(1, &batches[i].instanceVBO);
+            batches[i] = Batch();
+        }
+    }
+
+    // replace all instances of a category (e.g. after the breakable blocks were regenerated)
+    // ------------------------------------------------------------------------
+    void setInstances(TileCategory category, const std::vector<glm::mat4>& models)
+    {
+        Batch& batch = batches[index(category)];
+        batch.instances.resize(models.size());
+        for (std::size_t i = 0; i < models.size(); i++)
+            batch.instances[i] = makeInstance(models[i]);
+
+        glBindBuffer(GL_ARRAY_BUFFER, batch.instanceVBO);
+        if (batch.instances.size() > batch.capacity)
+        {
+            // grow the buffer storage; shrinking keeps the old allocation around for reuse
+            batch.capacity = batch.instances.size();
+            glBufferData(GL_ARRAY_BUFFER, batch.capacity * sizeof(Instance), batch.instances.data(), GL_DYNAMIC_DRAW);
+        }
+        else if (!batch.instances.empty())
+        {
+            glBufferSubData(GL_ARRAY_BUFFER, 0, batch.instances.size() * sizeof(Instance), batch.instances.data());
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    // patch a single instance in place
+    // ------------------------------------------------------------------------
+    void updateInstance(TileCategory category, std::size_t instance, const glm::mat4& model)
+    {
+        Batch& batch = batches[index(category)];
+        if (instance >= batch.instances.size())
+            return;
+
+        batch.instances[instance] = makeInstance(model);
+        uploadInstance(batch, instance);
+    }
+
+    // remove a single instance (e.g. a destroyed block). The last instance is moved into
+    // the freed slot, so callers tracking instance indices must mirror the swap.
+    // ------------------------------------------------------------------------
+    void removeInstance(TileCategory category, std::size_t instance)
+    {
+        Batch& batch = batches[index(category)];
+        if (instance >= batch.instances.size())
+            return;
+
+        std::size_t last = batch.instances.size() - 1;
+        if (instance != last)
+        {
+            batch.instances[instance] = batch.instances[last];
+            uploadInstance(batch, instance);
+        }
+        batch.instances.pop_back();
+    }
+
+    std::size_t instanceCount(TileCategory category) const
+    {
+        return batches[index(category)].instances.size();
+    }
+
+    // draw every instance of a category; the caller binds the shader and texture.
+    // returns the number of draw calls issued (0 for an empty category)
+    // ------------------------------------------------------------------------
+    unsigned int draw(TileCategory category) const
+    {
+        const Batch& batch = batches[index(category)];
+        if (batch.instances.empty())
+            return 0;
+
+        glBindVertexArray(batch.VAO);
+        glDrawElementsInstanced(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0, static_cast<GLsizei>(batch.instances.size()));
+        return 1;
+    }
+
+    // queue the instanced draw of a category; command carries the program, textures and pass,
+    // the renderer fills in its vertex array and counts. returns the number of commands queued
+    // ------------------------------------------------------------------------
+    unsigned int submit(RenderQueue& queue, TileCategory category, RenderCommand command) const
+    {
+        const Batch& batch = batches[index(category)];
+        if (batch.instances.empty())
+            return 0;
+
+        command.vertexArray = batch.VAO;
+        command.indexed = true;
+        command.count = indexCount;
+        command.instances = static_cast<GLsizei>(batch.instances.size());
+        queue.submit(command);
+        return 1;
+    }
+
+private:
+    // layout of one element of the instance buffer
+    struct Instance
+    {
+        glm::mat4 model;
+        glm::mat3 normalMatrix;
+    };
+
+    struct Batch
+    {
+        unsigned int VAO = 0;
+        unsigned int instanceVBO = 0;
+        std::size_t capacity = 0;
+        std::vector<Instance> instances; // CPU mirror of the instance buffer
+    };
+
+    Batch batches[CATEGORY_COUNT];
+    unsigned int indexCount;
+
+    static unsigned int index(TileCategory category)
+    {
+        return static_cast<unsigned int>(category);
+    }
+
+    static Instance makeInstance(const glm::mat4& model)
+    {
+        return { model, glm::inverseTranspose(glm::mat3(model)) };
+    }
+
+    void uploadInstance(const Batch& batch, std::size_t instance)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, batch.instanceVBO);
+        glBufferSubData(GL_ARRAY_BUFFER, instance * sizeof(Instance), sizeof(Instance), &batch.instances[instance]);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    void setupCategory(Batch& batch, unsigned int vertexBuffer, unsigned int elementBuffer)
+    {
+        glGenVertexArrays(1, &batch.VAO);
+        glGenBuffers(1, &batch.instanceVBO);
+
+        glBindVertexArray(batch.VAO);
+
+        // shared block mesh
+        glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, elementBuffer);
+        // position attribute
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
+        glEnableVertexAttribArray(0);
+        // normal attribute
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
+        glEnableVertexAttribArray(1);
+        // texture coord attribute
+        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
+        glEnableVertexAttribArray(2);
+
+        // per-instance model matrix, one vec4 column per attribute location
+        glBindBuffer(GL_ARRAY_BUFFER, batch.instanceVBO);
+        for (unsigned int column = 0; column < 4; column++)
+        {
+            unsigned int location = MODEL_ATTRIBUTE_LOCATION + column;
+            glEnableVertexAttribArray(location);
+            glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, sizeof(Instance), (void*)(offsetof(Instance, model) + column * sizeof(glm::vec4)));
+            glVertexAttribDivisor(location, 1);
+        }
+        // per-instance normal matrix, one vec3 column per attribute location
+        for (unsigned int column = 0; column < 3; column++)
+        {
+            unsigned int location = NORMAL_MATRIX_ATTRIBUTE_LOCATION + column;
+            glEnableVertexAttribArray(location);
+            glVertexAttribPointer(location, 3, GL_FLOAT, GL_FALSE, sizeof(Instance), (void*)(offsetof(Instance, normalMatrix) + column * sizeof(glm::vec3)));
+            glVertexAttribDivisor(location, 1);
+        }
+
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+};
+
+#endif
@@ -0,0 +1,204 @@
+// Compares CPU frame time of the old per-tile draw loop against the instanced TileRenderer
+// for 15x15, 63x63 and 255x255 maps. Renders into a hidden window so it can run unattended.
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <learnopengl/filesystem.h>
+#include <learnopengl/shader_m.h>
+
+#include "frame_uniforms.h"
+#include "gl_context.h"
+#include "shader_manager.h"
+#include "tile_renderer.h"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace
+{
+    const int FRAMES = 200;
+    const int WARMUP_FRAMES = 10;
+
+    struct MapInstances
+    {
+        std::vector<glm::mat4> categories[TileRenderer::CATEGORY_COUNT];
+    };
+
+    // same layout rules as main.cpp, generalised to any odd map size
+    MapInstances buildMap(int mapSize)
+    {
+        const float blockHeight = 0.2f;
+        const float offset = -(mapSize - 1) / 2.0f;
+        std::mt19937 gen(1234);
+        std::uniform_real_distribution<float> dis(0.0f, 1.0f);
+
+        auto model = [&](int x, int z, float baseY, float scaleY) {
+            glm::mat4 m = glm::translate(glm::mat4(1.0f), glm::vec3(offset + x, baseY, offset + z));
+            return glm::scale(m, glm::vec3(1.0f, scaleY, 1.0f));
+        };
+
+        MapInstances map;
+        for (int x = 0; x < mapSize; x++)
+        {
+            for (int z = 0; z < mapSize; z++)
+            {
+                map.categories[(int)TileCategory::Floor].push_back(model(x, z, 0.0f, 1.0f));
+
+                bool isBorder = (x == 0 || x == mapSize - 1 || z == 0 || z == mapSize - 1);
+                bool isRed = x % 2 == 0 && z % 2 == 0;
+                bool isSpawn = (x <= 2 && z <= 2) || (x >= mapSize - 3 && z >= mapSize - 3);
+                if (isBorder)
+                    map.categories[(int)TileCategory::Border].push_back(model(x, z, blockHeight, 1.0f / blockHeight));
+                else if (isRed)
+                    map.categories[(int)TileCategory::RedBlock].push_back(model(x, z, blockHeight, 0.75f / blockHeight));
+                else if (!isSpawn && dis(gen) < 0.6f)
+                    map.categories[(int)TileCategory::Breakable].push_back(model(x, z, blockHeight, 0.75f / blockHeight));
+            }
+        }
+        return map;
+    }
+
+    struct Timing
+    {
+        double cpuMs;   // time to submit the frame
+        double totalMs; // submit + glFinish
+    };
+
+    template <typename DrawFn>
+    Timing timeFrames(GLFWwindow* window, DrawFn drawFrame)
+    {
+        using clock = std::chrono::steady_clock;
+        double cpu = 0.0, total = 0.0;
+        for (int frame = 0; frame < WARMUP_FRAMES + FRAMES; frame++)
+        {
+            auto start = clock::now();
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            drawFrame();
+            auto submitted = clock::now();
+            glFinish();
+            auto finished = clock::now();
+            glfwSwapBuffers(window);
+
+            if (frame >= WARMUP_FRAMES)
+            {
+                cpu += std::chrono::duration<double, std::milli>(submitted - start).count();
+                total += std::chrono::duration<double, std::milli>(finished - start).count();
+            }
+        }
+        return { cpu / FRAMES, total / FRAMES };
+    }
+}
+
+int main()
+{
+    GLFWwindow* window = createHiddenContext("tile_renderer_bench", 800, 600);
+    if (window == NULL)
+        return -1;
+    glEnable(GL_DEPTH_TEST);
+
+    ShaderManager shaderManager;
+    std::unique_ptr<Shader> tileShader = shaderManager.build(FileSystem::getPath("bench/shaders/tile_instanced.vs"), FileSystem::getPath("shaders/tile.fs"));
+    Shader& shader = *tileShader;
+    shader.use();
+    shader.setInt(shader.uniform("texture1"), 0);
+    shader.bindUniformBlock(FrameUniforms::BLOCK_NAME, FrameUniforms::BINDING_POINT);
+    FrameUniforms frameUniforms;
+    frameUniforms.setLight(glm::vec3(0.0f, 20.0f, 0.0f), glm::vec3(1.0f, 1.0f, 0.95f));
+
+    // unit block, only the vertex count matters here
+    float vertices[24 * 8] = {};
+    for (int i = 0; i < 24; i++)
+    {
+        vertices[i * 8 + 0] = (i & 1) ? 0.5f : -0.5f;
+        vertices[i * 8 + 1] = (i & 2) ? 0.2f : 0.0f;
+        vertices[i * 8 + 2] = (i & 4) ? 0.5f : -0.5f;
+        vertices[i * 8 + 4] = 1.0f;
+    }
+    unsigned int indices[36];
+    for (int i = 0; i < 36; i++)
+        indices[i] = (i * 7) % 24;
+
+    unsigned int VBO, EBO, legacyVAO;
+    glGenBuffers(1, &VBO);
+    glGenBuffers(1, &EBO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+
+    // legacy path: plain VAO, the model and normal matrices are set per draw like the old setMat4("model") loop
+    glGenVertexArrays(1, &legacyVAO);
+    glBindVertexArray(legacyVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
+    glEnableVertexAttribArray(2);
+    glBindVertexArray(0);
+
+    TileRenderer tileRenderer(VBO, EBO, 36);
+
+    std::printf("%-8s %8s %16s %16s %18s %18s\n", "map", "blocks", "legacy cpu ms", "legacy total ms", "instanced cpu ms", "instanced total ms");
+    const int sizes[] = { 15, 63, 255 };
+    for (int mapSize : sizes)
+    {
+        MapInstances map = buildMap(mapSize);
+        size_t blocks = 0;
+        for (unsigned int c = 0; c < TileRenderer::CATEGORY_COUNT; c++)
+        {
+            tileRenderer.setInstances((TileCategory)c, map.categories[c]);
+            blocks += map.categories[c].size();
+        }
+
+        float aspect = 800.0f / 600.0f;
+        glm::vec3 cameraPos(0.0f, mapSize * 1.2f, mapSize * 1.1f);
+        frameUniforms.setCamera(glm::perspective(glm::radians(45.0f), aspect, 0.1f, mapSize * 4.0f),
+            glm::lookAt(cameraPos, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f)), cameraPos);
+        frameUniforms.upload();
+
+        Timing legacy = timeFrames(window, [&]() {
+            shader.use();
+            glBindVertexArray(legacyVAO);
+            for (unsigned int c = 0; c < TileRenderer::CATEGORY_COUNT; c++)
+            {
+                for (const glm::mat4& model : map.categories[c])
+                {
+                    glm::mat3 normalMatrix = glm::inverseTranspose(glm::mat3(model));
+                    for (int column = 0; column < 4; column++)
+                        glVertexAttrib4fv(TileRenderer::MODEL_ATTRIBUTE_LOCATION + column, &model[column][0]);
+                    for (int column = 0; column < 3; column++)
+                        glVertexAttrib3fv(TileRenderer::NORMAL_MATRIX_ATTRIBUTE_LOCATION + column, &normalMatrix[column][0]);
+                    glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
+                }
+            }
+        });
+
+        Timing instanced = timeFrames(window, [&]() {
+            shader.use();
+            for (unsigned int c = 0; c < TileRenderer::CATEGORY_COUNT; c++)
+                tileRenderer.draw((TileCategory)c);
+        });
+
+        char label[16];
+        std::snprintf(label, sizeof(label), "%dx%d", mapSize, mapSize);
+        std::printf("%-8s %8zu %16.3f %16.3f %18.3f %18.3f\n", label, blocks,
+            legacy.cpuMs, legacy.totalMs, instanced.cpuMs, instanced.totalMs);
+    }
+
+    tileRenderer.release();
+    frameUniforms.release();
+    glDeleteVertexArrays(1, &legacyVAO);
+    glDeleteBuffers(1, &VBO);
+    glDeleteBuffers(1, &EBO);
+    glfwTerminate();
+    return 0;
+}
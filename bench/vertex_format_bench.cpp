@@ -0,0 +1,230 @@
+// Vertex memory per model in the full LearnOpenGL layout against the compact static/skinned
+// layouts (src/vertex_formats.h), plus the worst-case quantisation error of the encoding.
+//
+//     vertex_format_bench [model file]...
+//
+// Models are imported with the flags Model uses; without arguments two procedural meshes
+// stand in: a static sphere and a skinned four-bone tube.
+#include <learnopengl/assimp_glm_helpers.h>
+#include <learnopengl/mesh.h>
+
+#include <assimp/Importer.hpp>
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace
+{
+    struct MeshData
+    {
+        std::vector<Vertex> vertices;
+        bool skinned = false;
+    };
+
+    struct Errors
+    {
+        float normalDegrees = 0.0f;
+        float tangentDegrees = 0.0f;
+        float texCoord = 0.0f;
+        float weight = 0.0f;
+        int bitangentFlips = 0;
+    };
+
+    Vertex makeVertex(const glm::vec3& position, const glm::vec3& normal, const glm::vec2& texCoords, const glm::vec3& tangent)
+    {
+        Vertex vertex;
+        vertex.Position = position;
+        vertex.Normal = normal;
+        vertex.TexCoords = texCoords;
+        vertex.Tangent = tangent;
+        vertex.Bitangent = glm::cross(normal, tangent);
+        for (int i = 0; i < MAX_BONE_INFLUENCE; i++)
+        {
+            vertex.m_BoneIDs[i] = -1;
+            vertex.m_Weights[i] = 0.0f;
+        }
+        return vertex;
+    }
+
+    MeshData makeSphere(int slices, int stacks)
+    {
+        MeshData mesh;
+        const float PI = 3.14159265f;
+        for (int j = 0; j <= stacks; j++)
+        {
+            float v = float(j) / stacks, phi = v * PI;
+            for (int i = 0; i <= slices; i++)
+            {
+                float u = float(i) / slices, theta = u * 2.0f * PI;
+                glm::vec3 normal(std::sin(phi) * std::cos(theta), std::cos(phi), std::sin(phi) * std::sin(theta));
+                glm::vec3 tangent(-std::sin(theta), 0.0f, std::cos(theta));
+                mesh.vertices.push_back(makeVertex(normal, normal, glm::vec2(u, v), tangent));
+            }
+        }
+        return mesh;
+    }
+
+    // a tube along y split into four bones; each vertex blends its two nearest bones
+    MeshData makeSkinnedTube(int slices, int rings)
+    {
+        MeshData mesh;
+        mesh.skinned = true;
+        const float PI = 3.14159265f;
+        for (int j = 0; j <= rings; j++)
+        {
+            float v = float(j) / rings;
+            for (int i = 0; i <= slices; i++)
+            {
+                float u = float(i) / slices, theta = u * 2.0f * PI;
+                glm::vec3 normal(std::cos(theta), 0.0f, std::sin(theta));
+                Vertex vertex = makeVertex(glm::vec3(0.2f * normal.x, 2.0f * v, 0.2f * normal.z), normal, glm::vec2(u, v),
+                    glm::vec3(-std::sin(theta), 0.0f, std::cos(theta)));
+                float bone = v * 3.0f;
+                int first = std::min(2, (int)bone);
+                float blend = bone - first;
+                vertex.m_BoneIDs[0] = first;
+                vertex.m_Weights[0] = 1.0f - blend;
+                vertex.m_BoneIDs[1] = first + 1;
+                vertex.m_Weights[1] = blend;
+                mesh.vertices.push_back(vertex);
+            }
+        }
+        return mesh;
+    }
+
+    bool loadModel(const std::string& path, std::vector<MeshData>& meshes)
+    {
+        Assimp::Importer importer;
+        const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_CalcTangentSpace);
+        if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
+        {
+            std::printf("%s: %s\n", path.c_str(), importer.GetErrorString());
+            return false;
+        }
+        for (unsigned int m = 0; m < scene->mNumMeshes; m++)
+        {
+            const aiMesh* source = scene->mMeshes[m];
+            MeshData mesh;
+            mesh.skinned = source->HasBones();
+            for (unsigned int i = 0; i < source->mNumVertices; i++)
+            {
+                glm::vec3 tangent = source->mTangents ? AssimpGLMHelpers::GetGLMVec(source->mTangents[i]) : glm::vec3(0.0f);
+                glm::vec2 texCoords = source->mTextureCoords[0]
+                    ? glm::vec2(source->mTextureCoords[0][i].x, source->mTextureCoords[0][i].y) : glm::vec2(0.0f);
+                Vertex vertex = makeVertex(AssimpGLMHelpers::GetGLMVec(source->mVertices[i]),
+                    AssimpGLMHelpers::GetGLMVec(source->mNormals[i]), texCoords, tangent);
+                if (source->mBitangents)
+                    vertex.Bitangent = AssimpGLMHelpers::GetGLMVec(source->mBitangents[i]);
+                mesh.vertices.push_back(vertex);
+            }
+            // first four influences per vertex, as Model::ExtractBoneWeightForVertices keeps them
+            for (unsigned int b = 0; b < source->mNumBones; b++)
+            {
+                const aiBone* bone = source->mBones[b];
+                for (unsigned int w = 0; w < bone->mNumWeights; w++)
+                {
+                    Vertex& vertex = mesh.vertices[bone->mWeights[w].mVertexId];
+                    for (int i = 0; i < MAX_BONE_INFLUENCE; i++)
+                    {
+                        if (vertex.m_BoneIDs[i] < 0)
+                        {
+                            vertex.m_BoneIDs[i] = (int)b;
+                            vertex.m_Weights[i] = bone->mWeights[w].mWeight;
+                            break;
+                        }
+                    }
+                }
+            }
+            meshes.push_back(mesh);
+        }
+        return true;
+    }
+
+    float angleDegrees(const glm::vec3& a, const glm::vec3& b)
+    {
+        return std::acos(glm::clamp(glm::dot(glm::normalize(a), glm::normalize(b)), -1.0f, 1.0f)) * 57.2957795f;
+    }
+
+    // decode the compact vertex the way the model shaders do and compare against the source
+    void measure(const Vertex& vertex, bool skinned, Errors& errors)
+    {
+        CompactSkinnedVertex compact;
+        VertexPacking::encodeNormal(vertex.Normal, compact.normal);
+        VertexPacking::encodeTangent(vertex.Normal, vertex.Tangent, vertex.Bitangent, compact.tangent);
+        VertexPacking::encodeTexCoords(vertex.TexCoords, compact.texCoords);
+
+        glm::vec3 normal = VertexPacking::octDecode(glm::vec2(compact.normal[0], compact.normal[1]) / 32767.0f);
+        glm::vec3 tangent = VertexPacking::octDecode(glm::vec2(compact.tangent[0], compact.tangent[1]) / 127.0f);
+        glm::vec3 bitangent = (compact.tangent[2] < 0 ? -1.0f : 1.0f) * glm::cross(normal, tangent);
+        errors.normalDegrees = std::max(errors.normalDegrees, angleDegrees(vertex.Normal, normal));
+        glm::vec3 sourceTangent = vertex.Tangent - vertex.Normal * glm::dot(vertex.Normal, vertex.Tangent);
+        if (glm::dot(sourceTangent, sourceTangent) > 1e-12f)
+        {
+            errors.tangentDegrees = std::max(errors.tangentDegrees, angleDegrees(sourceTangent, tangent));
+            if (glm::dot(bitangent, vertex.Bitangent) < 0.0f)
+                errors.bitangentFlips++;
+        }
+        glm::vec2 texCoords(glm::unpackHalf1x16(compact.texCoords[0]), glm::unpackHalf1x16(compact.texCoords[1]));
+        errors.texCoord = std::max(errors.texCoord, std::max(std::fabs(texCoords.x - vertex.TexCoords.x), std::fabs(texCoords.y - vertex.TexCoords.y)));
+
+        if (!skinned)
+            return;
+        VertexPacking::encodeBoneWeights(vertex.m_BoneIDs, vertex.m_Weights, compact.boneIds, compact.weights);
+        float total = 0.0f;
+        for (int i = 0; i < MAX_BONE_INFLUENCE; i++)
+            total += vertex.m_BoneIDs[i] >= 0 ? vertex.m_Weights[i] : 0.0f;
+        for (int i = 0; i < MAX_BONE_INFLUENCE; i++)
+        {
+            if (vertex.m_BoneIDs[i] < 0 || total <= 0.0f)
+                continue;
+            float expected = vertex.m_Weights[i] / total;
+            errors.weight = std::max(errors.weight, std::fabs(compact.weights[i] / 255.0f - expected));
+        }
+    }
+
+    void report(const std::string& name, const std::vector<MeshData>& meshes)
+    {
+        std::size_t vertexCount = 0, fullBytes = 0, compactBytes = 0;
+        Errors errors;
+        for (const MeshData& mesh : meshes)
+        {
+            vertexCount += mesh.vertices.size();
+            fullBytes += mesh.vertices.size() * sizeof(Vertex);
+            compactBytes += mesh.vertices.size() * (mesh.skinned ? sizeof(CompactSkinnedVertex) : sizeof(CompactStaticVertex));
+            for (const Vertex& vertex : mesh.vertices)
+                measure(vertex, mesh.skinned, errors);
+        }
+        std::printf("%-24s %9zu %12.1f %12.1f %7.2fx %8.3f %8.3f %9.2g %8.4f %6d\n", name.c_str(), vertexCount, fullBytes / 1024.0,
+            compactBytes / 1024.0, compactBytes ? double(fullBytes) / compactBytes : 0.0, errors.normalDegrees, errors.tangentDegrees,
+            errors.texCoord, errors.weight, errors.bitangentFlips);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::printf("bytes per vertex: full %zu, compact static %zu, compact skinned %zu\n", sizeof(Vertex),
+        sizeof(CompactStaticVertex), sizeof(CompactSkinnedVertex));
+    std::printf("%-24s %9s %12s %12s %8s %8s %8s %9s %8s %6s\n", "model", "vertices", "full KiB", "compact KiB", "ratio",
+        "normal°", "tangent°", "uv err", "weight", "flips");
+    if (argc < 2)
+    {
+        report("sphere (static)", { makeSphere(128, 64) });
+        report("tube (skinned)", { makeSkinnedTube(64, 128) });
+        return 0;
+    }
+    int failures = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        std::vector<MeshData> meshes;
+        if (loadModel(argv[i], meshes))
+            report(argv[i], meshes);
+        else
+            failures++;
+    }
+    return failures == 0 ? 0 : 1;
+}
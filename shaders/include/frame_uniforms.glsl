@@ -0,0 +1,9 @@
+// camera and light state shared by every shader (see src/frame_uniforms.h)
+layout (std140) uniform FrameUniforms
+{
+    mat4 projection;
+    mat4 view;
+    vec4 lightPos;
+    vec4 lightColor;
+    vec4 viewPos;
+};
@@ -0,0 +1,23 @@
+#include "frame_uniforms.glsl"
+
+// Phong lighting of a surface point with the frame's single light
+vec3 phongLighting(vec3 norm, vec3 fragPos)
+{
+    // Ambient lighting
+    float ambientStrength = 0.3;
+    vec3 ambient = ambientStrength * lightColor.rgb;
+
+    // Diffuse lighting
+    vec3 lightDir = normalize(lightPos.xyz - fragPos);
+    float diff = max(dot(norm, lightDir), 0.0);
+    vec3 diffuse = diff * lightColor.rgb;
+
+    // Specular lighting
+    float specularStrength = 0.5;
+    vec3 viewDir = normalize(viewPos.xyz - fragPos);
+    vec3 reflectDir = reflect(-lightDir, norm);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32);
+    vec3 specular = specularStrength * spec * lightColor.rgb;
+
+    return ambient + diffuse + specular;
+}
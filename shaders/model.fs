@@ -0,0 +1,22 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec3 FragPos;
+in vec2 TexCoords;
+in mat3 TBN;
+
+uniform sampler2D texture_diffuse1;
+uniform sampler2D texture_normal1;
+uniform bool useNormalMap;
+
+#include "include/lighting.glsl"
+
+void main()
+{
+    vec3 norm = normalize(TBN[2]);
+    if (useNormalMap)
+        norm = normalize(TBN * (texture(texture_normal1, TexCoords).rgb * 2.0 - 1.0));
+
+    vec3 objectColor = texture(texture_diffuse1, TexCoords).rgb;
+    FragColor = vec4(phongLighting(norm, FragPos) * objectColor, 1.0);
+}
@@ -0,0 +1,74 @@
+#version 330 core
+// variants (see src/shader_manager.h):
+//   default  VertexFormat::CompactStatic (see src/vertex_formats.h)
+//   SKINNED  VertexFormat::CompactSkinned, bone matrices blended per vertex, read from the
+//            frame's bone palette buffer (see src/bone_palette_buffer.h)
+//   SKINNED + BONE_UNIFORMS  the same with the palette in a uniform array set per draw
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec2 aNormal;    // octahedral, snorm16
+layout (location = 2) in vec2 aTexCoords; // half float
+layout (location = 3) in vec4 aTangent;   // octahedral xy, bitangent sign z, snorm8
+#ifdef SKINNED
+layout (location = 5) in ivec4 aBoneIds;  // uint8
+layout (location = 6) in vec4 aWeights;   // unorm8, sum to 1 (all 0: not skinned)
+#endif
+
+out vec3 FragPos;
+out vec2 TexCoords;
+out mat3 TBN;
+
+#ifdef SKINNED
+#ifdef BONE_UNIFORMS
+const int MAX_BONES = 100; // Animator::MAX_BONES
+uniform mat4 finalBonesMatrices[MAX_BONES];
+#else
+uniform samplerBuffer bonePalette; // RGBA32F, one texel per matrix column
+uniform int paletteOffset;         // first matrix of this draw's palette
+#endif
+
+mat4 boneMatrix(int bone)
+{
+#ifdef BONE_UNIFORMS
+    return finalBonesMatrices[bone];
+#else
+    int texel = (paletteOffset + bone) * 4;
+    return mat4(texelFetch(bonePalette, texel), texelFetch(bonePalette, texel + 1),
+                texelFetch(bonePalette, texel + 2), texelFetch(bonePalette, texel + 3));
+#endif
+}
+#endif
+uniform mat4 model;
+uniform mat3 normalMatrix; // transpose(inverse(mat3(model))), computed on the CPU (RenderCommand::setModel)
+
+#include "include/frame_uniforms.glsl"
+#include "include/oct_decode.glsl"
+
+void main()
+{
+#ifdef SKINNED
+    mat4 skin = mat4(1.0);
+    if (dot(aWeights, vec4(1.0)) > 0.0)
+    {
+        skin = aWeights.x * boneMatrix(aBoneIds.x)
+             + aWeights.y * boneMatrix(aBoneIds.y)
+             + aWeights.z * boneMatrix(aBoneIds.z)
+             + aWeights.w * boneMatrix(aBoneIds.w);
+    }
+    mat4 skinnedModel = model * skin;
+    // bone matrices are rigid (plus uniform scale), so their mat3 keeps directions correct;
+    // any non-uniform scale lives in model and is handled by normalMatrix
+    mat3 normalTransform = normalMatrix * mat3(skin);
+#else
+    mat4 skinnedModel = model;
+    mat3 normalTransform = normalMatrix;
+#endif
+
+    vec3 normal = octDecode(aNormal);
+    vec3 tangent = octDecode(aTangent.xy);
+    vec3 bitangent = (aTangent.z < 0.0 ? -1.0 : 1.0) * cross(normal, tangent);
+
+    TBN = mat3(normalize(normalTransform * tangent), normalize(normalTransform * bitangent), normalize(normalTransform * normal));
+    FragPos = vec3(skinnedModel * vec4(aPos, 1.0));
+    TexCoords = aTexCoords;
+    gl_Position = projection * view * vec4(FragPos, 1.0);
+}
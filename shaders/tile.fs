@@ -6,32 +6,13 @@ in vec3 Normal;
 in vec2 TexCoord;
 
 uniform sampler2D texture1;
-uniform vec3 lightPos;
-uniform vec3 lightColor;
-uniform vec3 viewPos;
+
+#include "include/lighting.glsl"
 
 void main()
 {
-    // Ambient lighting
-    float ambientStrength = 0.3;
-    vec3 ambient = ambientStrength * lightColor;
-    
-    // Diffuse lighting
-    vec3 norm = normalize(Normal);
-    vec3 lightDir = normalize(lightPos - FragPos);
-    float diff = max(dot(norm, lightDir), 0.0);
-    vec3 diffuse = diff * lightColor;
-    
-    // Specular lighting
-    float specularStrength = 0.5;
-    vec3 viewDir = normalize(viewPos - FragPos);
-    vec3 reflectDir = reflect(-lightDir, norm);
-    float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32);
-    vec3 specular = specularStrength * spec * lightColor;
-    
     // Combine lighting with texture
     vec3 objectColor = texture(texture1, TexCoord).rgb;
-    vec3 result = (ambient + diffuse + specular) * objectColor;
+    vec3 result = phongLighting(normalize(Normal), FragPos) * objectColor;
     FragColor = vec4(result, 1.0);
 }
-
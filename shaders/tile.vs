@@ -1,4 +1,5 @@
 #version 330 core
+// world-space vertices of the chunked map geometry (see src/map_mesher.h)
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTexCoord;
@@ -7,16 +8,13 @@ out vec3 FragPos;
 out vec3 Normal;
 out vec2 TexCoord;
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+#include "include/frame_uniforms.glsl"
 
 void main()
 {
-    FragPos = vec3(model * vec4(aPos, 1.0));
-    Normal = mat3(transpose(inverse(model))) * aNormal; // Transform normal to world space
+    FragPos = aPos;
+    Normal = aNormal;
     TexCoord = aTexCoord;
     
     gl_Position = projection * view * vec4(FragPos, 1.0);
 }
-
@@ -0,0 +1,704 @@
+#ifndef AI_NAVIGATION_H
+#define AI_NAVIGATION_H
+
+#include "blast_system.h"
+#include "tile_grid.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <vector>
+
+// Breadth-first distance field toward a set of goal cells over the walkable cells of a grid.
+// A bot anywhere on the map finds its next step by looking up its four neighbours, so one
+// field serves every bot heading for the same kind of goal.
+//
+// Changes are repaired locally instead of re-running the whole BFS:
+//  - a cell opening up or becoming a goal can only shorten distances, which spread outwards
+//    from that cell until they stop improving;
+//  - a cell closing or losing its goal invalidates the cells whose shortest path led through
+//    it (those left without a neighbour one step closer), and only those are then refilled
+//    from their still valid borders.
+// Both only touch the cells whose distance actually changes.
+class FlowField
+{
+public:
+    static constexpr std::uint32_t UNREACHABLE = 0xffffffffu;
+    static constexpr int NO_DIRECTION = -1;
+
+    FlowField(int width = 0, int height = 0)
+        : fieldWidth(width), fieldHeight(height), walkable(static_cast<std::size_t>(width) * height, 0),
+          goal(walkable.size(), 0), distances(walkable.size(), UNREACHABLE), previous(walkable.size(), UNREACHABLE)
+    {
+    }
+
+    int width() const { return fieldWidth; }
+    int height() const { return fieldHeight; }
+
+    // full BFS from every walkable goal cell; flags come from the setters or setFlags()
+    void rebuild()
+    {
+        std::fill(distances.begin(), distances.end(), UNREACHABLE);
+        std::vector<int> frontier;
+        for (std::size_t cell = 0; cell < goal.size(); cell++)
+        {
+            if (goal[cell] && walkable[cell])
+            {
+                distances[cell] = 0;
+                frontier.push_back(static_cast<int>(cell));
+            }
+        }
+        for (std::size_t next = 0; next < frontier.size(); next++)
+        {
+            int cell = frontier[next];
+            forEachNeighbour(cell, [&](int neighbour) {
+                if (walkable[neighbour] && distances[neighbour] == UNREACHABLE)
+                {
+                    distances[neighbour] = distances[cell] + 1;
+                    frontier.push_back(neighbour);
+                }
+            });
+        }
+        touched += frontier.size();
+    }
+
+    // set the flags of a cell without updating distances (for a rebuild() afterwards)
+    void setFlags(int cell, bool isWalkable, bool isGoal)
+    {
+        walkable[cell] = isWalkable;
+        goal[cell] = isGoal;
+    }
+
+    void setWalkable(int cell, bool isWalkable)
+    {
+        if (walkable[cell] == isWalkable)
+            return;
+        walkable[cell] = isWalkable;
+        if (isWalkable)
+            lower(cell);
+        else
+            raise(cell);
+    }
+
+    void setGoal(int cell, bool isGoal)
+    {
+        if (goal[cell] == isGoal)
+            return;
+        goal[cell] = isGoal;
+        if (!walkable[cell])
+            return;
+        if (isGoal)
+            lower(cell);
+        else
+            raise(cell);
+    }
+
+    bool isWalkable(int cell) const { return walkable[cell] != 0; }
+    bool isGoal(int cell) const { return goal[cell] != 0; }
+
+    // steps to the nearest goal, UNREACHABLE if none can be reached
+    std::uint32_t distance(int cell) const
+    {
+        return distances[cell];
+    }
+
+    // TileGrid::Direction of the neighbour one step closer to a goal; NO_DIRECTION on a goal
+    // or when no goal can be reached
+    int direction(int x, int z) const
+    {
+        int cell = z * fieldWidth + x;
+        std::uint32_t best = distances[cell];
+        int result = NO_DIRECTION;
+        for (int dir = 0; dir < 4; dir++)
+        {
+            int nx = x + TileGrid::DX[dir], nz = z + TileGrid::DZ[dir];
+            if (!inBounds(nx, nz))
+                continue;
+            std::uint32_t d = distances[nz * fieldWidth + nx];
+            if (d < best)
+            {
+                best = d;
+                result = dir;
+            }
+        }
+        return result;
+    }
+
+    // cells whose distance was (re)computed since the last call
+    std::size_t takeTouchedCells()
+    {
+        std::size_t result = touched;
+        touched = 0;
+        return result;
+    }
+
+private:
+    int fieldWidth;
+    int fieldHeight;
+    std::vector<std::uint8_t> walkable;
+    std::vector<std::uint8_t> goal;
+    std::vector<std::uint32_t> distances;
+    std::vector<std::uint32_t> previous; // distance before being invalidated by raise()
+    std::size_t touched = 0;
+
+    // scratch lists, kept to avoid allocating per change
+    std::vector<int> invalidated;
+    std::vector<int> stack;
+
+    typedef std::pair<std::uint32_t, int> QueueEntry;
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> open;
+
+    bool inBounds(int x, int z) const
+    {
+        return static_cast<unsigned int>(x) < static_cast<unsigned int>(fieldWidth)
+            && static_cast<unsigned int>(z) < static_cast<unsigned int>(fieldHeight);
+    }
+
+    template <typename Fn>
+    void forEachNeighbour(int cell, Fn fn) const
+    {
+        int x = cell % fieldWidth, z = cell / fieldWidth;
+        if (z > 0) fn(cell - fieldWidth);
+        if (z + 1 < fieldHeight) fn(cell + fieldWidth);
+        if (x > 0) fn(cell - 1);
+        if (x + 1 < fieldWidth) fn(cell + 1);
+    }
+
+    // the distance a cell would get from its neighbours alone
+    std::uint32_t bestFromNeighbours(int cell) const
+    {
+        if (!walkable[cell])
+            return UNREACHABLE;
+        if (goal[cell])
+            return 0;
+        std::uint32_t best = UNREACHABLE;
+        forEachNeighbour(cell, [&](int neighbour) {
+            if (distances[neighbour] != UNREACHABLE)
+                best = std::min(best, distances[neighbour] + 1);
+        });
+        return best;
+    }
+
+    // distances can only shrink: spread the improvement from the seeds
+    void lower(int seed)
+    {
+        std::uint32_t best = bestFromNeighbours(seed);
+        if (best >= distances[seed])
+            return;
+        distances[seed] = best;
+        open.push({ best, seed });
+        relax();
+    }
+
+    void relax()
+    {
+        while (!open.empty())
+        {
+            QueueEntry entry = open.top();
+            open.pop();
+            if (entry.first != distances[entry.second])
+                continue; // superseded by a shorter distance
+            touched++;
+            std::uint32_t next = entry.first + 1;
+            forEachNeighbour(entry.second, [&](int neighbour) {
+                if (walkable[neighbour] && next < distances[neighbour])
+                {
+                    distances[neighbour] = next;
+                    open.push({ next, neighbour });
+                }
+            });
+        }
+    }
+
+    // distances can only grow: drop every cell that lost its last neighbour one step closer,
+    // then refill the dropped cells from the valid cells around them
+    void raise(int seed)
+    {
+        if (distances[seed] == UNREACHABLE)
+            return;
+        invalidated.clear();
+        stack.clear();
+        invalidate(seed);
+        while (!stack.empty())
+        {
+            int cell = stack.back();
+            stack.pop_back();
+            std::uint32_t dependent = previous[cell] + 1;
+            forEachNeighbour(cell, [&](int neighbour) {
+                if (distances[neighbour] == dependent && !goal[neighbour] && !supported(neighbour))
+                    invalidate(neighbour);
+            });
+        }
+
+        for (int cell : invalidated)
+        {
+            std::uint32_t best = bestFromNeighbours(cell);
+            if (best < distances[cell])
+            {
+                distances[cell] = best;
+                open.push({ best, cell });
+            }
+        }
+        relax();
+    }
+
+    void invalidate(int cell)
+    {
+        previous[cell] = distances[cell];
+        distances[cell] = UNREACHABLE;
+        invalidated.push_back(cell);
+        stack.push_back(cell);
+        touched++;
+    }
+
+    // a neighbour still offers the cell its current distance
+    bool supported(int cell) const
+    {
+        bool result = false;
+        std::uint32_t distance = distances[cell];
+        forEachNeighbour(cell, [&](int neighbour) {
+            result |= walkable[neighbour] && distances[neighbour] + 1 == distance;
+        });
+        return result;
+    }
+};
+
+// The tick at which each cell will next be covered by a blast, for all bombs currently on the
+// map, following the same rules as BlastSystem (rays stop at fixed blocks and at the first
+// breakable block; a blast reaching a bomb sets it off). Ticks are absolute, so the map stays
+// valid while fuses burn down and only changes on events:
+//  - a bomb is placed: its rays can only bring blasts forward, including those of the bombs it
+//    would set off earlier than their own fuse;
+//  - a tick resolves: detonated bombs vanish, which is the only way a cell can become safer.
+//    Any bomb set off by a detonated one went off with it, so the surviving bombs keep their
+//    times and only the cells covered by the tick's blasts are recomputed, each by scanning
+//    outward for the bombs whose rays reach it. Destroyed blocks then let the rays of bombs
+//    behind them through, which again only brings blasts forward.
+class DangerMap
+{
+public:
+    static constexpr std::uint32_t SAFE = 0xffffffffu;
+
+    DangerMap(const TileGrid& grid, const BlastSystem& blasts)
+        : grid(grid), blasts(blasts), blastTicks(static_cast<std::size_t>(grid.width()) * grid.height(), SAFE),
+          bombTicks(blastTicks.size(), SAFE)
+    {
+    }
+
+    // recompute from scratch after the grid or the bombs changed behind our back
+    void rebuild()
+    {
+        std::fill(blastTicks.begin(), blastTicks.end(), SAFE);
+        std::fill(bombTicks.begin(), bombTicks.end(), SAFE);
+        std::vector<int> bombCells;
+        for (int z = 0; z < grid.height(); z++)
+        {
+            for (int x = 0; x < grid.width(); x++)
+            {
+                int bomb = blasts.bombAt(x, z);
+                if (bomb != BlastSystem::NO_BOMB)
+                {
+                    maxRange = std::max(maxRange, blasts.range(bomb));
+                    bombCells.push_back(grid.index(x, z));
+                    bombTicks[bombCells.back()] = now + static_cast<std::uint32_t>(blasts.fuse(bomb));
+                }
+            }
+        }
+        // all bombs are known first, so chains find the bombs they set off
+        for (int cell : bombCells)
+            setOff(cell, bombTicks[cell], true);
+        // everything may have changed; rebuild() is followed by a full flow field rebuild
+        safetyChanged.clear();
+    }
+
+    // a bomb was just placed on the cell
+    void bombPlaced(int x, int z)
+    {
+        int bomb = blasts.bombAt(x, z);
+        if (bomb == BlastSystem::NO_BOMB)
+            return;
+        maxRange = std::max(maxRange, blasts.range(bomb));
+        int cell = grid.index(x, z);
+        bombTicks[cell] = now + static_cast<std::uint32_t>(blasts.fuse(bomb));
+        // the new bomb goes off early if it lies in the path of an earlier blast
+        forEachBombReaching(x, z, [&](int bombCell) { bombTicks[cell] = std::min(bombTicks[cell], bombTicks[bombCell]); });
+        setOff(cell, bombTicks[cell], true);
+    }
+
+    // BlastSystem::tick() just returned this result
+    void tickApplied(const BlastSystem::TickResult& result)
+    {
+        now++;
+        for (const BlastSystem::CellChange& change : result.blast)
+            refresh(change.x, change.z);
+        for (const BlastSystem::CellChange& change : result.destroyed)
+            refresh(change.x, change.z);
+
+        // bombs whose rays stopped at a destroyed block reach further now
+        for (const BlastSystem::CellChange& change : result.destroyed)
+        {
+            forEachBombReaching(change.x, change.z, [&](int bombCell) {
+                setOff(bombCell, bombTicks[bombCell], true);
+            });
+        }
+    }
+
+    std::uint32_t currentTick() const { return now; }
+
+    // ticks until the cell is covered by a blast, SAFE if no pending blast reaches it
+    std::uint32_t ticksUntilBlast(int x, int z) const
+    {
+        std::uint32_t tick = blastTicks[grid.index(x, z)];
+        return tick == SAFE ? SAFE : tick - now;
+    }
+
+    bool isSafe(int cell) const
+    {
+        return blastTicks[cell] == SAFE;
+    }
+
+    // the cells a bomb of the range on (x, z) blasts: its own and four rays, each stopped by
+    // the border and by unbreakable blocks and ending on the first breakable block
+    template <typename Fn>
+    void forEachCellInBlast(int x, int z, int range, Fn fn) const
+    {
+        fn(grid.index(x, z));
+        for (int dir = 0; dir < 4; dir++)
+        {
+            int cx = x, cz = z;
+            for (int distance = 1; distance <= range; distance++)
+            {
+                cx += TileGrid::DX[dir];
+                cz += TileGrid::DZ[dir];
+                if (!grid.inBounds(cx, cz) || (grid.isSolid(cx, cz) && !grid.isBreakable(cx, cz)))
+                    break;
+                fn(grid.index(cx, cz));
+                if (grid.isBreakable(cx, cz))
+                    break;
+            }
+        }
+    }
+
+    // cells that turned safe or unsafe since the last call (may repeat a cell)
+    std::vector<int>& changedCells()
+    {
+        return safetyChanged;
+    }
+
+private:
+    const TileGrid& grid;
+    const BlastSystem& blasts;
+
+    std::vector<std::uint32_t> blastTicks; // tick of the next blast over each cell
+    std::vector<std::uint32_t> bombTicks;  // tick each bomb goes off, chains included; SAFE without a bomb
+    std::vector<int> safetyChanged;
+    std::uint32_t now = 0;
+    int maxRange = 0;
+
+    std::vector<std::pair<int, std::uint32_t>> worklist;
+
+    void setBlastTick(int cell, std::uint32_t tick)
+    {
+        if ((blastTicks[cell] == SAFE) != (tick == SAFE))
+            safetyChanged.push_back(cell);
+        blastTicks[cell] = tick;
+    }
+
+    // the bomb on the cell goes off at the tick (if that is earlier); spreads the blast and
+    // the earlier time to every bomb it reaches. force recasts the rays even if the time holds
+    void setOff(int cell, std::uint32_t tick, bool force)
+    {
+        worklist.clear();
+        if (tick < bombTicks[cell] || force)
+        {
+            bombTicks[cell] = std::min(bombTicks[cell], tick);
+            worklist.push_back({ cell, bombTicks[cell] });
+        }
+        for (std::size_t next = 0; next < worklist.size(); next++)
+        {
+            int bombCell = worklist[next].first;
+            std::uint32_t bombTick = worklist[next].second;
+            if (bombTick != bombTicks[bombCell])
+                continue; // reached again since by an earlier blast
+            int x = bombCell % grid.width(), z = bombCell / grid.width();
+            forEachCellInBlast(x, z, blasts.range(blasts.bombAt(x, z)), [&](int covered) { cover(covered, bombTick); });
+        }
+    }
+
+    void cover(int cell, std::uint32_t tick)
+    {
+        if (tick < blastTicks[cell])
+            setBlastTick(cell, tick);
+        if (bombTicks[cell] != SAFE && tick < bombTicks[cell])
+        {
+            bombTicks[cell] = tick;
+            worklist.push_back({ cell, tick });
+        }
+    }
+
+    // every bomb whose rays reach the cell, found by walking outward from it
+    template <typename Fn>
+    void forEachBombReaching(int x, int z, Fn fn) const
+    {
+        int bomb = blasts.bombAt(x, z);
+        if (bomb != BlastSystem::NO_BOMB)
+            fn(grid.index(x, z));
+        for (int dir = 0; dir < 4; dir++)
+        {
+            int cx = x, cz = z;
+            for (int distance = 1; distance <= maxRange; distance++)
+            {
+                cx += TileGrid::DX[dir];
+                cz += TileGrid::DZ[dir];
+                if (!grid.inBounds(cx, cz) || grid.isSolid(cx, cz))
+                    break;
+                bomb = blasts.bombAt(cx, cz);
+                if (bomb != BlastSystem::NO_BOMB && blasts.range(bomb) >= distance)
+                    fn(grid.index(cx, cz));
+            }
+        }
+    }
+
+    // recompute a cell covered by this tick's blasts from the bombs left around it
+    void refresh(int x, int z)
+    {
+        int cell = grid.index(x, z);
+        if (blasts.bombAt(x, z) == BlastSystem::NO_BOMB)
+            bombTicks[cell] = SAFE;
+        std::uint32_t tick = SAFE;
+        forEachBombReaching(x, z, [&](int bombCell) { tick = std::min(tick, bombTicks[bombCell]); });
+        setBlastTick(cell, tick);
+    }
+};
+
+// what a bot does this tick
+struct BotDecision
+{
+    int direction = FlowField::NO_DIRECTION; // TileGrid::Direction to step to, or stay
+    bool placeBomb = false;                  // drop a bomb on the current cell first
+};
+
+// Navigation data shared by all AI bots of an arena: the danger map and two flow fields,
+// one toward the nearest safe cell (fleeing) and one toward the nearest cell next to a
+// breakable block (where a bomb clears the way). Walkable cells are the floor cells of the
+// grid (white cells and spawn cells) without a bomb; border and red blocks never are.
+// Everything is kept up to date incrementally from bomb placements and blast ticks, so a
+// bot's decision is a handful of lookups and its cost does not grow with the map; only
+// dropping a bomb searches, no further than the bot can walk before the fuse runs out.
+// decide() reuses scratch buffers of the object: call it from one thread at a time.
+class AINavigation
+{
+public:
+    AINavigation(const TileGrid& grid, const BlastSystem& blasts)
+        : grid(grid), blasts(blasts), danger(grid, blasts), flee(grid.width(), grid.height()),
+          attack(grid.width(), grid.height()), escapeVisited(static_cast<std::size_t>(grid.width()) * grid.height(), 0)
+    {
+        rebuild();
+    }
+
+    // recompute everything, e.g. after the map was regenerated
+    void rebuild()
+    {
+        danger.rebuild();
+        for (int z = 0; z < grid.height(); z++)
+        {
+            for (int x = 0; x < grid.width(); x++)
+            {
+                int cell = grid.index(x, z);
+                bool open = isWalkable(x, z);
+                flee.setFlags(cell, open, danger.isSafe(cell));
+                attack.setFlags(cell, open, isBombSpot(x, z));
+            }
+        }
+        flee.rebuild();
+        attack.rebuild();
+    }
+
+    // call right after a successful BlastSystem::placeBomb
+    void bombPlaced(int x, int z)
+    {
+        danger.bombPlaced(x, z);
+        int cell = grid.index(x, z);
+        flee.setWalkable(cell, false);
+        attack.setWalkable(cell, false);
+        updateSafety();
+    }
+
+    // call right after BlastSystem::tick with its result
+    void update(const BlastSystem::TickResult& result)
+    {
+        danger.tickApplied(result);
+        // detonated bombs free their cells
+        for (const BlastSystem::CellChange& change : result.blast)
+            updateCell(change.x, change.z);
+        // destroyed blocks open up, and their neighbours may stop being bomb spots
+        for (const BlastSystem::CellChange& change : result.destroyed)
+        {
+            updateCell(change.x, change.z);
+            for (int dir = 0; dir < 4; dir++)
+            {
+                int x = change.x + TileGrid::DX[dir], z = change.z + TileGrid::DZ[dir];
+                if (grid.inBounds(x, z))
+                    attack.setGoal(grid.index(x, z), isBombSpot(x, z));
+            }
+        }
+        updateSafety();
+    }
+
+    // ------------------------------------------------------------------------
+    // Decide the next move of a bot standing on (x, z) that drops bombs of the given range
+    // and fuse:
+    //  - in a blast's path: step toward the nearest safe cell, avoiding cells about to blow;
+    //  - next to a breakable block: drop a bomb, if a safe cell outside its blast can be
+    //    reached before it goes off (see canEscape);
+    //  - otherwise: walk toward the nearest breakable block without stepping into danger.
+    BotDecision decide(int x, int z, int bombRange, int fuseTicks) const
+    {
+        BotDecision decision;
+        int cell = grid.index(x, z);
+        if (!danger.isSafe(cell))
+        {
+            decision.direction = bestStep(flee, x, z, 1);
+            return decision;
+        }
+        if (attack.distance(cell) == 0 && !blasts.hasBomb(x, z))
+        {
+            decision.placeBomb = canEscape(x, z, bombRange, fuseTicks);
+            if (decision.placeBomb)
+                return decision;
+        }
+        decision.direction = bestStep(attack, x, z, DangerMap::SAFE);
+        return decision;
+    }
+
+    const DangerMap& dangerMap() const { return danger; }
+    const FlowField& fleeField() const { return flee; }
+    const FlowField& attackField() const { return attack; }
+
+    // flow field cells recomputed since the last call, both fields together
+    std::size_t takeTouchedCells()
+    {
+        return flee.takeTouchedCells() + attack.takeTouchedCells();
+    }
+
+private:
+    const TileGrid& grid;
+    const BlastSystem& blasts;
+    DangerMap danger;
+    FlowField flee;
+    FlowField attack;
+
+    // scratch of canEscape
+    mutable std::vector<std::uint32_t> escapeVisited;
+    mutable std::vector<std::pair<int, std::uint32_t>> escapeFrontier; // cell, ticks to reach it
+    mutable std::vector<int> escapeBlast;
+    mutable std::uint32_t escapeStamp = 0;
+
+    bool isWalkable(int x, int z) const
+    {
+        return !grid.isSolid(x, z) && !blasts.hasBomb(x, z);
+    }
+
+    bool isBombSpot(int x, int z) const
+    {
+        if (grid.isSolid(x, z))
+            return false;
+        for (int dir = 0; dir < 4; dir++)
+        {
+            int nx = x + TileGrid::DX[dir], nz = z + TileGrid::DZ[dir];
+            if (grid.inBounds(nx, nz) && grid.isBreakable(nx, nz))
+                return true;
+        }
+        return false;
+    }
+
+    void updateCell(int x, int z)
+    {
+        int cell = grid.index(x, z);
+        bool open = isWalkable(x, z);
+        flee.setWalkable(cell, open);
+        attack.setWalkable(cell, open);
+        attack.setGoal(cell, isBombSpot(x, z));
+    }
+
+    void updateSafety()
+    {
+        std::vector<int>& changed = danger.changedCells();
+        for (int cell : changed)
+            flee.setGoal(cell, danger.isSafe(cell));
+        changed.clear();
+    }
+
+    // the walkable neighbour closest to the field's goal whose blast is more than minTicks
+    // away (SAFE: no blast at all); staying put when none is closer than the current cell
+    int bestStep(const FlowField& field, int x, int z, std::uint32_t minTicks) const
+    {
+        std::uint32_t best = field.distance(grid.index(x, z));
+        int result = FlowField::NO_DIRECTION;
+        for (int dir = 0; dir < 4; dir++)
+        {
+            int nx = x + TileGrid::DX[dir], nz = z + TileGrid::DZ[dir];
+            if (!grid.inBounds(nx, nz))
+                continue;
+            int neighbour = grid.index(nx, nz);
+            if (!field.isWalkable(neighbour) || field.distance(neighbour) >= best)
+                continue;
+            std::uint32_t ticks = danger.ticksUntilBlast(nx, nz);
+            if (minTicks == DangerMap::SAFE ? ticks != DangerMap::SAFE : ticks <= minTicks)
+                continue;
+            best = field.distance(neighbour);
+            result = dir;
+        }
+        return result;
+    }
+
+    // whether a bot on (x, z) that drops a bomb of the range and fuse there can walk, one
+    // cell per tick, to a cell that is neither in the bomb's blast nor in any other, without
+    // standing on a cell when its blast goes off. The new blast may set off other bombs
+    // early, so a pending blast on the way counts as going off with it at the latest.
+    bool canEscape(int x, int z, int range, int fuseTicks) const
+    {
+        if (++escapeStamp == 0)
+        {
+            std::fill(escapeVisited.begin(), escapeVisited.end(), 0);
+            escapeStamp = 1;
+        }
+        std::uint32_t fuse = static_cast<std::uint32_t>(std::max(fuseTicks, 0));
+        escapeBlast.clear();
+        danger.forEachCellInBlast(x, z, range, [&](int cell) { escapeBlast.push_back(cell); });
+
+        // the bot's cell holds the bomb from now on
+        escapeFrontier.clear();
+        escapeFrontier.push_back({ grid.index(x, z), 0 });
+        escapeVisited[grid.index(x, z)] = escapeStamp;
+        for (std::size_t next = 0; next < escapeFrontier.size(); next++)
+        {
+            int cell = escapeFrontier[next].first;
+            std::uint32_t arrival = escapeFrontier[next].second + 1;
+            if (arrival > fuse)
+                continue; // too late for every cell the blasts reach
+            int cx = cell % grid.width(), cz = cell / grid.width();
+            for (int dir = 0; dir < 4; dir++)
+            {
+                int nx = cx + TileGrid::DX[dir], nz = cz + TileGrid::DZ[dir];
+                if (!grid.inBounds(nx, nz) || !isWalkable(nx, nz))
+                    continue;
+                int neighbour = grid.index(nx, nz);
+                if (escapeVisited[neighbour] == escapeStamp)
+                    continue;
+                bool inBlast = std::find(escapeBlast.begin(), escapeBlast.end(), neighbour) != escapeBlast.end();
+                if (!inBlast && danger.isSafe(neighbour))
+                    return true;
+                if (std::min(danger.ticksUntilBlast(nx, nz), fuse) <= arrival)
+                    continue;
+                escapeVisited[neighbour] = escapeStamp;
+                escapeFrontier.push_back({ neighbour, arrival });
+            }
+        }
+        return false;
+    }
+};
+
+#endif
@@ -0,0 +1,248 @@
+#ifndef ANIMATION_SYSTEM_H
+#define ANIMATION_SYSTEM_H
+
+#include <learnopengl/animator.h>
+
+#include "job_system.h"
+#include "pose_cache.h"
+#include "profiler.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+// Animation level of detail. A character picks the first level whose maxDistance covers its
+// distance to the camera (the last level otherwise), or offScreen when it is not visible.
+struct AnimationLodPolicy
+{
+    struct Level
+    {
+        float maxDistance = std::numeric_limits<float>::max();
+        int updateInterval = 1; // re-evaluate every n-th frame, keep the palette in between
+        int skipLeafLevels = 0; // leave the lowest n levels of the hierarchy in bind pose
+    };
+
+    std::vector<Level> levels = { Level() };
+    Level offScreen;
+    // pose cache grid in clip ticks; 0 evaluates every character at its exact time
+    float poseQuantum = 0.0f;
+
+    const Level& select(float distance, bool onScreen) const
+    {
+        if (!onScreen)
+            return offScreen;
+        for (const Level& level : levels)
+        {
+            if (distance <= level.maxDistance)
+                return level;
+        }
+        return levels.back();
+    }
+};
+
+// counters of the last update(), for tuning the LOD policy under load
+struct AnimationStats
+{
+    std::size_t characters = 0;
+    std::size_t palettesEvaluated = 0; // own evaluations plus pose cache misses
+    std::size_t cacheHits = 0;
+    std::size_t cacheMisses = 0;
+    std::size_t skippedUpdates = 0;    // characters that kept last frame's palette
+    std::size_t bonesEvaluated = 0;    // channels sampled over all evaluations
+    std::size_t cachedPoses = 0;
+
+    double cacheHitRate() const
+    {
+        std::size_t lookups = cacheHits + cacheMisses;
+        return lookups == 0 ? 0.0 : static_cast<double>(cacheHits) / lookups;
+    }
+};
+
+// Updates every registered Animator once per frame on the job system and writes all bone
+// palettes into one contiguous buffer, Animator::MAX_BONES matrices per character in
+// registration order, ready to be uploaded in a single buffer update.
+//
+// update() decides serially, in slot order, which character evaluates which palette (its own
+// slice or a pose cache entry), evaluates all of them in parallel and then copies cache
+// entries into the slices of the characters sharing them. Every evaluation only touches its
+// own animator and destination, so the palette is bit-identical for any worker count.
+class AnimationSystem
+{
+public:
+    // characters per job; small enough to balance, large enough to amortise the job overhead
+    static constexpr std::size_t CHARACTERS_PER_JOB = 8;
+    static constexpr std::size_t PALETTE_STRIDE = Animator::MAX_BONES;
+
+    explicit AnimationSystem(JobSystem& jobs)
+        : jobs(jobs), poseCache(PALETTE_STRIDE)
+    {
+    }
+
+    // the animator must outlive the system or be removed by clear(); returns its slot
+    std::size_t add(Animator* animator)
+    {
+        characters.push_back(Character{ animator });
+        palette.resize(characters.size() * PALETTE_STRIDE, glm::mat4(1.0f));
+        evaluations.reserve(characters.size());
+        copies.reserve(characters.size());
+        return characters.size() - 1;
+    }
+
+    void clear()
+    {
+        characters.clear();
+        palette.clear();
+        poseCache.clear();
+    }
+
+    std::size_t size() const
+    {
+        return characters.size();
+    }
+
+    void setLodPolicy(const AnimationLodPolicy& policy)
+    {
+        this->policy = policy;
+        poseCache.clear();
+    }
+
+    const AnimationLodPolicy& lodPolicy() const
+    {
+        return policy;
+    }
+
+    // where a character is relative to the camera this frame; characters default to on screen
+    // at distance 0, i.e. the first LOD level
+    void setLodInput(std::size_t slot, float distanceToCamera, bool onScreen)
+    {
+        characters[slot].distance = distanceToCamera;
+        characters[slot].onScreen = onScreen;
+    }
+
+    void update(float dt)
+    {
+        PROFILE_ZONE("AnimationSystem::update");
+        frame++;
+        lastStats = AnimationStats();
+        lastStats.characters = characters.size();
+        evaluations.clear();
+        copies.clear();
+
+        for (std::size_t i = 0; i < characters.size(); i++)
+        {
+            Character& character = characters[i];
+            Animator& animator = *character.animator;
+            if (!animator.HasAnimation())
+                continue;
+            animator.AdvanceTime(dt);
+
+            const AnimationLodPolicy::Level& level = policy.select(character.distance, character.onScreen);
+            int interval = std::max(1, level.updateInterval);
+            // staggered by slot, so a crowd at one level does not update all in the same frame
+            if (character.evaluated && (frame + i) % interval != 0)
+            {
+                lastStats.skippedUpdates++;
+                continue;
+            }
+            character.evaluated = true;
+
+            glm::mat4* destination = &palette[i * PALETTE_STRIDE];
+            if (policy.poseQuantum <= 0.0f)
+            {
+                evaluations.push_back(Evaluation{ &animator, animator.GetCurrentTime(), destination, level.skipLeafLevels, 0 });
+                continue;
+            }
+            bool miss;
+            float quantisedTime;
+            PoseCache::Entry& entry = poseCache.acquire(animator.GetCurrentAnimation(), animator.GetCurrentTime(),
+                policy.poseQuantum, level.skipLeafLevels, frame, miss, quantisedTime);
+            if (miss)
+            {
+                evaluations.push_back(Evaluation{ &animator, quantisedTime, entry.palette.data(), level.skipLeafLevels, 0 });
+                lastStats.cacheMisses++;
+            }
+            else
+            {
+                lastStats.cacheHits++;
+            }
+            copies.push_back(Copy{ entry.palette.data(), destination });
+        }
+        poseCache.evictUnused(frame);
+
+        jobs.parallelFor(evaluations.size(), CHARACTERS_PER_JOB, [this](std::size_t begin, std::size_t end) {
+            PROFILE_ZONE("evaluate poses");
+            for (std::size_t i = begin; i < end; i++)
+            {
+                Evaluation& evaluation = evaluations[i];
+                evaluation.bones = evaluation.animator->EvaluatePoseAt(evaluation.time, evaluation.destination,
+                    PALETTE_STRIDE, evaluation.skipLeafLevels);
+            }
+        });
+        jobs.parallelFor(copies.size(), CHARACTERS_PER_JOB * 4, [this](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; i++)
+                std::memcpy(copies[i].destination, copies[i].source, PALETTE_STRIDE * sizeof(glm::mat4));
+        });
+
+        lastStats.palettesEvaluated = evaluations.size();
+        for (const Evaluation& evaluation : evaluations)
+            lastStats.bonesEvaluated += evaluation.bones;
+        lastStats.cachedPoses = poseCache.size();
+        PROFILE_COUNT("bones evaluated", lastStats.bonesEvaluated);
+    }
+
+    const AnimationStats& stats() const
+    {
+        return lastStats;
+    }
+
+    // all palettes, size() * PALETTE_STRIDE matrices
+    const glm::mat4* palettes() const
+    {
+        return palette.data();
+    }
+
+    const glm::mat4* paletteOf(std::size_t slot) const
+    {
+        return &palette[slot * PALETTE_STRIDE];
+    }
+
+private:
+    struct Character
+    {
+        Animator* animator;
+        float distance = 0.0f;
+        bool onScreen = true;
+        bool evaluated = false; // has a palette to keep when its LOD skips a frame
+    };
+
+    struct Evaluation
+    {
+        Animator* animator;
+        float time;
+        glm::mat4* destination;
+        int skipLeafLevels;
+        int bones; // channels sampled, written by the job
+    };
+
+    struct Copy
+    {
+        const glm::mat4* source;
+        glm::mat4* destination;
+    };
+
+    JobSystem& jobs;
+    std::vector<Character> characters;
+    std::vector<glm::mat4> palette;
+    AnimationLodPolicy policy;
+    PoseCache poseCache;
+    AnimationStats lastStats;
+    uint64_t frame = 0;
+    // per-frame work lists, kept to avoid reallocating every frame
+    std::vector<Evaluation> evaluations;
+    std::vector<Copy> copies;
+};
+
+#endif
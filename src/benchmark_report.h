@@ -0,0 +1,195 @@
+#ifndef BENCHMARK_REPORT_H
+#define BENCHMARK_REPORT_H
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+// Measures GPU time per frame with GL_TIME_ELAPSED queries. Queries are kept in a small
+// ring and read back a few frames later, so collecting results never stalls the pipeline.
+class GpuFrameTimer
+{
+public:
+    static constexpr unsigned int QUERY_COUNT = 4;
+
+    GpuFrameTimer()
+    {
+        glGenQueries(QUERY_COUNT, queries);
+    }
+
+    void release()
+    {
+        glDeleteQueries(QUERY_COUNT, queries);
+    }
+
+    // wrap all GL work of one frame between begin() and end()
+    // ------------------------------------------------------------------------
+    void begin()
+    {
+        // the slot is about to be reused: collect its result first
+        if (issued >= QUERY_COUNT)
+            collect(queries[issued % QUERY_COUNT]);
+        glBeginQuery(GL_TIME_ELAPSED, queries[issued % QUERY_COUNT]);
+    }
+
+    void end()
+    {
+        glEndQuery(GL_TIME_ELAPSED);
+        issued++;
+    }
+
+    // read back every outstanding query; returns GPU milliseconds in frame order
+    // ------------------------------------------------------------------------
+    const std::vector<double>& finish()
+    {
+        for (std::size_t frame = results.size(); frame < issued; frame++)
+            collect(queries[frame % QUERY_COUNT]);
+        return results;
+    }
+
+private:
+    unsigned int queries[QUERY_COUNT];
+    std::size_t issued = 0;
+    std::vector<double> results;
+
+    void collect(unsigned int query)
+    {
+        GLuint64 elapsedNs = 0;
+        glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsedNs);
+        results.push_back(static_cast<double>(elapsedNs) / 1.0e6);
+    }
+};
+
+// Per-frame samples of a headless run, written out as a JSON report.
+class BenchmarkReport
+{
+public:
+    struct Frame
+    {
+        double cpuMs;
+        double gpuMs;
+        unsigned int drawCalls;
+        unsigned int triangles;
+        // render queue: commands submitted, GL state calls issued and skipped by the state cache
+        unsigned int submitted;
+        unsigned int stateChanges;
+        unsigned int elidedStateChanges;
+    };
+
+    std::string renderer;
+    std::string version;
+    unsigned int seed = 0;
+    int width = 0;
+    int height = 0;
+    std::vector<Frame> frames;
+
+    // startup milestones in ms since main() started (-1 if not reached)
+    double timeToFirstFrameMs = -1.0;
+    double textureLoadMs = -1.0;
+    unsigned int textureThreads = 0;
+    unsigned int bakedTextures = 0;
+    double shaderBuildMs = 0.0;
+    unsigned int shaderPrograms = 0;
+    unsigned int shaderCacheHits = 0; // programs created from the binary cache
+
+    // map geometry: size in cells, chunks and triangles of all chunks (before culling)
+    int mapSize = 0;
+    int mapChunks = 0;
+    std::size_t mapTriangles = 0;
+
+    // nearest-rank percentile (p in [0, 100])
+    static double percentile(std::vector<double> values, double p)
+    {
+        if (values.empty())
+            return 0.0;
+        std::sort(values.begin(), values.end());
+        std::size_t rank = static_cast<std::size_t>(p / 100.0 * values.size() + 0.5);
+        rank = std::min(std::max<std::size_t>(rank, 1), values.size());
+        return values[rank - 1];
+    }
+
+    bool write(const std::string& path) const
+    {
+        std::ofstream file(path);
+        if (!file)
+            return false;
+
+        std::vector<double> cpu, gpu;
+        unsigned long long totalDrawCalls = 0, totalTriangles = 0, totalSubmitted = 0, totalStateChanges = 0, totalElided = 0;
+        for (const Frame& frame : frames)
+        {
+            cpu.push_back(frame.cpuMs);
+            gpu.push_back(frame.gpuMs);
+            totalDrawCalls += frame.drawCalls;
+            totalTriangles += frame.triangles;
+            totalSubmitted += frame.submitted;
+            totalStateChanges += frame.stateChanges;
+            totalElided += frame.elidedStateChanges;
+        }
+        double frameCount = frames.empty() ? 1.0 : static_cast<double>(frames.size());
+
+        file << std::fixed << std::setprecision(4);
+        file << "{\n";
+        file << "  \"renderer\": \"" << escape(renderer) << "\",\n";
+        file << "  \"version\": \"" << escape(version) << "\",\n";
+        file << "  \"seed\": " << seed << ",\n";
+        file << "  \"resolution\": [" << width << ", " << height << "],\n";
+        file << "  \"startup\": { \"time_to_first_frame_ms\": " << timeToFirstFrameMs
+             << ", \"texture_load_ms\": " << textureLoadMs
+             << ", \"texture_threads\": " << textureThreads
+             << ", \"baked_textures\": " << bakedTextures
+             << ", \"shader_build_ms\": " << shaderBuildMs
+             << ", \"shader_programs\": " << shaderPrograms
+             << ", \"shader_cache_hits\": " << shaderCacheHits << " },\n";
+        file << "  \"map\": { \"size\": " << mapSize << ", \"chunks\": " << mapChunks << ", \"triangles\": " << mapTriangles << " },\n";
+        file << "  \"frame_count\": " << frames.size() << ",\n";
+        writeSummary(file, "cpu_ms", cpu);
+        writeSummary(file, "gpu_ms", gpu);
+        file << "  \"draw_calls\": { \"total\": " << totalDrawCalls << ", \"per_frame\": " << totalDrawCalls / frameCount << " },\n";
+        file << "  \"triangles_per_frame\": " << totalTriangles / frameCount << ",\n";
+        file << "  \"render_queue\": { \"submitted_per_frame\": " << totalSubmitted / frameCount
+             << ", \"state_changes_per_frame\": " << totalStateChanges / frameCount
+             << ", \"elided_state_changes_per_frame\": " << totalElided / frameCount << " },\n";
+        file << "  \"frames\": [\n";
+        for (std::size_t i = 0; i < frames.size(); i++)
+        {
+            file << "    { \"cpu_ms\": " << frames[i].cpuMs << ", \"gpu_ms\": " << frames[i].gpuMs
+                 << ", \"draw_calls\": " << frames[i].drawCalls << ", \"triangles\": " << frames[i].triangles << ", \"state_changes\": " << frames[i].stateChanges
+                 << ", \"elided_state_changes\": " << frames[i].elidedStateChanges << " }" << (i + 1 < frames.size() ? "," : "") << "\n";
+        }
+        file << "  ]\n";
+        file << "}\n";
+        return static_cast<bool>(file);
+    }
+
+private:
+    static void writeSummary(std::ofstream& file, const char* name, const std::vector<double>& values)
+    {
+        double sum = 0.0;
+        for (double value : values)
+            sum += value;
+        file << "  \"" << name << "\": { \"mean\": " << (values.empty() ? 0.0 : sum / values.size())
+             << ", \"p50\": " << percentile(values, 50.0)
+             << ", \"p95\": " << percentile(values, 95.0)
+             << ", \"p99\": " << percentile(values, 99.0) << " },\n";
+    }
+
+    static std::string escape(const std::string& text)
+    {
+        std::string escaped;
+        for (char c : text)
+        {
+            if (c == '"' || c == '\\')
+                escaped += '\\';
+            escaped += c;
+        }
+        return escaped;
+    }
+};
+
+#endif
@@ -0,0 +1,222 @@
+#ifndef BLAST_SYSTEM_H
+#define BLAST_SYSTEM_H
+
+#include "tile_grid.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Bombs on the map grid and the blasts they cause. Bombs are kept as parallel arrays (cell,
+// range, fuse) plus a per-cell index of the bomb lying there, so a tick is one pass over the
+// fuses followed by a single pass over the blasts:
+//  - every bomb whose fuse ran out goes onto a work list;
+//  - each bomb on the list casts its four rays up to its range; a ray stops at border and
+//    red blocks, and at the first breakable block, which it destroys;
+//  - a ray reaching another bomb puts that bomb on the list as well (chain reaction) and
+//    carries on, so a whole chain resolves within the tick.
+// Every cell is touched at most once per ray, so the pass costs O(cells affected). Per-cell
+// stamps deduplicate cells hit by several rays without clearing anything between ticks.
+// Destroyed blocks are removed from the grid at the end of the tick (two rays hitting the
+// same block both stop at it) and reported as a compact change list for the renderer.
+class BlastSystem
+{
+public:
+    static constexpr int NO_BOMB = -1;
+
+    struct CellChange
+    {
+        std::uint16_t x;
+        std::uint16_t z;
+    };
+
+    // what happened during one tick
+    struct TickResult
+    {
+        std::vector<CellChange> destroyed; // breakable blocks turned into floor, each once
+        std::vector<CellChange> blast;     // other cells covered by a blast, each once
+        unsigned int detonated = 0;        // bombs that went off, chains included
+
+        void clear()
+        {
+            destroyed.clear();
+            blast.clear();
+            detonated = 0;
+        }
+    };
+
+    explicit BlastSystem(TileGrid& grid)
+        : grid(grid), cellBomb(static_cast<std::size_t>(grid.width()) * grid.height(), NO_BOMB),
+          cellStamp(cellBomb.size(), 0)
+    {
+    }
+
+    // drop a bomb on a free floor cell; false if the cell is solid, taken or out of the map
+    bool placeBomb(int x, int z, int range, int fuseTicks)
+    {
+        if (!grid.inBounds(x, z) || grid.isSolid(x, z))
+            return false;
+        std::size_t cell = static_cast<std::size_t>(grid.index(x, z));
+        if (cellBomb[cell] != NO_BOMB)
+            return false;
+        cellBomb[cell] = static_cast<int>(bombCell.size());
+        bombCell.push_back(static_cast<std::uint32_t>(cell));
+        bombRange.push_back(static_cast<std::uint16_t>(std::max(0, range)));
+        bombFuse.push_back(std::max(1, fuseTicks));
+        return true;
+    }
+
+    bool hasBomb(int x, int z) const
+    {
+        return grid.inBounds(x, z) && cellBomb[grid.index(x, z)] != NO_BOMB;
+    }
+
+    std::size_t bombCount() const
+    {
+        return bombCell.size();
+    }
+
+    // bomb lying on a cell (NO_BOMB if none); the index is only valid until the next tick()
+    int bombAt(int x, int z) const
+    {
+        return grid.inBounds(x, z) ? cellBomb[grid.index(x, z)] : NO_BOMB;
+    }
+
+    int range(int bomb) const { return bombRange[bomb]; }
+    int fuse(int bomb) const { return bombFuse[bomb]; }
+
+    // remove every bomb (e.g. after the map was regenerated)
+    void clear()
+    {
+        for (std::uint32_t cell : bombCell)
+            cellBomb[cell] = NO_BOMB;
+        bombCell.clear();
+        bombRange.clear();
+        bombFuse.clear();
+    }
+
+    // advance all fuses by one tick and resolve the resulting blasts. The result stays valid
+    // until the next tick()
+    // ------------------------------------------------------------------------
+    const TickResult& tick()
+    {
+        result.clear();
+        if (++stamp == 0)
+        {
+            // the stamp wrapped around: old stamps could look current
+            std::fill(cellStamp.begin(), cellStamp.end(), 0);
+            stamp = 1;
+        }
+
+        worklist.clear();
+        for (std::size_t i = 0; i < bombFuse.size(); i++)
+        {
+            if (--bombFuse[i] <= 0)
+            {
+                bombFuse[i] = DETONATED;
+                worklist.push_back(static_cast<std::uint32_t>(i));
+            }
+        }
+
+        // the list grows while it is walked when blasts reach further bombs
+        for (std::size_t next = 0; next < worklist.size(); next++)
+        {
+            std::uint32_t bomb = worklist[next];
+            int cell = static_cast<int>(bombCell[bomb]);
+            int x = cell % grid.width();
+            int z = cell / grid.width();
+            hit(x, z, cell);
+            for (int dir = 0; dir < 4; dir++)
+                castRay(x, z, TileGrid::DX[dir], TileGrid::DZ[dir], bombRange[bomb]);
+        }
+        result.detonated = static_cast<unsigned int>(worklist.size());
+
+        for (const CellChange& change : result.destroyed)
+            grid.destroyBlock(change.x, change.z);
+        removeDetonated();
+        return result;
+    }
+
+private:
+    static constexpr int DETONATED = -0x7fffffff;
+
+    TileGrid& grid;
+
+    // bombs, one entry per bomb in each array
+    std::vector<std::uint32_t> bombCell;
+    std::vector<std::uint16_t> bombRange;
+    std::vector<int> bombFuse; // ticks left, DETONATED once on the work list
+
+    std::vector<int> cellBomb;            // bomb lying on each cell or NO_BOMB
+    std::vector<std::uint32_t> cellStamp; // tick stamp of the last blast over each cell
+    std::uint32_t stamp = 0;
+
+    std::vector<std::uint32_t> worklist;
+    TickResult result;
+
+    void castRay(int x, int z, int dx, int dz, int range)
+    {
+        int step = dz * grid.width() + dx;
+        int cell = grid.index(x, z);
+        for (int distance = 1; distance <= range; distance++)
+        {
+            x += dx;
+            z += dz;
+            cell += step;
+            if (!grid.inBounds(x, z))
+                return;
+            if (grid.isSolid(x, z))
+            {
+                // the first breakable block in the way is destroyed, fixed blocks just stop the ray
+                if (grid.isBreakable(x, z))
+                    hit(x, z, cell);
+                return;
+            }
+            hit(x, z, cell);
+        }
+    }
+
+    // the blast reaches a cell: record it once per tick and set off the bomb lying there
+    void hit(int x, int z, int cell)
+    {
+        int bomb = cellBomb[cell];
+        if (bomb != NO_BOMB && bombFuse[bomb] != DETONATED)
+        {
+            bombFuse[bomb] = DETONATED;
+            worklist.push_back(static_cast<std::uint32_t>(bomb));
+        }
+        if (cellStamp[cell] == stamp)
+            return;
+        cellStamp[cell] = stamp;
+        CellChange change = { static_cast<std::uint16_t>(x), static_cast<std::uint16_t>(z) };
+        if (grid.isBreakable(x, z))
+            result.destroyed.push_back(change);
+        else
+            result.blast.push_back(change);
+    }
+
+    // swap-remove the detonated bombs, highest index first so pending indices stay valid
+    void removeDetonated()
+    {
+        std::sort(worklist.begin(), worklist.end());
+        for (std::size_t i = worklist.size(); i-- > 0;)
+        {
+            std::uint32_t bomb = worklist[i];
+            std::uint32_t last = static_cast<std::uint32_t>(bombCell.size() - 1);
+            cellBomb[bombCell[bomb]] = NO_BOMB;
+            if (bomb != last)
+            {
+                bombCell[bomb] = bombCell[last];
+                bombRange[bomb] = bombRange[last];
+                bombFuse[bomb] = bombFuse[last];
+                cellBomb[bombCell[bomb]] = static_cast<int>(bomb);
+            }
+            bombCell.pop_back();
+            bombRange.pop_back();
+            bombFuse.pop_back();
+        }
+    }
+};
+
+#endif
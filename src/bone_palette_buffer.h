@@ -0,0 +1,205 @@
+#ifndef BONE_PALETTE_BUFFER_H
+#define BONE_PALETTE_BUFFER_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "profiler.h"
+#include "render_queue.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+
+// Bone palettes of all skinned characters, streamed to the GPU once per frame through one
+// buffer texture instead of Animator::MAX_BONES matrix uniforms per draw. The buffer is split
+// into FRAMES_IN_FLIGHT regions used round robin:
+//
+//     | frame n (written by the CPU) | frame n-1 (read by the GPU) | frame n-2 (read by the GPU) |
+//
+// beginFrame() fences the region of the previous frame, so the fence signals once the GPU
+// has executed every draw reading it, then moves on to the oldest region and waits for its
+// fence. With the GPU less than FRAMES_IN_FLIGHT - 1 frames behind the fence has long
+// signalled and the wait costs one query; the region is then mapped unsynchronized, so the
+// driver neither stalls nor copies the buffer.
+//
+// Per frame:
+//
+//     palettes.beginFrame();
+//     GLint offset = palettes.write(animationSystem.paletteOf(slot), boneCount); // per character
+//     palettes.finish();              // before the first draw reading the palettes
+//     palettes.bind(stateCache);
+//     command.paletteLocation = offsetUniform; command.paletteOffset = offset;  // per draw
+//
+// The SKINNED variant of shaders/model.vs reads matrix paletteOffset + boneId from the
+// samplerBuffer SAMPLER_NAME, which has to point at TEXTURE_UNIT.
+class BonePaletteBuffer
+{
+public:
+    static constexpr unsigned int FRAMES_IN_FLIGHT = 3;
+    // the last unit GLStateCache tracks, above the ones materials use
+    static constexpr unsigned int TEXTURE_UNIT = GLStateCache::TEXTURE_UNITS - 1;
+    static constexpr const char* SAMPLER_NAME = "bonePalette";
+    static constexpr const char* OFFSET_NAME = "paletteOffset";
+
+    // counts of the frame since the last beginFrame()
+    struct Stats
+    {
+        std::size_t matrices = 0; // written this frame
+        unsigned int glCalls = 0; // issued by the buffer, bind() included
+        unsigned int stalls = 0;  // fences that had not signalled yet
+        double waitMs = 0.0;      // CPU time blocked on them
+    };
+
+    // room for matricesPerFrame matrices in every region, clamped to GL_MAX_TEXTURE_BUFFER_SIZE
+    // (capacity() tells what was granted)
+    explicit BonePaletteBuffer(std::size_t matricesPerFrame)
+    {
+        GLint maxTexels = 0;
+        glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &maxTexels);
+        std::size_t limit = static_cast<std::size_t>(maxTexels) / 4 / FRAMES_IN_FLIGHT;
+        regionCapacity = std::max<std::size_t>(1, std::min(matricesPerFrame, limit));
+
+        glGenBuffers(1, &buffer);
+        glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+        glBufferData(GL_TEXTURE_BUFFER, regionCapacity * FRAMES_IN_FLIGHT * sizeof(glm::mat4), NULL, GL_STREAM_DRAW);
+        glBindBuffer(GL_TEXTURE_BUFFER, 0);
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_BUFFER, texture);
+        glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, buffer);
+        glBindTexture(GL_TEXTURE_BUFFER, 0);
+    }
+
+    BonePaletteBuffer(const BonePaletteBuffer&) = delete;
+    BonePaletteBuffer& operator=(const BonePaletteBuffer&) = delete;
+
+    // de-allocate the buffer and its fences; must be called while the context is still current
+    void release()
+    {
+        if (mapped != nullptr)
+            finish();
+        for (GLsync& fence : fences)
+        {
+            if (fence != nullptr)
+                glDeleteSync(fence);
+            fence = nullptr;
+        }
+        glDeleteTextures(1, &texture);
+        glDeleteBuffers(1, &buffer);
+        texture = buffer = 0;
+    }
+
+    // matrices one frame can hold
+    std::size_t capacity() const
+    {
+        return regionCapacity;
+    }
+
+    // start the palettes of a new frame in the next region of the ring
+    // ------------------------------------------------------------------------
+    void beginFrame()
+    {
+        if (mapped != nullptr)
+            finish();
+        frameStats = Stats();
+        if (started)
+        {
+            fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            frameStats.glCalls++;
+            region = (region + 1) % FRAMES_IN_FLIGHT;
+        }
+        started = true;
+        waitForRegion();
+
+        used = 0;
+        glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+        void* pointer = glMapBufferRange(GL_TEXTURE_BUFFER, region * regionCapacity * sizeof(glm::mat4), regionCapacity * sizeof(glm::mat4),
+            GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_FLUSH_EXPLICIT_BIT);
+        glBindBuffer(GL_TEXTURE_BUFFER, 0);
+        frameStats.glCalls += 3;
+        mapped = static_cast<glm::mat4*>(pointer);
+    }
+
+    // copy count matrices into this frame's region; returns the offset of the first one for
+    // the paletteOffset uniform, or -1 when the frame is full, its region could not be mapped
+    // or outside beginFrame/finish
+    GLint write(const glm::mat4* palette, std::size_t count)
+    {
+        if (mapped == nullptr || used + count > regionCapacity)
+            return -1;
+        std::memcpy(mapped + used, palette, count * sizeof(glm::mat4));
+        GLint offset = static_cast<GLint>(region * regionCapacity + used);
+        used += count;
+        frameStats.matrices += count;
+        return offset;
+    }
+
+    // hand this frame's palettes to GL; call after the last write() and before the first
+    // draw reading them
+    void finish()
+    {
+        if (mapped == nullptr)
+            return;
+        glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+        if (used > 0)
+        {
+            glFlushMappedBufferRange(GL_TEXTURE_BUFFER, 0, used * sizeof(glm::mat4));
+            frameStats.glCalls++;
+            PROFILE_COUNT("bytes uploaded", used * sizeof(glm::mat4));
+        }
+        glUnmapBuffer(GL_TEXTURE_BUFFER);
+        glBindBuffer(GL_TEXTURE_BUFFER, 0);
+        frameStats.glCalls += 3;
+        mapped = nullptr;
+    }
+
+    // bind the buffer texture to TEXTURE_UNIT
+    void bind(GLStateCache& state)
+    {
+        state.bindTexture(TEXTURE_UNIT, GL_TEXTURE_BUFFER, texture);
+        frameStats.glCalls += 2; // at most: glActiveTexture and glBindTexture
+    }
+
+    const Stats& stats() const
+    {
+        return frameStats;
+    }
+
+private:
+    unsigned int buffer = 0;
+    unsigned int texture = 0;
+    std::size_t regionCapacity = 0;
+    unsigned int region = 0;
+    bool started = false;
+    GLsync fences[FRAMES_IN_FLIGHT] = {};
+    glm::mat4* mapped = nullptr;
+    std::size_t used = 0; // matrices written to the current region
+    Stats frameStats;
+
+    // block until the GPU no longer reads the current region
+    void waitForRegion()
+    {
+        GLsync& fence = fences[region];
+        if (fence == nullptr)
+            return;
+        GLenum result = glClientWaitSync(fence, 0, 0);
+        frameStats.glCalls++;
+        if (result == GL_TIMEOUT_EXPIRED)
+        {
+            frameStats.stalls++;
+            auto start = std::chrono::steady_clock::now();
+            do
+            {
+                result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000); // 1 ms
+                frameStats.glCalls++;
+            } while (result == GL_TIMEOUT_EXPIRED);
+            frameStats.waitMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+        glDeleteSync(fence);
+        frameStats.glCalls++;
+        fence = nullptr;
+    }
+};
+
+#endif
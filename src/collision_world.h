@@ -0,0 +1,615 @@
+#ifndef COLLISION_WORLD_H
+#define COLLISION_WORLD_H
+
+#include "blast_system.h"
+#include "profiler.h"
+#include "tile_grid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Collision and spatial queries of the moving things on the map (players, pickups, ...) in
+// fixed point: positions are integer units, UNITS_PER_CELL to a map cell, cell (x, z)
+// covering [x * UNITS_PER_CELL, (x + 1) * UNITS_PER_CELL) on each axis. Like the rest of the
+// simulation, movement involves no floating point, so a tick resolves bit for bit the same
+// everywhere. In world space a position is MapLayout::originX + (x / UNITS_PER_CELL - 0.5) *
+// tileSize, the same for z.
+//
+// Static obstacles are not stored: the cells a box sweeps over are looked up in the grid's
+// solid layer (LAYER_BLOCK) and the blast system's per-cell bomb index (LAYER_BOMB). A bomb
+// does not block a body that overlapped its cell at the start of the tick, so a player can
+// walk off the bomb it just dropped.
+//
+// Bodies are axis-aligned boxes kept in one dense array. Each tick they are bucketed into a
+// spatial hash of map cells: a counting sort writes the body indices of all buckets into one
+// contiguous array, so building is two linear passes and a lookup reads one short run of
+// indices. resolve() then moves every body in order, first along x, then along z, stopping
+// each axis at the first block, bomb or blocking body in the way (sliding along walls comes
+// from the split). A body is inserted with its box swept over the whole tick, so the buckets
+// stay valid while earlier bodies move, and later bodies see where earlier ones ended up.
+//
+//     CollisionWorld::Body player;
+//     player.x = CollisionWorld::cellCentre(1);
+//     player.z = CollisionWorld::cellCentre(1);
+//     player.halfX = player.halfZ = 100;
+//     player.layer = CollisionWorld::LAYER_PLAYER;
+//     player.blockMask = CollisionWorld::LAYER_BLOCK | CollisionWorld::LAYER_BOMB;
+//     player.touchMask = CollisionWorld::LAYER_PICKUP;
+//     int id = world.add(player);
+//     world.setMove(id, 24, 0);                  // per tick
+//     for (const CollisionWorld::Contact& contact : world.resolve()) ...
+class CollisionWorld
+{
+public:
+    static constexpr int CELL_SHIFT = 8;
+    static constexpr std::int32_t UNITS_PER_CELL = 1 << CELL_SHIFT;
+    static constexpr int NO_BODY = -1;
+
+    // what a body is (layer) and what it runs into (Body::blockMask, Body::touchMask)
+    enum Layer : std::uint8_t
+    {
+        LAYER_BLOCK = 1 << 0,  // solid cells of the grid, and everything outside it
+        LAYER_BOMB = 1 << 1,   // cells with a bomb on them
+        LAYER_PLAYER = 1 << 2,
+        LAYER_PICKUP = 1 << 3,
+        LAYER_ALL = 0xff
+    };
+
+    // axes a body was stopped on during the last resolve() (blocked())
+    enum Blocked : std::uint8_t
+    {
+        BLOCKED_X = 1 << 0,
+        BLOCKED_Z = 1 << 1
+    };
+
+    struct Body
+    {
+        std::int32_t x = 0;     // centre, in units
+        std::int32_t z = 0;
+        std::int32_t halfX = UNITS_PER_CELL / 2 - 1;
+        std::int32_t halfZ = UNITS_PER_CELL / 2 - 1;
+        std::uint8_t layer = LAYER_PLAYER; // a single bit; cell layers are not bodies
+        std::uint8_t blockMask = LAYER_BLOCK; // layers that stop its movement (outside the map always does)
+        std::uint8_t touchMask = 0;           // layers of the bodies it reports contacts with
+    };
+
+    // a body touching or overlapping another whose layer is in its touchMask, reported once
+    // per pair and tick
+    struct Contact
+    {
+        int body;  // whose touchMask matched
+        int other;
+    };
+
+    struct RayHit
+    {
+        float distance = 0.0f;     // units from the origin
+        int body = NO_BODY;        // NO_BODY when a cell was hit
+        int cellX = 0;             // the cell hit or containing the hit point
+        int cellZ = 0;
+        std::uint8_t layer = 0;    // LAYER_BLOCK, LAYER_BOMB or the body's layer
+    };
+
+    // counts of the last resolve()
+    struct Stats
+    {
+        std::size_t bodies = 0;
+        std::size_t hashEntries = 0;   // (body, cell) pairs in the buckets
+        std::size_t pairTests = 0;     // body pairs tested after the broadphase
+        std::size_t contacts = 0;
+    };
+
+    // bombs may be null, then LAYER_BOMB never blocks
+    explicit CollisionWorld(const TileGrid& grid, const BlastSystem* bombs = nullptr)
+        : grid(grid), bombs(bombs)
+    {
+    }
+
+    static std::int32_t cellCentre(int cell)
+    {
+        return cell * UNITS_PER_CELL + UNITS_PER_CELL / 2;
+    }
+
+    static int cellOf(std::int32_t units)
+    {
+        return units >> CELL_SHIFT; // arithmetic shift: floor division, also below 0
+    }
+
+    // bodies
+    // ------------------------------------------------------------------------
+    // returns an id that stays valid until remove()
+    int add(const Body& body)
+    {
+        int id;
+        if (!freeIds.empty())
+        {
+            id = freeIds.back();
+            freeIds.pop_back();
+        }
+        else
+        {
+            id = static_cast<int>(slots.size());
+            slots.push_back(NO_BODY);
+        }
+        slots[id] = static_cast<int>(bodies.size());
+        bodies.push_back(body);
+        moves.push_back(Move());
+        blockedAxes.push_back(0);
+        ids.push_back(id);
+        hashDirty = true;
+        return id;
+    }
+
+    // swap-remove: the last body takes the removed one's place in the dense arrays
+    void remove(int id)
+    {
+        int slot = slots[id];
+        int last = static_cast<int>(bodies.size()) - 1;
+        if (slot != last)
+        {
+            bodies[slot] = bodies[last];
+            moves[slot] = moves[last];
+            blockedAxes[slot] = blockedAxes[last];
+            ids[slot] = ids[last];
+            slots[ids[slot]] = slot;
+        }
+        bodies.pop_back();
+        moves.pop_back();
+        blockedAxes.pop_back();
+        ids.pop_back();
+        slots[id] = NO_BODY;
+        freeIds.push_back(id);
+        hashDirty = true;
+    }
+
+    bool contains(int id) const
+    {
+        return id >= 0 && id < static_cast<int>(slots.size()) && slots[id] != NO_BODY;
+    }
+
+    std::size_t size() const { return bodies.size(); }
+    const Body& body(int id) const { return bodies[slots[id]]; }
+
+    // teleport, without collision
+    void setPosition(int id, std::int32_t x, std::int32_t z)
+    {
+        Body& b = bodies[slots[id]];
+        b.x = x;
+        b.z = z;
+        hashDirty = true;
+    }
+
+    // displacement wanted for the next resolve(), which consumes it
+    void setMove(int id, std::int32_t dx, std::int32_t dz)
+    {
+        moves[slots[id]] = { dx, dz };
+    }
+
+    // Blocked mask of the last resolve()
+    std::uint8_t blocked(int id) const
+    {
+        return blockedAxes[slots[id]];
+    }
+
+    // whether a cell stops bodies blocked by the layers in mask; cells outside the map always do
+    bool cellBlocks(int x, int z, std::uint8_t mask) const
+    {
+        if (!grid.inBounds(x, z))
+            return true;
+        if ((mask & LAYER_BLOCK) && grid.isSolid(x, z))
+            return true;
+        return (mask & LAYER_BOMB) && bombs != nullptr && bombs->hasBomb(x, z);
+    }
+
+    // movement
+    // ------------------------------------------------------------------------
+    // moves every body by its setMove() displacement as far as blocks, bombs and blocking
+    // bodies allow, in body order, then reports the contacts at the new positions. The result
+    // stays valid until the next resolve()
+    const std::vector<Contact>& resolve()
+    {
+        PROFILE_ZONE("CollisionWorld::resolve");
+        lastStats = Stats();
+        lastStats.bodies = bodies.size();
+        buildHash(true);
+
+        for (std::size_t i = 0; i < bodies.size(); i++)
+        {
+            Body& b = bodies[i];
+            std::int32_t startMinX = b.x - b.halfX, startMaxX = b.x + b.halfX;
+            std::int32_t startMinZ = b.z - b.halfZ, startMaxZ = b.z + b.halfZ;
+            blockedAxes[i] = 0;
+            for (int axis = 0; axis < 2; axis++)
+            {
+                std::int32_t wanted = axis == 0 ? moves[i].dx : moves[i].dz;
+                if (wanted == 0)
+                    continue;
+                std::int32_t allowed = sweep(i, axis, wanted, startMinX, startMaxX, startMinZ, startMaxZ);
+                (axis == 0 ? b.x : b.z) += allowed;
+                if (allowed != wanted)
+                    blockedAxes[i] |= axis == 0 ? BLOCKED_X : BLOCKED_Z;
+            }
+            moves[i] = Move();
+        }
+
+        findContacts();
+        lastStats.contacts = contactList.size();
+        return contactList;
+    }
+
+    const std::vector<Contact>& contacts() const { return contactList; }
+    const Stats& stats() const { return lastStats; }
+
+    // queries
+    // ------------------------------------------------------------------------
+    // ids of the bodies on the layers in mask whose box reaches within radius of (x, z)
+    void queryRadius(std::int32_t x, std::int32_t z, std::int32_t radius, std::uint8_t mask, std::vector<int>& result)
+    {
+        result.clear();
+        buildHash(false);
+        nextStamp();
+        const std::int64_t radiusSquared = static_cast<std::int64_t>(radius) * radius;
+        forEachCandidate(x - radius, x + radius + 1, z - radius, z + radius + 1, [&](std::size_t j) {
+            const Body& other = bodies[j];
+            if (!(other.layer & mask))
+                return;
+            // closest point of the box to the centre
+            std::int64_t dx = std::max<std::int64_t>(0, std::abs(static_cast<std::int64_t>(x) - other.x) - other.halfX);
+            std::int64_t dz = std::max<std::int64_t>(0, std::abs(static_cast<std::int64_t>(z) - other.z) - other.halfZ);
+            if (dx * dx + dz * dz <= radiusSquared)
+                result.push_back(ids[j]);
+        });
+    }
+
+    // nearest block, bomb or body on the layers in mask along the ray from (x, z) within
+    // maxDistance units; ignore is a body to skip (e.g. the one casting). The walk visits the
+    // cells under the ray in order (Amanatides and Woo) and stops at the first cell that ends
+    // beyond the nearest hit.
+    bool raycast(float x, float z, float dirX, float dirZ, float maxDistance, std::uint8_t mask, RayHit& hit, int ignore = NO_BODY)
+    {
+        float length = std::sqrt(dirX * dirX + dirZ * dirZ);
+        if (length == 0.0f)
+            return false;
+        dirX /= length;
+        dirZ /= length;
+        buildHash(false);
+        nextStamp();
+        int ignoreSlot = contains(ignore) ? slots[ignore] : NO_BODY;
+
+        const float cell = static_cast<float>(UNITS_PER_CELL);
+        int cx = static_cast<int>(std::floor(x / cell));
+        int cz = static_cast<int>(std::floor(z / cell));
+        int stepX = dirX > 0.0f ? 1 : -1;
+        int stepZ = dirZ > 0.0f ? 1 : -1;
+        const float INFINITE = 1e30f;
+        float deltaX = dirX != 0.0f ? cell / std::abs(dirX) : INFINITE;
+        float deltaZ = dirZ != 0.0f ? cell / std::abs(dirZ) : INFINITE;
+        float nextX = dirX != 0.0f ? ((cx + (stepX > 0)) * cell - x) / dirX : INFINITE;
+        float nextZ = dirZ != 0.0f ? ((cz + (stepZ > 0)) * cell - z) / dirZ : INFINITE;
+
+        bool found = false;
+        float best = maxDistance;
+        float enter = 0.0f;
+        while (enter <= best && grid.inBounds(cx, cz))
+        {
+            // a blocking cell ends the walk; bodies in it may still be nearer
+            bool cellHit = ((mask & LAYER_BLOCK) && grid.isSolid(cx, cz))
+                || ((mask & LAYER_BOMB) && bombs != nullptr && bombs->hasBomb(cx, cz));
+            if (cellHit && enter <= best)
+            {
+                found = true;
+                best = enter;
+                hit.distance = enter;
+                hit.body = NO_BODY;
+                hit.cellX = cx;
+                hit.cellZ = cz;
+                hit.layer = grid.isSolid(cx, cz) && (mask & LAYER_BLOCK) ? LAYER_BLOCK : LAYER_BOMB;
+            }
+
+            forEachInBucket(cx, cz, [&](std::size_t j) {
+                const Body& other = bodies[j];
+                if (!(other.layer & mask) || static_cast<int>(j) == ignoreSlot)
+                    return;
+                float t;
+                if (rayBox(x, z, dirX, dirZ, other, t) && t <= best)
+                {
+                    found = true;
+                    best = t;
+                    hit.distance = t;
+                    hit.body = ids[j];
+                    hit.cellX = cellOf(static_cast<std::int32_t>(std::floor(x + dirX * t)));
+                    hit.cellZ = cellOf(static_cast<std::int32_t>(std::floor(z + dirZ * t)));
+                    hit.layer = other.layer;
+                }
+            });
+            if (cellHit)
+                break;
+
+            if (nextX < nextZ)
+            {
+                enter = nextX;
+                nextX += deltaX;
+                cx += stepX;
+            }
+            else
+            {
+                enter = nextZ;
+                nextZ += deltaZ;
+                cz += stepZ;
+            }
+        }
+        return found;
+    }
+
+private:
+    struct Move
+    {
+        std::int32_t dx = 0;
+        std::int32_t dz = 0;
+    };
+
+    const TileGrid& grid;
+    const BlastSystem* bombs;
+
+    // bodies, dense, one entry per body in each array
+    std::vector<Body> bodies;
+    std::vector<Move> moves;
+    std::vector<std::uint8_t> blockedAxes;
+    std::vector<int> ids;   // id of each body
+    std::vector<int> slots; // index of each id in the dense arrays, NO_BODY when free
+    std::vector<int> freeIds;
+
+    // spatial hash: bucket b holds bucketBodies[bucketStart[b], bucketStart[b + 1])
+    std::vector<std::uint32_t> bucketStart;
+    std::vector<std::uint32_t> bucketBodies;
+    std::vector<std::uint32_t> bucketCursor; // next free entry of each bucket while filling
+    std::uint32_t bucketMask = 0;
+    bool hashDirty = true;
+
+    // per body stamp of the last query that saw it, so a body in several buckets is tested once
+    std::vector<std::uint32_t> bodyStamp;
+    std::uint32_t stamp = 0;
+
+    std::vector<Contact> contactList;
+    Stats lastStats;
+
+    std::uint32_t bucketOf(int cx, int cz) const
+    {
+        std::uint32_t hash = static_cast<std::uint32_t>(cx) * 73856093u ^ static_cast<std::uint32_t>(cz) * 19349663u;
+        return hash & bucketMask;
+    }
+
+    // box of a body swept over its pending move, as cell ranges [x0, x1] x [z0, z1]
+    void sweptCells(std::size_t i, bool withMove, int& x0, int& x1, int& z0, int& z1) const
+    {
+        const Body& b = bodies[i];
+        std::int32_t dx = withMove ? moves[i].dx : 0;
+        std::int32_t dz = withMove ? moves[i].dz : 0;
+        x0 = cellOf(b.x - b.halfX + std::min(dx, 0));
+        x1 = cellOf(b.x + b.halfX + std::max(dx, 0));
+        z0 = cellOf(b.z - b.halfZ + std::min(dz, 0));
+        z1 = cellOf(b.z + b.halfZ + std::max(dz, 0));
+    }
+
+    // counting sort of every (body, cell) pair into the buckets; withMove covers the
+    // whole of the coming resolve()
+    void buildHash(bool withMove)
+    {
+        if (!withMove && !hashDirty)
+            return;
+        hashDirty = false;
+
+        std::size_t entries = 0;
+        for (std::size_t i = 0; i < bodies.size(); i++)
+        {
+            int x0, x1, z0, z1;
+            sweptCells(i, withMove, x0, x1, z0, z1);
+            entries += static_cast<std::size_t>(x1 - x0 + 1) * (z1 - z0 + 1);
+        }
+        std::size_t buckets = 16;
+        while (buckets < entries * 2)
+            buckets *= 2;
+        bucketMask = static_cast<std::uint32_t>(buckets - 1);
+        bucketStart.assign(buckets + 1, 0);
+        bucketBodies.resize(entries);
+        lastStats.hashEntries = entries;
+
+        for (std::size_t i = 0; i < bodies.size(); i++)
+        {
+            int x0, x1, z0, z1;
+            sweptCells(i, withMove, x0, x1, z0, z1);
+            for (int cz = z0; cz <= z1; cz++)
+                for (int cx = x0; cx <= x1; cx++)
+                    bucketStart[bucketOf(cx, cz) + 1]++;
+        }
+        for (std::size_t b = 0; b < buckets; b++)
+            bucketStart[b + 1] += bucketStart[b];
+        bucketCursor.assign(bucketStart.begin(), bucketStart.end() - 1);
+        for (std::size_t i = 0; i < bodies.size(); i++)
+        {
+            int x0, x1, z0, z1;
+            sweptCells(i, withMove, x0, x1, z0, z1);
+            for (int cz = z0; cz <= z1; cz++)
+                for (int cx = x0; cx <= x1; cx++)
+                    bucketBodies[bucketCursor[bucketOf(cx, cz)]++] = static_cast<std::uint32_t>(i);
+        }
+    }
+
+    void nextStamp()
+    {
+        bodyStamp.resize(bodies.size(), 0);
+        if (++stamp == 0)
+        {
+            // the stamp wrapped around: old stamps could look current
+            std::fill(bodyStamp.begin(), bodyStamp.end(), 0);
+            stamp = 1;
+        }
+    }
+
+    template <typename Fn>
+    void forEachInBucket(int cx, int cz, Fn fn)
+    {
+        std::uint32_t b = bucketOf(cx, cz);
+        for (std::uint32_t e = bucketStart[b]; e < bucketStart[b + 1]; e++)
+        {
+            std::uint32_t j = bucketBodies[e];
+            if (bodyStamp[j] == stamp)
+                continue;
+            bodyStamp[j] = stamp;
+            fn(static_cast<std::size_t>(j));
+        }
+    }
+
+    // every body in the buckets of the cells overlapping [minX, maxX) x [minZ, maxZ), once
+    template <typename Fn>
+    void forEachCandidate(std::int32_t minX, std::int32_t maxX, std::int32_t minZ, std::int32_t maxZ, Fn fn)
+    {
+        for (int cz = cellOf(minZ); cz <= cellOf(maxZ - 1); cz++)
+            for (int cx = cellOf(minX); cx <= cellOf(maxX - 1); cx++)
+                forEachInBucket(cx, cz, fn);
+    }
+
+    // how far body i can move along axis (0 = x, 1 = z) toward wanted; the start box decides
+    // which bombs it may leave
+    std::int32_t sweep(std::size_t i, int axis, std::int32_t wanted, std::int32_t startMinX, std::int32_t startMaxX,
+        std::int32_t startMinZ, std::int32_t startMaxZ)
+    {
+        const Body& b = bodies[i];
+        // a = the moving axis, c = the other one
+        std::int32_t minA = axis == 0 ? b.x - b.halfX : b.z - b.halfZ;
+        std::int32_t maxA = axis == 0 ? b.x + b.halfX : b.z + b.halfZ;
+        std::int32_t minC = axis == 0 ? b.z - b.halfZ : b.x - b.halfX;
+        std::int32_t maxC = axis == 0 ? b.z + b.halfZ : b.x + b.halfX;
+        int c0 = cellOf(minC), c1 = cellOf(maxC - 1);
+        std::int32_t allowed = wanted;
+
+        // cells: the first line of cells entered by the leading edge that blocks ends the move
+        auto blocks = [&](int a, int c) {
+            int x = axis == 0 ? a : c;
+            int z = axis == 0 ? c : a;
+            if (cellBlocks(x, z, b.blockMask & LAYER_BLOCK))
+                return true;
+            if (!cellBlocks(x, z, b.blockMask & LAYER_BOMB))
+                return false;
+            // walking off a bomb overlapped at the start of the tick is allowed
+            std::int32_t cellMinX = x * UNITS_PER_CELL, cellMinZ = z * UNITS_PER_CELL;
+            return !(startMinX < cellMinX + UNITS_PER_CELL && cellMinX < startMaxX
+                && startMinZ < cellMinZ + UNITS_PER_CELL && cellMinZ < startMaxZ);
+        };
+        if (wanted > 0)
+        {
+            for (int a = cellOf(maxA - 1) + 1; a <= cellOf(maxA + wanted - 1); a++)
+            {
+                bool hit = false;
+                for (int c = c0; c <= c1 && !hit; c++)
+                    hit = blocks(a, c);
+                if (hit)
+                {
+                    allowed = a * UNITS_PER_CELL - maxA;
+                    break;
+                }
+            }
+        }
+        else
+        {
+            for (int a = cellOf(minA) - 1; a >= cellOf(minA + wanted); a--)
+            {
+                bool hit = false;
+                for (int c = c0; c <= c1 && !hit; c++)
+                    hit = blocks(a, c);
+                if (hit)
+                {
+                    allowed = (a + 1) * UNITS_PER_CELL - minA;
+                    break;
+                }
+            }
+        }
+
+        // bodies ahead on the path, overlapping on the other axis; bodies already overlapping
+        // this one are ignored so the two can separate
+        std::uint8_t bodyMask = b.blockMask & ~(LAYER_BLOCK | LAYER_BOMB);
+        if (bodyMask == 0 || allowed == 0)
+            return allowed;
+        std::int32_t sweepMin = wanted > 0 ? maxA : minA + allowed;
+        std::int32_t sweepMax = wanted > 0 ? maxA + allowed : minA;
+        nextStamp();
+        auto test = [&](std::size_t j) {
+            if (j == i || !(bodies[j].layer & bodyMask))
+                return;
+            lastStats.pairTests++;
+            const Body& other = bodies[j];
+            std::int32_t otherMinA = axis == 0 ? other.x - other.halfX : other.z - other.halfZ;
+            std::int32_t otherMaxA = axis == 0 ? other.x + other.halfX : other.z + other.halfZ;
+            std::int32_t otherMinC = axis == 0 ? other.z - other.halfZ : other.x - other.halfX;
+            std::int32_t otherMaxC = axis == 0 ? other.z + other.halfZ : other.x + other.halfX;
+            if (!(minC < otherMaxC && otherMinC < maxC))
+                return;
+            if (wanted > 0 && otherMinA >= maxA)
+                allowed = std::min(allowed, otherMinA - maxA);
+            else if (wanted < 0 && otherMaxA <= minA)
+                allowed = std::max(allowed, otherMaxA - minA);
+        };
+        if (axis == 0)
+            forEachCandidate(sweepMin, std::max(sweepMax, sweepMin + 1), minC, maxC, test);
+        else
+            forEachCandidate(minC, maxC, sweepMin, std::max(sweepMax, sweepMin + 1), test);
+        return allowed;
+    }
+
+    // pairs touching or overlapping at the end of the tick
+    void findContacts()
+    {
+        contactList.clear();
+        for (std::size_t i = 0; i < bodies.size(); i++)
+        {
+            const Body& b = bodies[i];
+            if (b.touchMask == 0)
+                continue;
+            nextStamp();
+            forEachCandidate(b.x - b.halfX - 1, b.x + b.halfX + 1, b.z - b.halfZ - 1, b.z + b.halfZ + 1, [&](std::size_t j) {
+                const Body& other = bodies[j];
+                if (j == i || !(b.touchMask & other.layer))
+                    return;
+                // both report each other: keep the pair once
+                if ((other.touchMask & b.layer) && j < i)
+                    return;
+                if (std::abs(b.x - other.x) <= b.halfX + other.halfX && std::abs(b.z - other.z) <= b.halfZ + other.halfZ)
+                    contactList.push_back({ ids[i], ids[j] });
+            });
+        }
+    }
+
+    // entry distance of the ray into a body's box (0 when it starts inside)
+    static bool rayBox(float x, float z, float dirX, float dirZ, const Body& box, float& t)
+    {
+        float tMin = 0.0f, tMax = 1e30f;
+        const float origin[2] = { x, z };
+        const float dir[2] = { dirX, dirZ };
+        const float lo[2] = { static_cast<float>(box.x - box.halfX), static_cast<float>(box.z - box.halfZ) };
+        const float hi[2] = { static_cast<float>(box.x + box.halfX), static_cast<float>(box.z + box.halfZ) };
+        for (int axis = 0; axis < 2; axis++)
+        {
+            if (dir[axis] == 0.0f)
+            {
+                if (origin[axis] < lo[axis] || origin[axis] > hi[axis])
+                    return false;
+                continue;
+            }
+            float t0 = (lo[axis] - origin[axis]) / dir[axis];
+            float t1 = (hi[axis] - origin[axis]) / dir[axis];
+            if (t0 > t1)
+                std::swap(t0, t1);
+            tMin = std::max(tMin, t0);
+            tMax = std::min(tMax, t1);
+            if (tMin > tMax)
+                return false;
+        }
+        t = tMin;
+        return true;
+    }
+};
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef FRAME_UNIFORMS_H
+#define FRAME_UNIFORMS_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "profiler.h"
+
+#include <cstring>
+
+// Camera and light state shared by every shader through the std140 uniform block
+//
+//     layout (std140) uniform FrameUniforms { ... };
+//
+// declared in shaders/include/frame_uniforms.glsl. The block lives in a
+// single uniform buffer bound to BINDING_POINT; it is only re-uploaded when the values change,
+// so a static camera costs nothing per frame.
+class FrameUniforms
+{
+public:
+    static constexpr unsigned int BINDING_POINT = 0;
+    static constexpr const char* BLOCK_NAME = "FrameUniforms";
+
+    // CPU side mirror of the block; vec3 members are padded to 16 bytes as std140 requires
+    struct Block
+    {
+        glm::mat4 projection;
+        glm::mat4 view;
+        glm::vec4 lightPos;   // xyz used
+        glm::vec4 lightColor; // xyz used
+        glm::vec4 viewPos;    // xyz used
+    };
+    static_assert(sizeof(Block) == 2 * 64 + 3 * 16, "FrameUniforms::Block must match the std140 layout");
+
+    FrameUniforms()
+    {
+        block.projection = glm::mat4(1.0f);
+        block.view = glm::mat4(1.0f);
+        block.lightPos = glm::vec4(0.0f);
+        block.lightColor = glm::vec4(0.0f);
+        block.viewPos = glm::vec4(0.0f);
+        glGenBuffers(1, &UBO);
+        glBindBuffer(GL_UNIFORM_BUFFER, UBO);
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(Block), NULL, GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        glBindBufferBase(GL_UNIFORM_BUFFER, BINDING_POINT, UBO);
+    }
+
+    FrameUniforms(const FrameUniforms&) = delete;
+    FrameUniforms& operator=(const FrameUniforms&) = delete;
+
+    // de-allocate the buffer; must be called while the context is still current
+    void release()
+    {
+        glDeleteBuffers(1, &UBO);
+        UBO = 0;
+    }
+
+    void setCamera(const glm::mat4& projection, const glm::mat4& view, const glm::vec3& viewPos)
+    {
+        Block next = block;
+        next.projection = projection;
+        next.view = view;
+        next.viewPos = glm::vec4(viewPos, 1.0f);
+        assign(next);
+    }
+
+    void setLight(const glm::vec3& lightPos, const glm::vec3& lightColor)
+    {
+        Block next = block;
+        next.lightPos = glm::vec4(lightPos, 1.0f);
+        next.lightColor = glm::vec4(lightColor, 1.0f);
+        assign(next);
+    }
+
+    // upload the block if anything changed since the last upload; returns true if it did
+    // ------------------------------------------------------------------------
+    bool upload()
+    {
+        if (!dirty)
+            return false;
+        glBindBuffer(GL_UNIFORM_BUFFER, UBO);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(Block), &block);
+        PROFILE_COUNT("bytes uploaded", sizeof(Block));
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        dirty = false;
+        return true;
+    }
+
+    const Block& values() const { return block; }
+
+private:
+    unsigned int UBO = 0;
+    Block block;
+    bool dirty = true;
+
+    void assign(const Block& next)
+    {
+        if (std::memcmp(&next, &block, sizeof(Block)) == 0)
+            return;
+        block = next;
+        dirty = true;
+    }
+};
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <glm/glm.hpp>
+
+// The six clip planes of a camera, extracted from projection * view (Gribb & Hartmann), for
+// culling bounding boxes on the CPU. Plane normals point into the frustum and are not
+// normalised, which the box test does not need.
+class Frustum
+{
+public:
+    enum Plane
+    {
+        LEFT_PLANE = 0,
+        RIGHT_PLANE,
+        BOTTOM_PLANE,
+        TOP_PLANE,
+        NEAR_PLANE, // not NEAR/FAR, which windows.h defines as macros
+        FAR_PLANE,
+        PLANE_COUNT
+    };
+
+    Frustum()
+    {
+        // accepts everything until set() is called
+        for (int i = 0; i < PLANE_COUNT; i++)
+            planes[i] = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+    }
+
+    explicit Frustum(const glm::mat4& viewProjection)
+    {
+        set(viewProjection);
+    }
+
+    void set(const glm::mat4& m)
+    {
+        // rows of the column-major matrix
+        glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+        glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+        glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+        glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+        planes[LEFT_PLANE] = row3 + row0;
+        planes[RIGHT_PLANE] = row3 - row0;
+        planes[BOTTOM_PLANE] = row3 + row1;
+        planes[TOP_PLANE] = row3 - row1;
+        planes[NEAR_PLANE] = row3 + row2;
+        planes[FAR_PLANE] = row3 - row2;
+    }
+
+    // false only when the axis-aligned box lies completely outside one of the planes
+    // (conservative: a box near a frustum corner may pass without being visible)
+    bool intersects(const glm::vec3& min, const glm::vec3& max) const
+    {
+        for (int i = 0; i < PLANE_COUNT; i++)
+        {
+            const glm::vec4& plane = planes[i];
+            // the corner furthest along the plane normal
+            glm::vec3 corner(plane.x >= 0.0f ? max.x : min.x, plane.y >= 0.0f ? max.y : min.y, plane.z >= 0.0f ? max.z : min.z);
+            if (plane.x * corner.x + plane.y * corner.y + plane.z * corner.z + plane.w < 0.0f)
+                return false;
+        }
+        return true;
+    }
+
+private:
+    glm::vec4 planes[PLANE_COUNT];
+};
+
+#endif
@@ -0,0 +1,175 @@
+#ifndef GPU_PROFILER_H
+#define GPU_PROFILER_H
+
+// GPU zones for the frame profiler (profiler.h), from GL_TIMESTAMP queries:
+//
+//     PROFILE_GPU_ZONE("render queue");         // GPU time of the GL commands in the scope
+//
+// Kept apart from profiler.h so only code with a GL context depends on GL. PROFILE_FRAME()
+// reads back the zones whose query results are available (an export waits for all of them)
+// and hands them to the Profiler as events of its "GPU" thread. GL thread only. Compiles to
+// nothing unless PALBOM_PROFILER is 1, like the other macros.
+#include "profiler.h"
+
+#if PALBOM_PROFILER
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+class GpuProfiler
+{
+public:
+    static GpuProfiler& instance()
+    {
+        static GpuProfiler profiler;
+        return profiler;
+    }
+
+    GpuProfiler(const GpuProfiler&) = delete;
+    GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+    // GpuProfileZone
+    // ------------------------------------------------------------------------
+    std::size_t beginZone(const char* name)
+    {
+        if (!calibrated)
+        {
+            // GL timestamps count from an arbitrary origin: line them up with Profiler::now()
+            GLint64 gpuNow = 0;
+            glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+            offset = static_cast<int64_t>(Profiler::instance().now()) - static_cast<int64_t>(gpuNow);
+            calibrated = true;
+        }
+        Zone zone;
+        zone.name = name;
+        zone.begin = takeQuery();
+        zone.depth = depth++;
+        glQueryCounter(zone.begin, GL_TIMESTAMP);
+        zones.push_back(zone);
+        return zonesCollected + zones.size() - 1;
+    }
+
+    void endZone(std::size_t zone)
+    {
+        Zone& open = zones[zone - zonesCollected];
+        open.end = takeQuery();
+        glQueryCounter(open.end, GL_TIMESTAMP);
+        depth = open.depth;
+    }
+
+    // hand the finished zones to the Profiler in order; with wait, block until all closed
+    // ones are done
+    void collect(bool wait)
+    {
+        while (!zones.empty() && zones.front().end != 0)
+        {
+            Zone& zone = zones.front();
+            if (!wait)
+            {
+                GLint available = 0;
+                glGetQueryObjectiv(zone.end, GL_QUERY_RESULT_AVAILABLE, &available);
+                if (!available)
+                    break;
+            }
+            GLuint64 begin = 0, end = 0;
+            glGetQueryObjectui64v(zone.begin, GL_QUERY_RESULT, &begin);
+            glGetQueryObjectui64v(zone.end, GL_QUERY_RESULT, &end);
+            uint64_t start = static_cast<uint64_t>(std::max<int64_t>(0, static_cast<int64_t>(begin) + offset));
+            Profiler::instance().addGpuEvent(ProfileEvent{ zone.name, start, start + (end > begin ? end - begin : 0), zone.depth });
+            freeQueries.push_back(zone.begin);
+            freeQueries.push_back(zone.end);
+            zones.pop_front();
+            zonesCollected++;
+        }
+    }
+
+    // delete the timestamp queries; must be called while the context is still current
+    void release()
+    {
+        for (const Zone& zone : zones)
+        {
+            freeQueries.push_back(zone.begin);
+            if (zone.end != 0)
+                freeQueries.push_back(zone.end);
+        }
+        zonesCollected += zones.size();
+        zones.clear();
+        if (!freeQueries.empty())
+            glDeleteQueries(static_cast<GLsizei>(freeQueries.size()), freeQueries.data());
+        freeQueries.clear();
+    }
+
+private:
+    struct Zone
+    {
+        const char* name = nullptr;
+        GLuint begin = 0;
+        GLuint end = 0; // 0 while the zone is open
+        uint32_t depth = 0;
+    };
+
+    std::deque<Zone> zones; // issued, oldest first
+    std::size_t zonesCollected = 0;
+    std::vector<GLuint> freeQueries;
+    uint32_t depth = 0;
+    bool calibrated = false;
+    int64_t offset = 0;
+
+    GpuProfiler()
+    {
+        Profiler::instance().setGpuCollector([](bool wait) { GpuProfiler::instance().collect(wait); });
+    }
+
+    GLuint takeQuery()
+    {
+        if (freeQueries.empty())
+        {
+            freeQueries.resize(64);
+            glGenQueries(static_cast<GLsizei>(freeQueries.size()), freeQueries.data());
+        }
+        GLuint query = freeQueries.back();
+        freeQueries.pop_back();
+        return query;
+    }
+};
+
+// times the GL commands issued in its scope (PROFILE_GPU_ZONE)
+class GpuProfileZone
+{
+public:
+    explicit GpuProfileZone(const char* name)
+    {
+        if (!Profiler::instance().capturing())
+            return;
+        active = true;
+        zone = GpuProfiler::instance().beginZone(name);
+    }
+
+    ~GpuProfileZone()
+    {
+        if (active)
+            GpuProfiler::instance().endZone(zone);
+    }
+
+    GpuProfileZone(const GpuProfileZone&) = delete;
+    GpuProfileZone& operator=(const GpuProfileZone&) = delete;
+
+private:
+    bool active = false;
+    std::size_t zone = 0;
+};
+
+#define PROFILE_GPU_ZONE(name) GpuProfileZone PALBOM_PROFILE_CONCAT(gpuProfileZone, __LINE__)(name)
+
+#else
+
+#define PROFILE_GPU_ZONE(name) ((void)0)
+
+#endif
+
+#endif
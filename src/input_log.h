@@ -0,0 +1,196 @@
+#ifndef INPUT_LOG_H
+#define INPUT_LOG_H
+
+#include "simulation.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Input log (.pbin): everything needed to replay a match bit for bit, i.e. the simulation
+// config and the command mask of every tick, plus the state hash recorded every
+// hashInterval ticks and the hash after the last tick to check a replay against.
+//
+//     header | runs: (varint tick count, command byte)... | hashes: uint64 per checkpoint
+//
+// Commands are run-length encoded, since almost all ticks carry none: a minute of play
+// without input is a handful of bytes. Written in host byte order like the baked containers.
+struct InputLogHeader
+{
+    static constexpr uint32_t MAGIC = 0x4E494250; // "PBIN"
+    static constexpr uint32_t VERSION = 2;
+
+    uint32_t magic = MAGIC;
+    uint32_t version = VERSION;
+    uint32_t seed = 0;
+    uint32_t mapSize = 0;
+    float breakableProbability = 0.0f;
+    uint32_t hashInterval = 0; // ticks between hashes, 0 for none
+    uint64_t tickCount = 0;
+    uint32_t runBytes = 0;     // size of the run-length encoded commands
+    uint32_t hashCount = 0;
+    uint64_t finalHash = 0;    // state hash after the last tick
+};
+
+static_assert(sizeof(InputLogHeader) == 48, "InputLogHeader layout is part of the file format");
+
+class InputLog
+{
+public:
+    static constexpr uint32_t DEFAULT_HASH_INTERVAL = 60;
+    static constexpr uint32_t MAX_MAP_SIZE = 4096; // larger maps in a file are taken as corrupt
+
+    InputLog() = default;
+
+    // start recording a match with the given config
+    InputLog(const SimulationConfig& config, uint32_t hashInterval = DEFAULT_HASH_INTERVAL)
+    {
+        header.seed = config.seed;
+        header.mapSize = static_cast<uint32_t>(config.mapSize);
+        header.breakableProbability = config.breakableProbability;
+        header.hashInterval = hashInterval;
+    }
+
+    SimulationConfig config() const
+    {
+        SimulationConfig result;
+        result.seed = header.seed;
+        result.mapSize = static_cast<int>(header.mapSize);
+        result.breakableProbability = header.breakableProbability;
+        return result;
+    }
+
+    uint64_t tickCount() const { return header.tickCount; }
+    uint32_t hashInterval() const { return header.hashInterval; }
+    const std::vector<uint64_t>& hashes() const { return stateHashes; }
+    uint64_t finalHash() const { return header.finalHash; }
+    std::size_t encodedSize() const { return sizeof(InputLogHeader) + runs.size() + stateHashes.size() * sizeof(uint64_t); }
+
+    // append the commands of the tick the simulation just ran
+    void record(uint8_t commands, const Simulation& simulation)
+    {
+        commands &= COMMAND_MASK;
+        if (header.tickCount == 0 || commands != runCommands)
+        {
+            flushRun();
+            runCommands = commands;
+        }
+        runLength++;
+        header.tickCount++;
+        if (header.hashInterval != 0 && header.tickCount % header.hashInterval == 0)
+            stateHashes.push_back(simulation.stateHash());
+    }
+
+    // the simulation is the one recorded, after its last tick
+    bool save(const std::string& path, const Simulation& simulation)
+    {
+        flushRun();
+        header.finalHash = simulation.stateHash();
+        header.runBytes = static_cast<uint32_t>(runs.size());
+        header.hashCount = static_cast<uint32_t>(stateHashes.size());
+        FILE* file = std::fopen(path.c_str(), "wb");
+        if (file == NULL)
+            return false;
+        bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1
+            && std::fwrite(runs.data(), 1, runs.size(), file) == runs.size()
+            && std::fwrite(stateHashes.data(), sizeof(uint64_t), stateHashes.size(), file) == stateHashes.size();
+        ok = std::fclose(file) == 0 && ok;
+        return ok;
+    }
+
+    bool load(const std::string& path)
+    {
+        FILE* file = std::fopen(path.c_str(), "rb");
+        if (file == NULL)
+            return false;
+        // the sizes in the header must account for exactly the rest of the file, so a
+        // corrupt header cannot ask for more memory than the file holds
+        bool ok = std::fseek(file, 0, SEEK_END) == 0;
+        long fileSize = ok ? std::ftell(file) : -1;
+        ok = fileSize >= 0 && std::fseek(file, 0, SEEK_SET) == 0;
+        InputLogHeader loaded;
+        ok = ok && std::fread(&loaded, sizeof(loaded), 1, file) == 1 && loaded.magic == InputLogHeader::MAGIC
+            && loaded.version == InputLogHeader::VERSION
+            && loaded.mapSize >= 5 && loaded.mapSize <= MAX_MAP_SIZE
+            && static_cast<uint64_t>(loaded.runBytes) + static_cast<uint64_t>(loaded.hashCount) * sizeof(uint64_t)
+                == static_cast<uint64_t>(fileSize) - sizeof(loaded);
+        if (ok)
+        {
+            runs.resize(loaded.runBytes);
+            stateHashes.resize(loaded.hashCount);
+            ok = std::fread(runs.data(), 1, runs.size(), file) == runs.size()
+                && std::fread(stateHashes.data(), sizeof(uint64_t), stateHashes.size(), file) == stateHashes.size();
+        }
+        std::fclose(file);
+        if (!ok)
+            return false;
+        header = loaded;
+        runLength = 0;
+        return true;
+    }
+
+    // sequential access to the recorded commands, one call per tick
+    class Reader
+    {
+    public:
+        explicit Reader(const InputLog& log) : runs(log.runs) {}
+
+        uint8_t next()
+        {
+            while (remaining == 0 && position < runs.size())
+            {
+                remaining = readVarint();
+                commands = position < runs.size() ? runs[position++] : 0;
+            }
+            if (remaining == 0)
+                return 0; // past the end of the log
+            remaining--;
+            return commands;
+        }
+
+    private:
+        const std::vector<uint8_t>& runs;
+        std::size_t position = 0;
+        uint64_t remaining = 0;
+        uint8_t commands = 0;
+
+        uint64_t readVarint()
+        {
+            uint64_t value = 0;
+            for (int shift = 0; position < runs.size() && shift < 64; shift += 7)
+            {
+                uint8_t byte = runs[position++];
+                value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+                if ((byte & 0x80) == 0)
+                    break;
+            }
+            return value;
+        }
+    };
+
+private:
+    InputLogHeader header;
+    std::vector<uint8_t> runs;
+    std::vector<uint64_t> stateHashes;
+    uint64_t runLength = 0;   // ticks of the run being recorded, not yet in runs
+    uint8_t runCommands = 0;
+
+    void flushRun()
+    {
+        if (runLength == 0)
+            return;
+        // LEB128 tick count, then the command byte
+        uint64_t value = runLength;
+        while (value >= 0x80)
+        {
+            runs.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        runs.push_back(static_cast<uint8_t>(value));
+        runs.push_back(runCommands);
+        runLength = 0;
+    }
+};
+
+#endif
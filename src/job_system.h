@@ -0,0 +1,211 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include "profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Work-stealing thread pool for short CPU jobs (animation, later simulation).
+//
+// Every worker owns a queue: it pushes and pops jobs at the back of its own queue (most
+// recently submitted first, still warm in cache) and, when that is empty, steals from the
+// front of the others. Threads that are not workers (the main thread) share one extra queue.
+// wait() never blocks while jobs are queued; the waiting thread runs them itself, so with
+// workerCount 0 everything runs serially inside wait() on the calling thread.
+class JobSystem
+{
+public:
+    using Job = std::function<void()>;
+
+    // completion count for a group of jobs; reusable once wait() has returned
+    class Counter
+    {
+    public:
+        bool done() const
+        {
+            return pending.load(std::memory_order_acquire) == 0;
+        }
+
+    private:
+        friend class JobSystem;
+        std::atomic<int> pending{ 0 };
+    };
+
+    // workerCount < 0 picks one thread per spare hardware thread
+    explicit JobSystem(int workerCount = -1)
+    {
+        if (workerCount < 0)
+            workerCount = static_cast<int>(std::max(2u, std::thread::hardware_concurrency()) - 1);
+        for (int i = 0; i <= workerCount; i++)
+            queues.emplace_back(new Queue());
+        for (int i = 0; i < workerCount; i++)
+            workers.emplace_back(&JobSystem::workerLoop, this, i + 1);
+    }
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    ~JobSystem()
+    {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stopping = true;
+        }
+        workAvailable.notify_all();
+        for (std::thread& worker : workers)
+            worker.join();
+    }
+
+    unsigned int workerCount() const
+    {
+        return static_cast<unsigned int>(workers.size());
+    }
+
+    void submit(Job job, Counter& counter)
+    {
+        counter.pending.fetch_add(1, std::memory_order_relaxed);
+        // counted before the push, so the pop that takes the job can never decrement first
+        queued.fetch_add(1, std::memory_order_relaxed);
+        Queue& queue = *queues[currentQueue()];
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.push_back(Task{ std::move(job), &counter });
+        }
+        {
+            // pairs with the predicate check of a worker about to sleep, so the wake-up is not lost
+            std::lock_guard<std::mutex> lock(sleepMutex);
+        }
+        workAvailable.notify_one();
+    }
+
+    // run queued jobs until every job of counter has finished
+    void wait(Counter& counter)
+    {
+        std::size_t self = currentQueue();
+        while (!counter.done())
+        {
+            if (!runOne(self))
+                std::this_thread::yield(); // the remaining jobs are running on other threads
+        }
+    }
+
+    // body(begin, end) over [0, count) in chunks of at most grain items, in parallel; returns
+    // when all chunks are done. Chunk boundaries depend only on count and grain.
+    template<typename Body>
+    void parallelFor(std::size_t count, std::size_t grain, const Body& body)
+    {
+        grain = std::max<std::size_t>(1, grain);
+        if (count <= grain || workers.empty())
+        {
+            for (std::size_t begin = 0; begin < count; begin += grain)
+                body(begin, std::min(count, begin + grain));
+            return;
+        }
+        Counter counter;
+        for (std::size_t begin = 0; begin < count; begin += grain)
+        {
+            std::size_t end = std::min(count, begin + grain);
+            submit([&body, begin, end]() { body(begin, end); }, counter);
+        }
+        wait(counter);
+    }
+
+private:
+    struct Task
+    {
+        Job job;
+        Counter* counter;
+    };
+
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    // index of the calling thread's queue; 0 for threads that are not workers of this pool
+    std::size_t currentQueue() const
+    {
+        return owner == this ? ownQueue : 0;
+    }
+
+    bool runOne(std::size_t self)
+    {
+        Task task;
+        if (!pop(self, task))
+            return false;
+        task.job();
+        task.counter->pending.fetch_sub(1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(std::size_t self, Task& task)
+    {
+        {
+            Queue& own = *queues[self];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty())
+            {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                taken();
+                return true;
+            }
+        }
+        for (std::size_t i = 1; i < queues.size(); i++)
+        {
+            Queue& victim = *queues[(self + i) % queues.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty())
+            {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                taken();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void taken()
+    {
+        queued.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void workerLoop(std::size_t index)
+    {
+        PROFILE_THREAD("job worker");
+        owner = this;
+        ownQueue = index;
+        while (true)
+        {
+            if (runOne(index))
+                continue;
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            workAvailable.wait(lock, [this] { return stopping || queued.load(std::memory_order_relaxed) > 0; });
+            if (stopping)
+                return;
+        }
+    }
+
+    std::vector<std::unique_ptr<Queue>> queues; // [0] is shared by non-worker threads
+    std::vector<std::thread> workers;
+    std::mutex sleepMutex;
+    std::condition_variable workAvailable;
+    std::atomic<std::size_t> queued{ 0 }; // jobs submitted and not yet popped, in all queues
+    bool stopping = false;                // guarded by sleepMutex
+
+    static inline thread_local const JobSystem* owner = nullptr;
+    static inline thread_local std::size_t ownQueue = 0;
+};
+
+#endif
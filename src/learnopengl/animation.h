@@ -0,0 +1,259 @@
+#pragma once
+
+#include <vector>
+#include <map>
+#include <glm/glm.hpp>
+#include <assimp/scene.h>
+#include <learnopengl/bone.h>
+#include <functional>
+#include <learnopengl/animdata.h>
+#include <learnopengl/model_animation.h>
+#include "model_cache.h"
+
+struct AssimpNodeData
+{
+	glm::mat4 transformation;
+	std::string name;
+	int childrenCount;
+	std::vector<AssimpNodeData> children;
+};
+
+// one node of the hierarchy compiled for evaluation (see Animation::GetSkeleton). Nodes are
+// stored parent-before-child and every name lookup is resolved to an index at load time.
+struct SkeletonNode
+{
+	glm::mat4 transformation; // local transform used when no channel animates the node
+	glm::mat4 offset;         // bone offset matrix, valid if boneIndex >= 0
+	int parent;               // index of the parent node, -1 for the root
+	int boneIndex;            // slot in the final bone matrices, -1 if the node is not a bone
+	int channel;              // index of the animating Bone, -1 if the node is not animated
+	int height;               // levels of descendants below the node, 0 for leaves
+};
+
+class Animation
+{
+public:
+	Animation() = default;
+
+	// the first clip of animationPath, from its baked .bmdl when that is up to date (see
+	// model_cache.h), imported with Assimp otherwise
+	Animation(const std::string& animationPath, Model* model)
+	{
+		ModelCache::BakedModel baked;
+		ModelCache::SceneData imported;
+		ModelCache::SceneView scene;
+		if (ModelCache::openBaked(animationPath, baked))
+		{
+			scene = baked.view();
+		}
+		else
+		{
+			Assimp::Importer importer;
+			const aiScene* source = importer.ReadFile(animationPath, aiProcess_Triangulate);
+			assert(source && source->mRootNode);
+			ModelCache::extractScene(source, imported, false);
+			scene = imported.view();
+		}
+		assert(scene.hasAnimation && !scene.nodes.empty());
+		m_Duration = scene.duration;
+		m_TicksPerSecond = scene.ticksPerSecond;
+		std::size_t next = 0;
+		ReadHierarchyData(m_RootNode, scene.nodes, next);
+		ReadMissingBones(scene.channels, model->GetBoneInfoMap(), model->GetBoneCount());
+		CompileSkeleton();
+	}
+
+	// build from an already imported (or generated) clip and node hierarchy; bones the
+	// clip animates that are not in boneInfoMap yet are appended to it, as with a Model
+	Animation(const aiAnimation* animation, const aiNode* rootNode, std::map<std::string, BoneInfo>& boneInfoMap, int& boneCount)
+	{
+		m_Duration = animation->mDuration;
+		m_TicksPerSecond = animation->mTicksPerSecond;
+		ReadHierarchyData(m_RootNode, rootNode);
+		ReadMissingBones(animation, boneInfoMap, boneCount);
+		CompileSkeleton();
+	}
+
+	~Animation()
+	{
+	}
+
+	Bone* FindBone(const std::string& name)
+	{
+		auto iter = std::find_if(m_Bones.begin(), m_Bones.end(),
+			[&](const Bone& Bone)
+			{
+				return Bone.GetBoneName() == name;
+			}
+		);
+		if (iter == m_Bones.end()) return nullptr;
+		else return &(*iter);
+	}
+
+	
+	inline float GetTicksPerSecond() { return m_TicksPerSecond; }
+	inline float GetDuration() { return m_Duration;}
+	inline const AssimpNodeData& GetRootNode() { return m_RootNode; }
+	inline const std::map<std::string,BoneInfo>& GetBoneIDMap() 
+	{ 
+		return m_BoneInfoMap;
+	}
+	// flattened hierarchy in evaluation order, see Animator::EvaluatePose
+	inline const std::vector<SkeletonNode>& GetSkeleton() const { return m_Skeleton; }
+	inline const Bone& GetChannel(int index) const { return m_Bones[index]; }
+	inline int GetChannelCount() const { return (int)m_Bones.size(); }
+	// height of the node a channel animates (see SkeletonNode::height), for leaf-bone LOD
+	inline int GetChannelHeight(int index) const { return m_ChannelHeights[index]; }
+
+	// resample every channel to keysPerSecond evenly spaced keys, making key lookup O(1) for
+	// clips whose keys are irregular (see Bone::ResampleUniform)
+	void ResampleUniform(float keysPerSecond)
+	{
+		for (Bone& bone : m_Bones)
+			bone.ResampleUniform(m_TicksPerSecond / keysPerSecond);
+	}
+
+private:
+	void ReadMissingBones(const aiAnimation* animation, std::map<std::string, BoneInfo>& boneInfoMap, int& boneCount)
+	{
+		int size = animation->mNumChannels;
+
+		//reading channels(bones engaged in an animation and their keyframes)
+		for (int i = 0; i < size; i++)
+		{
+			auto channel = animation->mChannels[i];
+			std::string boneName = channel->mNodeName.data;
+
+			if (boneInfoMap.find(boneName) == boneInfoMap.end())
+			{
+				boneInfoMap[boneName].id = boneCount;
+				boneCount++;
+			}
+			m_Bones.push_back(Bone(channel->mNodeName.data,
+				boneInfoMap[channel->mNodeName.data].id, channel));
+		}
+
+		m_BoneInfoMap = boneInfoMap;
+	}
+
+	void ReadMissingBones(const std::vector<ModelCache::ChannelView>& channels, std::map<std::string, BoneInfo>& boneInfoMap, int& boneCount)
+	{
+		for (const ModelCache::ChannelView& channel : channels)
+		{
+			if (boneInfoMap.find(channel.name) == boneInfoMap.end())
+			{
+				boneInfoMap[channel.name].id = boneCount;
+				boneCount++;
+			}
+			m_Bones.push_back(Bone(channel.name, boneInfoMap[channel.name].id, ReadTrack(channel.positions),
+				ReadTrack(channel.rotations), ReadTrack(channel.scales)));
+		}
+
+		m_BoneInfoMap = boneInfoMap;
+	}
+
+	template<typename T>
+	static KeyTrack<T> ReadTrack(const ModelCache::KeysView<T>& keys)
+	{
+		KeyTrack<T> track;
+		track.times.assign(keys.times, keys.times + keys.count);
+		track.values.assign(keys.values, keys.values + keys.count);
+		return track;
+	}
+
+	// rebuild the tree from pre-order nodes, starting at nodes[next]
+	void ReadHierarchyData(AssimpNodeData& dest, const std::vector<ModelCache::NodeView>& nodes, std::size_t& next)
+	{
+		const ModelCache::NodeView& src = nodes[next++];
+		dest.name = src.name;
+		dest.transformation = src.transformation;
+		dest.childrenCount = src.childCount;
+
+		for (unsigned int i = 0; i < src.childCount; i++)
+		{
+			AssimpNodeData newData;
+			ReadHierarchyData(newData, nodes, next);
+			dest.children.push_back(newData);
+		}
+	}
+
+	void ReadHierarchyData(AssimpNodeData& dest, const aiNode* src)
+	{
+		assert(src);
+
+		dest.name = src->mName.data;
+		dest.transformation = AssimpGLMHelpers::ConvertMatrixToGLMFormat(src->mTransformation);
+		dest.childrenCount = src->mNumChildren;
+
+		for (int i = 0; i < src->mNumChildren; i++)
+		{
+			AssimpNodeData newData;
+			ReadHierarchyData(newData, src->mChildren[i]);
+			dest.children.push_back(newData);
+		}
+	}
+	// flatten m_RootNode depth-first (pre-order, so parents precede children) and resolve
+	// channel and bone indices once, instead of per node and frame
+	void CompileSkeleton()
+	{
+		m_Skeleton.clear();
+		std::vector<std::pair<const AssimpNodeData*, int>> stack;
+		stack.push_back({ &m_RootNode, -1 });
+		while (!stack.empty())
+		{
+			const AssimpNodeData* node = stack.back().first;
+			int parent = stack.back().second;
+			stack.pop_back();
+
+			SkeletonNode compiled;
+			compiled.transformation = node->transformation;
+			compiled.offset = glm::mat4(1.0f);
+			compiled.parent = parent;
+			compiled.boneIndex = -1;
+			compiled.channel = -1;
+			compiled.height = 0;
+			for (int i = 0; i < (int)m_Bones.size(); i++)
+			{
+				if (m_Bones[i].GetBoneName() == node->name)
+				{
+					compiled.channel = i;
+					break;
+				}
+			}
+			auto bone = m_BoneInfoMap.find(node->name);
+			if (bone != m_BoneInfoMap.end())
+			{
+				compiled.boneIndex = bone->second.id;
+				compiled.offset = bone->second.offset;
+			}
+			int index = (int)m_Skeleton.size();
+			m_Skeleton.push_back(compiled);
+
+			// push in reverse so children are emitted in their original order
+			for (int i = node->childrenCount - 1; i >= 0; i--)
+				stack.push_back({ &node->children[i], index });
+		}
+
+		// children follow their parents, so one backwards pass settles every height
+		for (int i = (int)m_Skeleton.size() - 1; i > 0; i--)
+		{
+			SkeletonNode& parent = m_Skeleton[m_Skeleton[i].parent];
+			parent.height = std::max(parent.height, m_Skeleton[i].height + 1);
+		}
+		m_ChannelHeights.assign(m_Bones.size(), 0);
+		for (const SkeletonNode& node : m_Skeleton)
+		{
+			if (node.channel >= 0)
+				m_ChannelHeights[node.channel] = node.height;
+		}
+	}
+
+	float m_Duration;
+	int m_TicksPerSecond;
+	std::vector<Bone> m_Bones;
+	AssimpNodeData m_RootNode;
+	std::map<std::string, BoneInfo> m_BoneInfoMap;
+	std::vector<SkeletonNode> m_Skeleton;
+	std::vector<int> m_ChannelHeights;
+};
+
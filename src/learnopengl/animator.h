@@ -0,0 +1,129 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <map>
+#include <vector>
+#include <assimp/scene.h>
+#include <assimp/Importer.hpp>
+#include <learnopengl/animation.h>
+#include <learnopengl/bone.h>
+
+#include "profiler.h"
+
+class Animator
+{
+public:
+	static const int MAX_BONES = 100; // palette size; finalBonesMatrices[] of the BONE_UNIFORMS skinning shader
+
+	Animator(Animation* animation)
+	{
+		m_CurrentTime = 0.0;
+		m_CurrentAnimation = animation;
+		m_FinalBoneMatrices.assign(MAX_BONES, glm::mat4(1.0f));
+		Prepare();
+	}
+
+	void UpdateAnimation(float dt)
+	{
+		PROFILE_ZONE("Animator::UpdateAnimation");
+		if (m_CurrentAnimation)
+		{
+			AdvanceTime(dt);
+			int bones = EvaluatePoseAt(m_CurrentTime, m_FinalBoneMatrices.data(), m_FinalBoneMatrices.size(), 0);
+			PROFILE_COUNT("bones evaluated", bones);
+		}
+	}
+
+	// move the playback time only; for callers that evaluate into their own buffer
+	void AdvanceTime(float dt)
+	{
+		m_DeltaTime = dt;
+		if (m_CurrentAnimation)
+		{
+			m_CurrentTime += m_CurrentAnimation->GetTicksPerSecond() * dt;
+			m_CurrentTime = fmod(m_CurrentTime, m_CurrentAnimation->GetDuration());
+		}
+	}
+
+	bool HasAnimation() const { return m_CurrentAnimation != nullptr; }
+	const Animation* GetCurrentAnimation() const { return m_CurrentAnimation; }
+	float GetCurrentTime() const { return m_CurrentTime; }
+
+	void PlayAnimation(Animation* pAnimation)
+	{
+		m_CurrentAnimation = pAnimation;
+		m_CurrentTime = 0.0f;
+		Prepare();
+	}
+
+	// evaluate the pose at the current time into boneMatrices[0, count). Channels are sampled
+	// from this animator's key cursors into a component-wise pose, turned into local matrices
+	// four at a time, then one linear pass over the compiled skeleton accumulates them: no
+	// strings, map lookups or allocations. Bones whose index is outside the span are skipped,
+	// slots no bone writes to are left untouched.
+	void EvaluatePose(glm::mat4* boneMatrices, std::size_t count)
+	{
+		EvaluatePoseAt(m_CurrentTime, boneMatrices, count, 0);
+	}
+
+	// EvaluatePose at an arbitrary clip time, without moving the playback time. Channels of
+	// nodes less than skipLeafLevels levels above the leaves are not sampled; those nodes keep
+	// their bind pose relative to their parent. Returns the number of channels sampled.
+	int EvaluatePoseAt(float animationTime, glm::mat4* boneMatrices, std::size_t count, int skipLeafLevels)
+	{
+		const Animation& animation = *m_CurrentAnimation;
+		int channelCount = animation.GetChannelCount();
+		int sampled = 0;
+		for (int channel = 0; channel < channelCount; channel++)
+		{
+			if (animation.GetChannelHeight(channel) < skipLeafLevels)
+				continue;
+			animation.GetChannel(channel).Sample(animationTime, m_Cursors[channel], m_LocalPose, channel);
+			sampled++;
+		}
+		ComposeLocalTransforms(m_LocalPose, channelCount, m_LocalTransforms.data());
+
+		const std::vector<SkeletonNode>& skeleton = animation.GetSkeleton();
+		glm::mat4* globalTransforms = m_GlobalTransforms.data();
+		for (std::size_t i = 0; i < skeleton.size(); i++)
+		{
+			const SkeletonNode& node = skeleton[i];
+			bool animated = node.channel >= 0 && node.height >= skipLeafLevels;
+			const glm::mat4& nodeTransform = animated ? m_LocalTransforms[node.channel] : node.transformation;
+			globalTransforms[i] = node.parent >= 0 ? globalTransforms[node.parent] * nodeTransform : nodeTransform;
+			if (node.boneIndex >= 0 && (std::size_t)node.boneIndex < count)
+				boneMatrices[node.boneIndex] = globalTransforms[i] * node.offset;
+		}
+		return sampled;
+	}
+
+	const std::vector<glm::mat4>& GetFinalBoneMatrices() const
+	{
+		return m_FinalBoneMatrices;
+	}
+
+private:
+	// size the per-animation scratch once, so EvaluatePose never allocates
+	void Prepare()
+	{
+		if (!m_CurrentAnimation)
+			return;
+		int channelCount = m_CurrentAnimation->GetChannelCount();
+		m_Cursors.assign(channelCount, BoneCursor());
+		m_LocalPose.Resize(channelCount);
+		m_LocalTransforms.resize(channelCount);
+		m_GlobalTransforms.resize(m_CurrentAnimation->GetSkeleton().size());
+	}
+
+	std::vector<glm::mat4> m_FinalBoneMatrices;
+	// scratch for EvaluatePose: per channel key cursors, sampled pose and local matrices, and
+	// per skeleton node global transforms
+	std::vector<BoneCursor> m_Cursors;
+	LocalPose m_LocalPose;
+	std::vector<glm::mat4> m_LocalTransforms;
+	std::vector<glm::mat4> m_GlobalTransforms;
+	Animation* m_CurrentAnimation;
+	float m_CurrentTime;
+	float m_DeltaTime;
+
+};
@@ -0,0 +1,317 @@
+#pragma once
+
+/* Container for bone data */
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <assimp/scene.h>
+#include <list>
+#include <glm/glm.hpp>
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/gtx/quaternion.hpp>
+#include <learnopengl/assimp_glm_helpers.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BONE_USE_SSE 1
+#include <emmintrin.h>
+#endif
+
+// Keyframes of one component (position, rotation or scale) as two parallel arrays, so the key
+// search only touches the time stamps. Tracks whose keys are evenly spaced (every Mixamo
+// export, and every track after Animation::ResampleUniform) are found in O(1); the others
+// continue from the caller's cursor and fall back to a binary search after a seek.
+template<typename T>
+struct KeyTrack
+{
+	std::vector<float> times;
+	std::vector<T> values;
+	bool uniform = false;
+	float invStep = 0.0f;
+
+	// start of the key interval containing animationTime, clamped to the track
+	int Find(float animationTime, int& cursor) const
+	{
+		int last = (int)times.size() - 2;
+		if (uniform)
+		{
+			int index = (int)((animationTime - times[0]) * invStep);
+			cursor = index < 0 ? 0 : (index > last ? last : index);
+			return cursor;
+		}
+
+		int index = cursor < 0 ? 0 : (cursor > last ? last : cursor);
+		if (animationTime >= times[index])
+		{
+			// playing forward stays in the current interval or moves to the next one
+			if (index == last || animationTime < times[index + 1])
+				return cursor = index;
+			if (index + 1 == last || animationTime < times[index + 2])
+				return cursor = index + 1;
+		}
+		auto next = std::upper_bound(times.begin() + 1, times.end() - 1, animationTime);
+		return cursor = (int)(next - times.begin()) - 1;
+	}
+
+	// interpolation factor inside the interval starting at index
+	float Factor(int index, float animationTime) const
+	{
+		float factor = (animationTime - times[index]) / (times[index + 1] - times[index]);
+		return factor < 0.0f ? 0.0f : (factor > 1.0f ? 1.0f : factor);
+	}
+
+	void DetectUniform()
+	{
+		uniform = false;
+		if (times.size() < 2)
+			return;
+		float step = (times.back() - times.front()) / (times.size() - 1);
+		if (step <= 0.0f)
+			return;
+		for (size_t i = 1; i < times.size(); i++)
+		{
+			if (std::fabs(times[i] - (times[0] + i * step)) > step * 1e-3f)
+				return;
+		}
+		uniform = true;
+		invStep = 1.0f / step;
+	}
+};
+
+// per-instance playback position in each of a bone's tracks; the Bone itself is shared
+struct BoneCursor
+{
+	int position = 0;
+	int rotation = 0;
+	int scale = 0;
+};
+
+// sampled local translation/rotation/scale of many bones, one array per component (padded to
+// a multiple of four) so ComposeLocalTransforms can build four matrices per SSE operation
+struct LocalPose
+{
+	std::vector<float> tx, ty, tz;
+	std::vector<float> rx, ry, rz, rw;
+	std::vector<float> sx, sy, sz;
+
+	void Resize(size_t count)
+	{
+		size_t padded = (count + 3) & ~size_t(3);
+		for (std::vector<float>* component : { &tx, &ty, &tz, &rx, &ry, &rz, &sx, &sy, &sz })
+			component->assign(padded, 0.0f);
+		rw.assign(padded, 1.0f);
+	}
+
+	void Set(size_t slot, const glm::vec3& translation, const glm::quat& rotation, const glm::vec3& scale)
+	{
+		tx[slot] = translation.x; ty[slot] = translation.y; tz[slot] = translation.z;
+		rx[slot] = rotation.x; ry[slot] = rotation.y; rz[slot] = rotation.z; rw[slot] = rotation.w;
+		sx[slot] = scale.x; sy[slot] = scale.y; sz[slot] = scale.z;
+	}
+};
+
+// translate(t) * toMat4(r) * scale(s), written out directly instead of three mat4 products
+inline glm::mat4 ComposeTransform(const glm::vec3& t, const glm::quat& r, const glm::vec3& s)
+{
+	float xx = r.x * r.x, yy = r.y * r.y, zz = r.z * r.z;
+	float xy = r.x * r.y, xz = r.x * r.z, yz = r.y * r.z;
+	float wx = r.w * r.x, wy = r.w * r.y, wz = r.w * r.z;
+	glm::mat4 m;
+	m[0] = glm::vec4((1.0f - 2.0f * (yy + zz)) * s.x, 2.0f * (xy + wz) * s.x, 2.0f * (xz - wy) * s.x, 0.0f);
+	m[1] = glm::vec4(2.0f * (xy - wz) * s.y, (1.0f - 2.0f * (xx + zz)) * s.y, 2.0f * (yz + wx) * s.y, 0.0f);
+	m[2] = glm::vec4(2.0f * (xz + wy) * s.z, 2.0f * (yz - wx) * s.z, (1.0f - 2.0f * (xx + yy)) * s.z, 0.0f);
+	m[3] = glm::vec4(t, 1.0f);
+	return m;
+}
+
+// ComposeTransform for pose slots [0, count) into out[0, count)
+inline void ComposeLocalTransforms(const LocalPose& pose, size_t count, glm::mat4* out)
+{
+	size_t first = 0;
+#ifdef BONE_USE_SSE
+	const __m128 one = _mm_set1_ps(1.0f), two = _mm_set1_ps(2.0f), zero = _mm_setzero_ps();
+	for (; first < count; first += 4)
+	{
+		__m128 x = _mm_loadu_ps(&pose.rx[first]), y = _mm_loadu_ps(&pose.ry[first]);
+		__m128 z = _mm_loadu_ps(&pose.rz[first]), w = _mm_loadu_ps(&pose.rw[first]);
+		__m128 x2 = _mm_mul_ps(x, two), y2 = _mm_mul_ps(y, two), z2 = _mm_mul_ps(z, two);
+		__m128 xx = _mm_mul_ps(x, x2), yy = _mm_mul_ps(y, y2), zz = _mm_mul_ps(z, z2);
+		__m128 xy = _mm_mul_ps(x, y2), xz = _mm_mul_ps(x, z2), yz = _mm_mul_ps(y, z2);
+		__m128 wx = _mm_mul_ps(w, x2), wy = _mm_mul_ps(w, y2), wz = _mm_mul_ps(w, z2);
+		__m128 sx = _mm_loadu_ps(&pose.sx[first]), sy = _mm_loadu_ps(&pose.sy[first]), sz = _mm_loadu_ps(&pose.sz[first]);
+
+		// rows of each column for four bones, transposed into one column per bone
+		__m128 columns[4][4] = {
+			{ _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(yy, zz)), sx), _mm_mul_ps(_mm_add_ps(xy, wz), sx),
+			  _mm_mul_ps(_mm_sub_ps(xz, wy), sx), zero },
+			{ _mm_mul_ps(_mm_sub_ps(xy, wz), sy), _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, zz)), sy),
+			  _mm_mul_ps(_mm_add_ps(yz, wx), sy), zero },
+			{ _mm_mul_ps(_mm_add_ps(xz, wy), sz), _mm_mul_ps(_mm_sub_ps(yz, wx), sz),
+			  _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, yy)), sz), zero },
+			{ _mm_loadu_ps(&pose.tx[first]), _mm_loadu_ps(&pose.ty[first]), _mm_loadu_ps(&pose.tz[first]), one }
+		};
+		size_t lanes = count - first < 4 ? count - first : 4;
+		for (int column = 0; column < 4; column++)
+		{
+			__m128* rows = columns[column];
+			_MM_TRANSPOSE4_PS(rows[0], rows[1], rows[2], rows[3]);
+			for (size_t lane = 0; lane < lanes; lane++)
+				_mm_storeu_ps(&out[first + lane][column][0], rows[lane]);
+		}
+	}
+#endif
+	for (size_t i = first; i < count; i++)
+	{
+		out[i] = ComposeTransform(glm::vec3(pose.tx[i], pose.ty[i], pose.tz[i]),
+			glm::quat(pose.rw[i], pose.rx[i], pose.ry[i], pose.rz[i]), glm::vec3(pose.sx[i], pose.sy[i], pose.sz[i]));
+	}
+}
+
+class Bone
+{
+public:
+	Bone(const std::string& name, int ID, const aiNodeAnim* channel)
+		:
+		m_LocalTransform(1.0f),
+		m_Name(name),
+		m_ID(ID)
+	{
+		for (unsigned int i = 0; i < channel->mNumPositionKeys; ++i)
+		{
+			m_Positions.times.push_back((float)channel->mPositionKeys[i].mTime);
+			m_Positions.values.push_back(AssimpGLMHelpers::GetGLMVec(channel->mPositionKeys[i].mValue));
+		}
+		for (unsigned int i = 0; i < channel->mNumRotationKeys; ++i)
+		{
+			m_Rotations.times.push_back((float)channel->mRotationKeys[i].mTime);
+			m_Rotations.values.push_back(AssimpGLMHelpers::GetGLMQuat(channel->mRotationKeys[i].mValue));
+		}
+		for (unsigned int i = 0; i < channel->mNumScalingKeys; ++i)
+		{
+			m_Scales.times.push_back((float)channel->mScalingKeys[i].mTime);
+			m_Scales.values.push_back(AssimpGLMHelpers::GetGLMVec(channel->mScalingKeys[i].mValue));
+		}
+		m_Positions.DetectUniform();
+		m_Rotations.DetectUniform();
+		m_Scales.DetectUniform();
+	}
+
+	// from keys already converted to glm, e.g. a baked clip (see model_cache.h)
+	Bone(const std::string& name, int ID, KeyTrack<glm::vec3> positions, KeyTrack<glm::quat> rotations, KeyTrack<glm::vec3> scales)
+		:
+		m_Positions(std::move(positions)),
+		m_Rotations(std::move(rotations)),
+		m_Scales(std::move(scales)),
+		m_LocalTransform(1.0f),
+		m_Name(name),
+		m_ID(ID)
+	{
+		m_Positions.DetectUniform();
+		m_Rotations.DetectUniform();
+		m_Scales.DetectUniform();
+	}
+
+	// updates this bone's own transform; several animators sharing the bone should use Sample
+	void Update(float animationTime)
+	{
+		glm::vec3 translation, scale;
+		glm::quat rotation;
+		Sample(animationTime, m_Cursor, translation, rotation, scale);
+		m_LocalTransform = ComposeTransform(translation, rotation, scale);
+	}
+	glm::mat4 GetLocalTransform() { return m_LocalTransform; }
+	std::string GetBoneName() const { return m_Name; }
+	int GetBoneID() { return m_ID; }
+
+	void Sample(float animationTime, BoneCursor& cursor, glm::vec3& translation, glm::quat& rotation, glm::vec3& scale) const
+	{
+		translation = InterpolatePosition(animationTime, cursor.position);
+		rotation = InterpolateRotation(animationTime, cursor.rotation);
+		scale = InterpolateScaling(animationTime, cursor.scale);
+	}
+
+	void Sample(float animationTime, BoneCursor& cursor, LocalPose& pose, size_t slot) const
+	{
+		glm::vec3 translation, scale;
+		glm::quat rotation;
+		Sample(animationTime, cursor, translation, rotation, scale);
+		pose.Set(slot, translation, rotation, scale);
+	}
+
+	// replace the keys with ones spaced `step` ticks apart (the last interval is stretched to
+	// end on the original last key) so every lookup is O(1). Lossy when the source keys were
+	// not already on that grid.
+	void ResampleUniform(float step)
+	{
+		ResampleTrack(m_Positions, step, [this](float time, int& cursor) { return InterpolatePosition(time, cursor); });
+		ResampleTrack(m_Rotations, step, [this](float time, int& cursor) { return InterpolateRotation(time, cursor); });
+		ResampleTrack(m_Scales, step, [this](float time, int& cursor) { return InterpolateScaling(time, cursor); });
+		m_Cursor = BoneCursor();
+	}
+
+	bool IsUniform() const
+	{
+		return (m_Positions.uniform || m_Positions.times.size() < 2) && (m_Rotations.uniform || m_Rotations.times.size() < 2)
+			&& (m_Scales.uniform || m_Scales.times.size() < 2);
+	}
+
+private:
+	template<typename T, typename Interpolate>
+	static void ResampleTrack(KeyTrack<T>& track, float step, Interpolate interpolate)
+	{
+		if (track.times.size() < 2 || step <= 0.0f)
+			return;
+		float start = track.times.front(), duration = track.times.back() - start;
+		size_t count = std::max<size_t>(2, (size_t)std::ceil(duration / step) + 1);
+		float spacing = duration / (count - 1);
+		KeyTrack<T> resampled;
+		int cursor = 0;
+		for (size_t i = 0; i < count; i++)
+		{
+			float time = start + i * spacing;
+			resampled.times.push_back(time);
+			resampled.values.push_back(interpolate(time, cursor));
+		}
+		track = resampled;
+		track.DetectUniform();
+	}
+
+	glm::vec3 InterpolatePosition(float animationTime, int& cursor) const
+	{
+		if (m_Positions.values.size() == 1)
+			return m_Positions.values[0];
+
+		int p0Index = m_Positions.Find(animationTime, cursor);
+		return glm::mix(m_Positions.values[p0Index], m_Positions.values[p0Index + 1], m_Positions.Factor(p0Index, animationTime));
+	}
+
+	glm::quat InterpolateRotation(float animationTime, int& cursor) const
+	{
+		if (m_Rotations.values.size() == 1)
+			return glm::normalize(m_Rotations.values[0]);
+
+		int p0Index = m_Rotations.Find(animationTime, cursor);
+		glm::quat finalRotation = glm::slerp(m_Rotations.values[p0Index], m_Rotations.values[p0Index + 1],
+			m_Rotations.Factor(p0Index, animationTime));
+		return glm::normalize(finalRotation);
+	}
+
+	glm::vec3 InterpolateScaling(float animationTime, int& cursor) const
+	{
+		if (m_Scales.values.size() == 1)
+			return m_Scales.values[0];
+
+		int p0Index = m_Scales.Find(animationTime, cursor);
+		return glm::mix(m_Scales.values[p0Index], m_Scales.values[p0Index + 1], m_Scales.Factor(p0Index, animationTime));
+	}
+
+	KeyTrack<glm::vec3> m_Positions;
+	KeyTrack<glm::quat> m_Rotations;
+	KeyTrack<glm::vec3> m_Scales;
+	BoneCursor m_Cursor;
+
+	glm::mat4 m_LocalTransform;
+	std::string m_Name;
+	int m_ID;
+};
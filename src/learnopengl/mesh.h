@@ -0,0 +1,309 @@
+#ifndef MESH_H
+#define MESH_H
+
+#include <glad/glad.h> // holds all OpenGL type declarations
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <learnopengl/shader_m.h>
+
+#include "profiler.h"
+#include "render_queue.h"
+#include "vertex_formats.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+using namespace std;
+
+#define MAX_BONE_INFLUENCE 4
+
+struct Vertex {
+    // position
+    glm::vec3 Position;
+    // normal
+    glm::vec3 Normal;
+    // texCoords
+    glm::vec2 TexCoords;
+    // tangent
+    glm::vec3 Tangent;
+    // bitangent
+    glm::vec3 Bitangent;
+	//bone indexes which will influence this vertex
+	int m_BoneIDs[MAX_BONE_INFLUENCE];
+	//weights from each bone
+	float m_Weights[MAX_BONE_INFLUENCE];
+};
+
+struct Texture {
+    unsigned int id;
+    string type;
+    string path;
+};
+
+class Mesh {
+public:
+    // mesh Data
+    vector<Vertex>       vertices;
+    vector<unsigned int> indices;
+    vector<Texture>      textures;
+    unsigned int VAO;
+    // GPU layout of the vertex buffer (see vertex_formats.h). Compact meshes do not keep the
+    // CPU copy: vertices is emptied once the buffer is uploaded.
+    VertexFormat format;
+    size_t vertexCount;
+    size_t indexCount;
+    size_t vertexBufferSize; // bytes
+
+    // constructor
+    Mesh(vector<Vertex> vertices, vector<unsigned int> indices, vector<Texture> textures, VertexFormat format = VertexFormat::Full)
+    {
+        this->vertices = vertices;
+        this->indices = indices;
+        this->textures = textures;
+        this->format = format;
+        this->vertexCount = vertices.size();
+        this->indexCount = indices.size();
+        assignSamplerNames();
+
+        // now that we have all the required data, set the vertex buffers and its attribute pointers.
+        setupMesh();
+    }
+
+    // draws buffers that were uploaded before, by another Mesh (see ResourceManager); no CPU
+    // copy of the vertices and indices is kept
+    Mesh(const GpuMesh& gpu, vector<Texture> textures)
+    {
+        this->textures = textures;
+        this->format = gpu.format;
+        this->vertexCount = gpu.vertexCount;
+        this->indexCount = gpu.indexCount;
+        this->vertexBufferSize = gpu.vertexBufferSize;
+        VAO = gpu.VAO;
+        VBO = gpu.VBO;
+        EBO = gpu.EBO;
+        assignSamplerNames();
+    }
+
+    // the GL objects of this mesh, for handing them to a ResourceManager
+    GpuMesh gpu() const
+    {
+        GpuMesh result;
+        result.VAO = VAO;
+        result.VBO = VBO;
+        result.EBO = EBO;
+        result.vertexCount = vertexCount;
+        result.indexCount = indexCount;
+        result.vertexBufferSize = vertexBufferSize;
+        result.indexBufferSize = indexCount * sizeof(unsigned int);
+        result.format = format;
+        return result;
+    }
+
+    // render the mesh
+    void Draw(Shader &shader) 
+    {
+        // bind appropriate textures; the sampler names were built once and their locations are
+        // looked up once per shader
+        const vector<GLint>& locations = samplerLocations(shader.ID);
+        for(unsigned int i = 0; i < textures.size(); i++)
+        {
+            glActiveTexture(GL_TEXTURE0 + i); // active proper texture unit before binding
+            // now set the sampler to the correct texture unit
+            glUniform1i(locations[i], i);
+            // and finally bind the texture
+            glBindTexture(GL_TEXTURE_2D, textures[i].id);
+        }
+        // switch the normal map on where the mesh has one (shaders/model.fs)
+        if (normalMapLocation >= 0)
+            glUniform1i(normalMapLocation, hasNormalMap(textures.size()));
+        
+        // draw mesh; the VAO stays bound, whoever draws next binds its own
+        glBindVertexArray(VAO);
+        glDrawElements(GL_TRIANGLES, static_cast<unsigned int>(indexCount), GL_UNSIGNED_INT, 0);
+        PROFILE_COUNT("draw calls", 1);
+        PROFILE_COUNT("texture binds", textures.size());
+        PROFILE_COUNT("uniform uploads", textures.size() + (normalMapLocation >= 0 ? 1 : 0));
+
+        // always good practice to set everything back to defaults once configured.
+        glActiveTexture(GL_TEXTURE0);
+    }
+
+    // queue the mesh instead of drawing it right away (see render_queue.h); command carries
+    // the pass, depth, model and normal matrix, the mesh fills in program, textures and
+    // VAO. The queue binds them only where they differ from the previous draw
+    void Submit(RenderQueue& queue, Shader &shader, RenderCommand command = RenderCommand()) 
+    {
+        command.program = shader.ID;
+        command.vertexArray = VAO;
+        command.indexed = true;
+        command.count = static_cast<GLsizei>(indexCount);
+        command.textureCount = 0;
+        const vector<GLint>& locations = samplerLocations(shader.ID);
+        for(unsigned int i = 0; i < textures.size() && i < RenderCommand::MAX_TEXTURES; i++)
+            command.addTexture(GL_TEXTURE_2D, textures[i].id, locations[i]);
+        command.normalMapLocation = normalMapLocation;
+        command.normalMap = hasNormalMap(command.textureCount);
+        queue.submit(command);
+    }
+
+private:
+    // render data 
+    unsigned int VBO, EBO;
+    // sampler uniform of each texture (texture_diffuseN, texture_specularN, ...) and its
+    // location in the shader that was used last, with that shader's useNormalMap uniform
+    vector<string> samplerNames;
+    unsigned int samplerProgram = 0;
+    vector<GLint> samplerCache;
+    GLint normalMapLocation = -1;
+
+    // whether one of the first count textures is a normal map
+    bool hasNormalMap(size_t count) const
+    {
+        for(size_t i = 0; i < count && i < textures.size(); i++)
+        {
+            if(textures[i].type == "texture_normal")
+                return true;
+        }
+        return false;
+    }
+
+    void assignSamplerNames()
+    {
+        unsigned int diffuseNr  = 1;
+        unsigned int specularNr = 1;
+        unsigned int normalNr   = 1;
+        unsigned int heightNr   = 1;
+        samplerNames.clear();
+        for(unsigned int i = 0; i < textures.size(); i++)
+        {
+            // retrieve texture number (the N in diffuse_textureN)
+            string number;
+            string name = textures[i].type;
+            if(name == "texture_diffuse")
+                number = std::to_string(diffuseNr++);
+            else if(name == "texture_specular")
+                number = std::to_string(specularNr++); // transfer unsigned int to string
+            else if(name == "texture_normal")
+                number = std::to_string(normalNr++); // transfer unsigned int to string
+             else if(name == "texture_height")
+                number = std::to_string(heightNr++); // transfer unsigned int to string
+            samplerNames.push_back(name + number);
+        }
+        samplerProgram = 0;
+    }
+
+    const vector<GLint>& samplerLocations(unsigned int program)
+    {
+        if (program != samplerProgram || samplerCache.size() != samplerNames.size())
+        {
+            samplerCache.clear();
+            for (const string& name : samplerNames)
+                samplerCache.push_back(glGetUniformLocation(program, name.c_str()));
+            normalMapLocation = glGetUniformLocation(program, "useNormalMap");
+            samplerProgram = program;
+        }
+        return samplerCache;
+    }
+
+    // initializes all the buffer objects/arrays
+    void setupMesh()
+    {
+        // create buffers/arrays
+        glGenVertexArrays(1, &VAO);
+        glGenBuffers(1, &VBO);
+        glGenBuffers(1, &EBO);
+
+        glBindVertexArray(VAO);
+        // load data into vertex buffers
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        if (format != VertexFormat::Full)
+        {
+            setupCompact();
+            return;
+        }
+        // A great thing about structs is that their memory layout is sequential for all its items.
+        // The effect is that we can simply pass a pointer to the struct and it translates perfectly to a glm::vec3/2 array which
+        // again translates to 3/2 floats which translates to a byte array.
+        vertexBufferSize = vertices.size() * sizeof(Vertex);
+        glBufferData(GL_ARRAY_BUFFER, vertexBufferSize, &vertices[0], GL_STATIC_DRAW);  
+
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
+
+        // set the vertex attribute pointers
+        // vertex Positions
+        glEnableVertexAttribArray(0);	
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
+        // vertex normals
+        glEnableVertexAttribArray(1);	
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Normal));
+        // vertex texture coords
+        glEnableVertexAttribArray(2);	
+        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, TexCoords));
+        // vertex tangent
+        glEnableVertexAttribArray(3);
+        glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Tangent));
+        // vertex bitangent
+        glEnableVertexAttribArray(4);
+        glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Bitangent));
+		// ids
+		glEnableVertexAttribArray(5);
+		glVertexAttribIPointer(5, 4, GL_INT, sizeof(Vertex), (void*)offsetof(Vertex, m_BoneIDs));
+
+		// weights
+		glEnableVertexAttribArray(6);
+		glVertexAttribPointer(6, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, m_Weights));
+        glBindVertexArray(0);
+    }
+
+    // same attribute locations as the full layout, minus the bitangent (location 4), which the
+    // shaders rebuild from normal, tangent and sign:
+    //   1 normal vec2 (octahedral), 2 texCoords vec2, 3 tangent vec4 (octahedral xy, sign z),
+    //   5 bone ids ivec4, 6 weights vec4
+    void setupCompact()
+    {
+        bool skinned = format == VertexFormat::CompactSkinned;
+        size_t stride = skinned ? sizeof(CompactSkinnedVertex) : sizeof(CompactStaticVertex);
+        vector<unsigned char> packed(vertices.size() * stride);
+        for (size_t i = 0; i < vertices.size(); i++)
+        {
+            const Vertex& vertex = vertices[i];
+            // the static layout is a prefix of the skinned one
+            CompactSkinnedVertex compact;
+            compact.position = vertex.Position;
+            VertexPacking::encodeNormal(vertex.Normal, compact.normal);
+            VertexPacking::encodeTangent(vertex.Normal, vertex.Tangent, vertex.Bitangent, compact.tangent);
+            VertexPacking::encodeTexCoords(vertex.TexCoords, compact.texCoords);
+            if (skinned)
+                VertexPacking::encodeBoneWeights(vertex.m_BoneIDs, vertex.m_Weights, compact.boneIds, compact.weights);
+            memcpy(&packed[i * stride], &compact, stride);
+        }
+        vertexBufferSize = packed.size();
+        glBufferData(GL_ARRAY_BUFFER, packed.size(), packed.data(), GL_STATIC_DRAW);
+
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
+
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, (GLsizei)stride, (void*)offsetof(CompactSkinnedVertex, position));
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, (GLsizei)stride, (void*)offsetof(CompactSkinnedVertex, normal));
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, (GLsizei)stride, (void*)offsetof(CompactSkinnedVertex, texCoords));
+        glEnableVertexAttribArray(3);
+        glVertexAttribPointer(3, 4, GL_BYTE, GL_TRUE, (GLsizei)stride, (void*)offsetof(CompactSkinnedVertex, tangent));
+        if (skinned)
+        {
+            glEnableVertexAttribArray(5);
+            glVertexAttribIPointer(5, 4, GL_UNSIGNED_BYTE, (GLsizei)stride, (void*)offsetof(CompactSkinnedVertex, boneIds));
+            glEnableVertexAttribArray(6);
+            glVertexAttribPointer(6, 4, GL_UNSIGNED_BYTE, GL_TRUE, (GLsizei)stride, (void*)offsetof(CompactSkinnedVertex, weights));
+        }
+        glBindVertexArray(0);
+
+        vector<Vertex>().swap(vertices);
+    }
+};
+#endif
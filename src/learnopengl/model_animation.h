@@ -0,0 +1,239 @@
+#ifndef MODEL_H
+#define MODEL_H
+
+#include <glad/glad.h> 
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <stb_image.h>
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+#include <assimp/postprocess.h>
+
+#include <learnopengl/shader_m.h>
+#include <learnopengl/mesh.h>
+
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <map>
+#include <vector>
+#include <learnopengl/assimp_glm_helpers.h>
+#include <learnopengl/animdata.h>
+#include "model_cache.h"
+#include "profiler.h"
+#include "resource_manager.h"
+#include "texture_loader.h"
+
+using namespace std;
+
+class Model 
+{
+public:
+    // model data 
+    vector<Texture> textures_loaded;	// stores all the textures loaded so far, optimization to make sure textures aren't loaded more than once.
+    vector<Mesh>    meshes;
+    string directory;
+    bool gammaCorrection;
+    TextureLoader* textureLoader; // optional: decode material textures asynchronously
+    bool compactVertices;         // upload meshes in the compact static/skinned layouts (vertex_formats.h)
+    ResourceManager* resources;   // optional: share textures and vertex buffers with other models
+	
+	
+
+    // constructor, expects a filepath to a 3D model. With a textureLoader, material textures are
+    // returned as placeholders right away and filled in by textureLoader->update(). With
+    // compactVertices, meshes with bones use VertexFormat::CompactSkinned and the others
+    // VertexFormat::CompactStatic; draw them with shaders/model.vs (SKINNED / default variant).
+    // With resources, textures and meshes come from the ResourceManager (which loads textures
+    // through its own TextureLoader), so every further Model of the same file reuses them;
+    // call release() when the model is no longer drawn.
+    Model(string const &path, bool gamma = false, TextureLoader* textureLoader = nullptr, bool compactVertices = false,
+        ResourceManager* resources = nullptr)
+        : gammaCorrection(gamma), textureLoader(textureLoader), compactVertices(compactVertices), resources(resources)
+    {
+        loadModel(path);
+    }
+
+    // give the textures and meshes back to the ResourceManager; the model must not be drawn afterwards
+    void release()
+    {
+        if (!resources)
+            return;
+        for (TextureHandle handle : m_TextureHandles)
+            resources->release(handle);
+        for (MeshHandle handle : m_MeshHandles)
+            resources->release(handle);
+        m_TextureHandles.clear();
+        m_MeshHandles.clear();
+    }
+
+    // draws the model, and thus all its meshes
+    void Draw(Shader &shader)
+    {
+        for(unsigned int i = 0; i < meshes.size(); i++)
+            meshes[i].Draw(shader);
+    }
+
+    // queues all meshes with the pass, depth and model matrix of command (see render_queue.h)
+    void Submit(RenderQueue& queue, Shader &shader, const RenderCommand& command = RenderCommand())
+    {
+        for(unsigned int i = 0; i < meshes.size(); i++)
+            meshes[i].Submit(queue, shader, command);
+    }
+    
+	// bytes of vertex buffer memory over all meshes
+	size_t GetVertexMemory() const
+	{
+		size_t bytes = 0;
+		for (const Mesh& mesh : meshes)
+			bytes += mesh.vertexBufferSize;
+		return bytes;
+	}
+
+	auto& GetBoneInfoMap() { return m_BoneInfoMap; }
+	int& GetBoneCount() { return m_BoneCounter; }
+	
+
+private:
+
+	std::map<string, BoneInfo> m_BoneInfoMap;
+	int m_BoneCounter = 0;
+	vector<TextureHandle> m_TextureHandles;
+	vector<MeshHandle> m_MeshHandles;
+
+    // loads a model from its baked .bmdl (see model_cache.h) or, when there is none or it is
+    // out of date, with ASSIMP from any supported file, and stores the resulting meshes in the meshes vector.
+    void loadModel(string const &path)
+    {
+        PROFILE_ZONE("Model::loadModel");
+        ModelCache::BakedModel baked;
+        ModelCache::SceneData imported;
+        ModelCache::SceneView scene;
+        if (ModelCache::openBaked(path, baked))
+        {
+            scene = baked.view();
+        }
+        else
+        {
+            // read file via ASSIMP
+            Assimp::Importer importer;
+            const aiScene* source = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_CalcTangentSpace);
+            // check for errors
+            if(!source || source->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !source->mRootNode) // if is Not Zero
+            {
+                cout << "ERROR::ASSIMP:: " << importer.GetErrorString() << endl;
+                return;
+            }
+            ModelCache::extractScene(source, imported);
+            scene = imported.view();
+        }
+        // retrieve the directory path of the filepath
+        directory = path.substr(0, path.find_last_of('/'));
+
+        for (const ModelCache::BoneView& bone : scene.bones)
+            m_BoneInfoMap[bone.name] = bone.info;
+        m_BoneCounter = scene.boneCount;
+        for (size_t i = 0; i < scene.meshes.size(); i++)
+            meshes.push_back(processMesh(scene.meshes[i], path, i));
+    }
+
+	Mesh processMesh(const ModelCache::MeshView& mesh, const string& path, size_t index)
+	{
+		vector<Texture> textures;
+		for (const ModelCache::TextureView& texture : mesh.textures)
+			textures.push_back(loadMaterialTexture(texture.path, texture.type));
+
+		VertexFormat format = VertexFormat::Full;
+		if (compactVertices)
+			format = mesh.skinned ? VertexFormat::CompactSkinned : VertexFormat::CompactStatic;
+		auto upload = [&]() {
+			return Mesh(vector<Vertex>(mesh.vertices, mesh.vertices + mesh.vertexCount),
+				vector<unsigned int>(mesh.indices, mesh.indices + mesh.indexCount), textures, format);
+		};
+		if (!resources)
+			return upload();
+
+		// one upload per file, mesh and layout, shared by every Model of that file
+		string key = ResourceManager::normalise(path) + "#" + std::to_string(index) + "/" + std::to_string(static_cast<int>(format));
+		MeshHandle handle = resources->acquireMesh(key, [&]() { return upload().gpu(); });
+		m_MeshHandles.push_back(handle);
+		return Mesh(resources->mesh(handle), textures);
+	}
+
+
+	unsigned int TextureFromFile(const char* path, const string& directory, bool gamma = false)
+	{
+		PROFILE_ZONE("TextureFromFile");
+		string filename = string(path);
+		filename = directory + '/' + filename;
+
+		unsigned int textureID;
+		glGenTextures(1, &textureID);
+
+		int width, height, nrComponents;
+		unsigned char* data = stbi_load(filename.c_str(), &width, &height, &nrComponents, 0);
+		if (data)
+		{
+			GLenum format;
+			if (nrComponents == 1)
+				format = GL_RED;
+			else if (nrComponents == 3)
+				format = GL_RGB;
+			else if (nrComponents == 4)
+				format = GL_RGBA;
+
+			glBindTexture(GL_TEXTURE_2D, textureID);
+			glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+			PROFILE_COUNT("bytes uploaded", static_cast<size_t>(width) * height * nrComponents);
+			glGenerateMipmap(GL_TEXTURE_2D);
+
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+			stbi_image_free(data);
+		}
+		else
+		{
+			std::cout << "Texture failed to load at path: " << path << std::endl;
+			stbi_image_free(data);
+		}
+
+		return textureID;
+	}
+    
+    // loads a material texture unless a texture with the same path was loaded before.
+    // the required info is returned as a Texture struct.
+    Texture loadMaterialTexture(const char* path, const char* typeName)
+    {
+        // check if texture was loaded before and if so, reuse it
+        for(unsigned int j = 0; j < textures_loaded.size(); j++)
+        {
+            if(std::strcmp(textures_loaded[j].path.data(), path) == 0)
+                return textures_loaded[j]; // a texture with the same filepath has already been loaded. (optimization)
+        }
+        // if texture hasn't been loaded already, load it
+        Texture texture;
+        if (resources)
+        {
+            TextureHandle handle = resources->acquireTexture(this->directory + '/' + path);
+            m_TextureHandles.push_back(handle);
+            texture.id = resources->texture(handle);
+        }
+        else if (textureLoader)
+            texture.id = textureLoader->load2D(this->directory + '/' + path);
+        else
+            texture.id = TextureFromFile(path, this->directory);
+        texture.type = typeName;
+        texture.path = path;
+        textures_loaded.push_back(texture);  // store it as texture loaded for entire model, to ensure we won't unnecessary load duplicate textures.
+        return texture;
+    }
+};
+
+
+
+#endif
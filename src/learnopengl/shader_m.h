@@ -0,0 +1,298 @@
+#ifndef SHADER_H
+#define SHADER_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// resolved uniform location; obtain once with Shader::uniform() and use it in the hot path
+// instead of passing uniform names (a handle of an inactive uniform has location -1 and is ignored by GL)
+struct UniformHandle
+{
+    GLint location = -1;
+    bool valid() const { return location >= 0; }
+};
+
+class Shader
+{
+public:
+    unsigned int ID;
+    // constructor generates the shader on the fly
+    // ------------------------------------------------------------------------
+    Shader(const char* vertexPath, const char* fragmentPath)
+    {
+        // 1. retrieve the vertex/fragment source code from filePath
+        std::string vertexCode;
+        std::string fragmentCode;
+        std::ifstream vShaderFile;
+        std::ifstream fShaderFile;
+        // ensure ifstream objects can throw exceptions:
+        vShaderFile.exceptions (std::ifstream::failbit | std::ifstream::badbit);
+        fShaderFile.exceptions (std::ifstream::failbit | std::ifstream::badbit);
+        try 
+        {
+            // open files
+            vShaderFile.open(vertexPath);
+            fShaderFile.open(fragmentPath);
+            std::stringstream vShaderStream, fShaderStream;
+            // read file's buffer contents into streams
+            vShaderStream << vShaderFile.rdbuf();
+            fShaderStream << fShaderFile.rdbuf();		
+            // close file handlers
+            vShaderFile.close();
+            fShaderFile.close();
+            // convert stream into string
+            vertexCode = vShaderStream.str();
+            fragmentCode = fShaderStream.str();			
+        }
+        catch (std::ifstream::failure& e)
+        {
+            std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << e.what() << std::endl;
+        }
+        const char* vShaderCode = vertexCode.c_str();
+        const char * fShaderCode = fragmentCode.c_str();
+        // 2. compile shaders
+        unsigned int vertex, fragment;
+        // vertex shader
+        vertex = glCreateShader(GL_VERTEX_SHADER);
+        glShaderSource(vertex, 1, &vShaderCode, NULL);
+        glCompileShader(vertex);
+        checkCompileErrors(vertex, "VERTEX");
+        // fragment Shader
+        fragment = glCreateShader(GL_FRAGMENT_SHADER);
+        glShaderSource(fragment, 1, &fShaderCode, NULL);
+        glCompileShader(fragment);
+        checkCompileErrors(fragment, "FRAGMENT");
+        // shader Program
+        ID = glCreateProgram();
+        glAttachShader(ID, vertex);
+        glAttachShader(ID, fragment);
+        glLinkProgram(ID);
+        checkCompileErrors(ID, "PROGRAM");
+        // delete the shaders as they're linked into our program now and no longer necessary
+        glDeleteShader(vertex);
+        glDeleteShader(fragment);
+        // resolve all uniform locations once, so setters never have to ask the driver
+        cacheUniformLocations();
+    }
+    // adopt an already linked program (e.g. built by ShaderManager from a cached binary)
+    // ------------------------------------------------------------------------
+    explicit Shader(unsigned int program) : ID(program)
+    {
+        cacheUniformLocations();
+    }
+    // the program was linked again in place (shader hot reload): uniform locations may have
+    // moved and uniform block bindings are back to 0, so resolve and apply them again.
+    // Plain uniform values are reset too and have to be set again by the owner
+    // ------------------------------------------------------------------------
+    void relinked()
+    {
+        cacheUniformLocations();
+        for (const auto& binding : blockBindings)
+            applyUniformBlock(binding.first, binding.second);
+    }
+    // activate the shader
+    // ------------------------------------------------------------------------
+    void use() const
+    { 
+        glUseProgram(ID); 
+    }
+    // look up a uniform once (e.g. at load time); the returned handle is used by the setters below
+    // ------------------------------------------------------------------------
+    UniformHandle uniform(const std::string &name) const
+    {
+        UniformHandle handle;
+        auto it = uniformLocations.find(name);
+        if (it != uniformLocations.end())
+            handle.location = it->second;
+        return handle;
+    }
+    // attach a uniform block (e.g. the per-frame camera/light block) to a buffer binding point
+    // (remembered, so relinked() can restore it)
+    // ------------------------------------------------------------------------
+    void bindUniformBlock(const std::string &blockName, unsigned int bindingPoint)
+    {
+        blockBindings.emplace_back(blockName, bindingPoint);
+        applyUniformBlock(blockName, bindingPoint);
+    }
+    // utility uniform functions; the name overloads resolve through the location cache
+    // ------------------------------------------------------------------------
+    void setBool(UniformHandle handle, bool value) const
+    {         
+        glUniform1i(handle.location, (int)value); 
+    }
+    void setBool(const std::string &name, bool value) const
+    {         
+        setBool(uniform(name), value); 
+    }
+    // ------------------------------------------------------------------------
+    void setInt(UniformHandle handle, int value) const
+    { 
+        glUniform1i(handle.location, value); 
+    }
+    void setInt(const std::string &name, int value) const
+    { 
+        setInt(uniform(name), value); 
+    }
+    // ------------------------------------------------------------------------
+    void setFloat(UniformHandle handle, float value) const
+    { 
+        glUniform1f(handle.location, value); 
+    }
+    void setFloat(const std::string &name, float value) const
+    { 
+        setFloat(uniform(name), value); 
+    }
+    // ------------------------------------------------------------------------
+    void setVec2(UniformHandle handle, const glm::vec2 &value) const
+    { 
+        glUniform2fv(handle.location, 1, &value[0]); 
+    }
+    void setVec2(const std::string &name, const glm::vec2 &value) const
+    { 
+        setVec2(uniform(name), value); 
+    }
+    void setVec2(const std::string &name, float x, float y) const
+    { 
+        glUniform2f(uniform(name).location, x, y); 
+    }
+    // ------------------------------------------------------------------------
+    void setVec3(UniformHandle handle, const glm::vec3 &value) const
+    { 
+        glUniform3fv(handle.location, 1, &value[0]); 
+    }
+    void setVec3(const std::string &name, const glm::vec3 &value) const
+    { 
+        setVec3(uniform(name), value); 
+    }
+    void setVec3(const std::string &name, float x, float y, float z) const
+    { 
+        glUniform3f(uniform(name).location, x, y, z); 
+    }
+    // ------------------------------------------------------------------------
+    void setVec4(UniformHandle handle, const glm::vec4 &value) const
+    { 
+        glUniform4fv(handle.location, 1, &value[0]); 
+    }
+    void setVec4(const std::string &name, const glm::vec4 &value) const
+    { 
+        setVec4(uniform(name), value); 
+    }
+    void setVec4(const std::string &name, float x, float y, float z, float w) const
+    { 
+        glUniform4f(uniform(name).location, x, y, z, w); 
+    }
+    // ------------------------------------------------------------------------
+    void setMat2(UniformHandle handle, const glm::mat2 &mat) const
+    {
+        glUniformMatrix2fv(handle.location, 1, GL_FALSE, &mat[0][0]);
+    }
+    void setMat2(const std::string &name, const glm::mat2 &mat) const
+    {
+        setMat2(uniform(name), mat);
+    }
+    // ------------------------------------------------------------------------
+    void setMat3(UniformHandle handle, const glm::mat3 &mat) const
+    {
+        glUniformMatrix3fv(handle.location, 1, GL_FALSE, &mat[0][0]);
+    }
+    void setMat3(const std::string &name, const glm::mat3 &mat) const
+    {
+        setMat3(uniform(name), mat);
+    }
+    // ------------------------------------------------------------------------
+    void setMat4(UniformHandle handle, const glm::mat4 &mat) const
+    {
+        glUniformMatrix4fv(handle.location, 1, GL_FALSE, &mat[0][0]);
+    }
+    void setMat4(const std::string &name, const glm::mat4 &mat) const
+    {
+        setMat4(uniform(name), mat);
+    }
+    // upload count consecutive matrices of a uniform array starting at handle
+    void setMat4Array(UniformHandle handle, const glm::mat4 *mats, int count) const
+    {
+        glUniformMatrix4fv(handle.location, count, GL_FALSE, &mats[0][0][0]);
+    }
+
+private:
+    // name -> location of every active uniform; array elements are registered as "name[i]"
+    // and the bare array name maps to element 0
+    std::unordered_map<std::string, GLint> uniformLocations;
+    // uniform blocks attached with bindUniformBlock()
+    std::vector<std::pair<std::string, unsigned int>> blockBindings;
+
+    void applyUniformBlock(const std::string &blockName, unsigned int bindingPoint) const
+    {
+        unsigned int blockIndex = glGetUniformBlockIndex(ID, blockName.c_str());
+        if (blockIndex != GL_INVALID_INDEX)
+            glUniformBlockBinding(ID, blockIndex, bindingPoint);
+    }
+
+    // query every active uniform of the linked program once
+    // ------------------------------------------------------------------------
+    void cacheUniformLocations()
+    {
+        uniformLocations.clear();
+        GLint count = 0;
+        glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+        for (GLint i = 0; i < count; i++)
+        {
+            GLchar name[256];
+            GLsizei length = 0;
+            GLint size = 0;
+            GLenum type = 0;
+            glGetActiveUniform(ID, (GLuint)i, sizeof(name), &length, &size, &type, name);
+            GLint location = glGetUniformLocation(ID, name);
+            if (location < 0)
+                continue; // member of a uniform block
+
+            std::string uniformName(name, length);
+            std::string::size_type bracket = uniformName.find('[');
+            if (bracket == std::string::npos)
+            {
+                uniformLocations[uniformName] = location;
+                continue;
+            }
+            // array: elements have consecutive locations
+            std::string baseName = uniformName.substr(0, bracket);
+            uniformLocations[baseName] = location;
+            for (GLint element = 0; element < size; element++)
+                uniformLocations[baseName + "[" + std::to_string(element) + "]"] = location + element;
+        }
+    }
+
+    // utility function for checking shader compilation/linking errors.
+    // ------------------------------------------------------------------------
+    void checkCompileErrors(GLuint shader, std::string type)
+    {
+        GLint success;
+        GLchar infoLog[1024];
+        if (type != "PROGRAM")
+        {
+            glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+            if (!success)
+            {
+                glGetShaderInfoLog(shader, 1024, NULL, infoLog);
+                std::cout << "ERROR::SHADER_COMPILATION_ERROR of type: " << type << "\n" << infoLog << "\n -- --------------------------------------------------- -- " << std::endl;
+            }
+        }
+        else
+        {
+            glGetProgramiv(shader, GL_LINK_STATUS, &success);
+            if (!success)
+            {
+                glGetProgramInfoLog(shader, 1024, NULL, infoLog);
+                std::cout << "ERROR::PROGRAM_LINKING_ERROR of type: " << type << "\n" << infoLog << "\n -- --------------------------------------------------- -- " << std::endl;
+            }
+        }
+    }
+};
+#endif
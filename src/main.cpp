@@ -1,6 +1,5 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
-#include <stb_image.h>
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -9,66 +8,100 @@
 #include <learnopengl/filesystem.h>
 #include <learnopengl/shader_m.h>
 
+#include "tile_grid.h"
+#include "map_mesher.h"
+#include "simulation.h"
+#include "input_log.h"
+#include "benchmark_report.h"
+#include "frame_uniforms.h"
+#include "texture_loader.h"
+#include "resource_manager.h"
+#include "render_queue.h"
+#include "profiler.h"
+#include "gpu_profiler.h"
+
 #include <iostream>
 #include <vector>
 #include <random>
 #include <algorithm>
 #include <functional>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <fstream>
 
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
-void processInput(GLFWwindow *window, std::vector<std::pair<int, int>>& breakableBlockPositions, 
-                 std::mt19937& gen, const std::function<void(std::vector<std::pair<int, int>>&, std::mt19937&)>& generateBlocks);
-unsigned int loadCubemap(const std::vector<std::string>& faces);
+std::uint8_t processInput(GLFWwindow *window);
+std::string assetPath(const std::string& relativePath);
 
 // settings
 const unsigned int SCR_WIDTH = 800;
 const unsigned int SCR_HEIGHT = 600;
 
-// Function to load texture
-unsigned int loadTexture(const char* path)
+// command line options
+// --headless           render offscreen without showing a window, then write a benchmark report
+// --frames <n>         number of frames rendered in headless mode (default 600)
+// --seed <n>           seed for the breakable block layout (headless default 1337, otherwise random)
+// --report <path>      where the headless JSON report is written (default benchmark_report.json)
+// --texture-threads <n> image decode threads (default: spare hardware threads, 0 = decode serially on the main thread)
+// --no-baked-textures  ignore baked .btex containers and always decode the PNGs
+// --map-size <n>       width and height of the map in cells (default 15)
+// --record <path>      write the commands of every simulation tick to an input log (see tools/replay.cpp)
+// --shader-cache <dir> where linked shader program binaries are cached (default shader_cache)
+// --no-shader-cache    always compile shaders from source
+// --hot-reload         relink shaders when their files change (default in debug builds)
+// --profile <path>     capture profiler zones and counters, written as a Chrome trace on exit (PALBOM_PROFILER builds)
+struct LaunchOptions
 {
-    unsigned int textureID;
-    glGenTextures(1, &textureID);
+    bool headless = false;
+    int frames = 600;
+    bool hasSeed = false;
+    unsigned int seed = 1337;
+    std::string reportPath = "benchmark_report.json";
+    int textureThreads = -1;
+    bool bakedTextures = true;
+    int mapSize = 15;
+    std::string recordPath;
+    std::string shaderCachePath = "shader_cache";
+    bool shaderCache = true;
+#ifdef NDEBUG
+    bool hotReload = false;
+#else
+    bool hotReload = true;
+#endif
+    std::string profilePath;
+};
+bool parseArguments(int argc, char* argv[], LaunchOptions& options);
+int runHeadlessBenchmark(const LaunchOptions& options, BenchmarkReport& report, const std::function<RenderStats()>& renderFrame);
 
-    int width, height, nrComponents;
-    unsigned char *data = stbi_load(path, &width, &height, &nrComponents, 0);
-    if (data)
-    {
-        GLenum format;
-        if (nrComponents == 1)
-            format = GL_RED;
-        else if (nrComponents == 3)
-            format = GL_RGB;
-        else if (nrComponents == 4)
-            format = GL_RGBA;
-
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-        stbi_image_free(data);
-    }
-    else
-    {
-        std::cout << "Texture failed to load at path: " << path << std::endl;
-        stbi_image_free(data);
-    }
+int main(int argc, char* argv[])
+{
+    LaunchOptions options;
+    if (!parseArguments(argc, argv, options))
+        return -1;
+#if PALBOM_PROFILER
+    if (!options.profilePath.empty())
+        Profiler::instance().setCapturing(true);
+    PROFILE_THREAD("main");
+#else
+    if (!options.profilePath.empty())
+        std::cout << "--profile ignored: built with PALBOM_PROFILER=OFF" << std::endl;
+#endif
 
-    return textureID;
-}
+    // startup milestones are measured from here
+    auto startupBegin = std::chrono::steady_clock::now();
+    auto millisecondsSinceStartup = [&]() {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startupBegin).count();
+    };
 
-int main()
-{
     // glfw: initialize and configure
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    if (options.headless)
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
 
 #ifdef __APPLE__
     glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
@@ -95,115 +128,35 @@ int main()
     // configure global opengl state
     glEnable(GL_DEPTH_TEST);
 
-    // build and compile shaders
-    Shader shader("shaders/tile.vs", "shaders/tile.fs");
-    Shader skyboxShader("shaders/skybox.vs", "shaders/skybox.fs");
-
-    // set up vertex data for a 3D block (cube)
-    float blockHeight = 0.2f; // Height of each block
-    float blockSize = 1.0f;
-    // positions          // normals           // texture coords
-    float vertices[] = {
-        // Top face (normal: 0, 1, 0)
-         0.5f,  blockHeight,  0.5f,   0.0f, 1.0f, 0.0f,   1.0f, 1.0f,
-         0.5f,  blockHeight, -0.5f,   0.0f, 1.0f, 0.0f,   1.0f, 0.0f,
-        -0.5f,  blockHeight, -0.5f,   0.0f, 1.0f, 0.0f,   0.0f, 0.0f,
-        -0.5f,  blockHeight,  0.5f,   0.0f, 1.0f, 0.0f,   0.0f, 1.0f,
-        // Bottom face (normal: 0, -1, 0)
-         0.5f,  0.0f, -0.5f,   0.0f, -1.0f, 0.0f,   1.0f, 1.0f,
-         0.5f,  0.0f,  0.5f,   0.0f, -1.0f, 0.0f,   1.0f, 0.0f,
-        -0.5f,  0.0f,  0.5f,   0.0f, -1.0f, 0.0f,   0.0f, 0.0f,
-        -0.5f,  0.0f, -0.5f,   0.0f, -1.0f, 0.0f,   0.0f, 1.0f,
-        // Front face (normal: 0, 0, 1)
-         0.5f,  0.0f,  0.5f,   0.0f, 0.0f, 1.0f,   1.0f, 0.0f,
-         0.5f,  blockHeight,  0.5f,   0.0f, 0.0f, 1.0f,   1.0f, 1.0f,
-        -0.5f,  blockHeight,  0.5f,   0.0f, 0.0f, 1.0f,   0.0f, 1.0f,
-        -0.5f,  0.0f,  0.5f,   0.0f, 0.0f, 1.0f,   0.0f, 0.0f,
-        // Back face (normal: 0, 0, -1)
-         0.5f,  blockHeight, -0.5f,   0.0f, 0.0f, -1.0f,   1.0f, 1.0f,
-         0.5f,  0.0f, -0.5f,   0.0f, 0.0f, -1.0f,   1.0f, 0.0f,
-        -0.5f,  0.0f, -0.5f,   0.0f, 0.0f, -1.0f,   0.0f, 0.0f,
-        -0.5f,  blockHeight, -0.5f,   0.0f, 0.0f, -1.0f,   0.0f, 1.0f,
-        // Right face (normal: 1, 0, 0)
-         0.5f,  0.0f, -0.5f,   1.0f, 0.0f, 0.0f,   0.0f, 0.0f,
-         0.5f,  blockHeight, -0.5f,   1.0f, 0.0f, 0.0f,   0.0f, 1.0f,
-         0.5f,  blockHeight,  0.5f,   1.0f, 0.0f, 0.0f,   1.0f, 1.0f,
-         0.5f,  0.0f,  0.5f,   1.0f, 0.0f, 0.0f,   1.0f, 0.0f,
-        // Left face (normal: -1, 0, 0)
-        -0.5f,  blockHeight, -0.5f,   -1.0f, 0.0f, 0.0f,   0.0f, 1.0f,
-        -0.5f,  0.0f, -0.5f,   -1.0f, 0.0f, 0.0f,   0.0f, 0.0f,
-        -0.5f,  0.0f,  0.5f,   -1.0f, 0.0f, 0.0f,   1.0f, 0.0f,
-        -0.5f,  blockHeight,  0.5f,   -1.0f, 0.0f, 0.0f,   1.0f, 1.0f
-    };
-    unsigned int indices[] = {
-        // Top face
-        0, 1, 2,  2, 3, 0,
-        // Bottom face
-        4, 5, 6,  6, 7, 4,
-        // Front face
-        8, 9, 10,  10, 11, 8,
-        // Back face
-        12, 13, 14,  14, 15, 12,
-        // Right face
-        16, 17, 18,  18, 19, 16,
-        // Left face
-        20, 21, 22,  22, 23, 20
-    };
-
-    unsigned int VBO, VAO, EBO;
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    glGenBuffers(1, &EBO);
-
-    glBindVertexArray(VAO);
-
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-    // position attribute
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    // normal attribute
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    // texture coord attribute
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
-    glEnableVertexAttribArray(2);
-
-    // load and create texture
-    stbi_set_flip_vertically_on_load(true);
-    std::string texturePath = FileSystem::getPath("assets/Floor/concrete_wall_07_basecolor_1k.png");
-    unsigned int floorTexture = loadTexture(texturePath.c_str());
-    if (floorTexture == 0)
-    {
-        std::cout << "Failed to load floor texture. Trying alternative path..." << std::endl;
-        // Try direct path as fallback
-        floorTexture = loadTexture("assets/Floor/concrete_wall_07_basecolor_1k.png");
-    }
-
-    std::string borderTexturePath = FileSystem::getPath("assets/Unbreakable_Block/tudor_wall_01_basecolor_1k.png");
-    unsigned int borderTexture = loadTexture(borderTexturePath.c_str());
-    if (borderTexture == 0)
-    {
-        std::cout << "Failed to load border texture. Trying alternative path..." << std::endl;
-        borderTexture = loadTexture("assets/Unbreakable_Block/tudor_wall_01_basecolor_1k.png");
-    }
-
-    std::string breakableTexturePath = FileSystem::getPath("assets/Breakable_Block/wood_05_baseColor_1k.png");
-    unsigned int breakableTexture = loadTexture(breakableTexturePath.c_str());
-    if (breakableTexture == 0)
-    {
-        std::cout << "Failed to load breakable texture. Trying alternative path..." << std::endl;
-        breakableTexture = loadTexture("assets/Breakable_Block/wood_05_baseColor_1k.png");
-    }
-
+    // load and create textures: decoding runs on worker threads, the textures show a
+    // placeholder until renderFrame() has streamed the pixels in (see texture_loader.h)
+    TextureLoader textureLoader(options.textureThreads);
+    textureLoader.setUseBaked(options.bakedTextures);
+    const double TEXTURE_UPLOAD_BUDGET_MS = 2.0; // per frame
+
+    // textures, meshes and shaders are owned and shared by the resource manager
+    ResourceManager resources(textureLoader);
+
+    // build and compile shaders; linked programs come from the binary cache when the sources
+    // and the driver are unchanged, and relink while running when their files change (development)
+    ShaderManager& shaderManager = resources.shaderManager();
+    if (options.shaderCache)
+        shaderManager.enableBinaryCache(options.shaderCachePath, (GLADloadproc)glfwGetProcAddress);
+    shaderManager.setHotReload(options.hotReload && !options.headless);
+    Shader& shader = resources.shader(resources.acquireShader("shaders/tile.vs", "shaders/tile.fs"));
+    Shader& skyboxShader = resources.shader(resources.acquireShader("shaders/skybox.vs", "shaders/skybox.fs"));
+
+    unsigned int floorTexture = resources.texture(resources.acquireTexture(assetPath("assets/Floor/concrete_wall_07_basecolor_1k.png")));
+    unsigned int borderTexture = resources.texture(resources.acquireTexture(assetPath("assets/Unbreakable_Block/tudor_wall_01_basecolor_1k.png")));
+    unsigned int breakableTexture = resources.texture(resources.acquireTexture(assetPath("assets/Breakable_Block/wood_05_baseColor_1k.png")));
+
+    // sampler units never change; camera and light come from the shared FrameUniforms block
     shader.use();
-    shader.setInt("texture1", 0);
+    shader.setInt(shader.uniform("texture1"), 0);
+    shader.bindUniformBlock(FrameUniforms::BLOCK_NAME, FrameUniforms::BINDING_POINT);
     skyboxShader.use();
-    skyboxShader.setInt("skybox", 0);
+    skyboxShader.setInt(skyboxShader.uniform("skybox"), 0);
+    skyboxShader.bindUniformBlock(FrameUniforms::BLOCK_NAME, FrameUniforms::BINDING_POINT);
 
     // Skybox setup
     float skyboxVertices[] = {
@@ -260,263 +213,316 @@ int main()
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
 
     std::vector<std::string> skyboxFaces = {
-        FileSystem::getPath("assets/Background/px.png"),
-        FileSystem::getPath("assets/Background/nx.png"),
-        FileSystem::getPath("assets/Background/py.png"),
-        FileSystem::getPath("assets/Background/ny.png"),
-        FileSystem::getPath("assets/Background/pz.png"),
-        FileSystem::getPath("assets/Background/nz.png")
+        assetPath("assets/Background/px.png"),
+        assetPath("assets/Background/nx.png"),
+        assetPath("assets/Background/py.png"),
+        assetPath("assets/Background/ny.png"),
+        assetPath("assets/Background/pz.png"),
+        assetPath("assets/Background/nz.png")
     };
-    stbi_set_flip_vertically_on_load(false);
-    unsigned int cubemapTexture = loadCubemap(skyboxFaces);
-    stbi_set_flip_vertically_on_load(true);
+    unsigned int cubemapTexture = resources.texture(resources.acquireCubemap(skyboxFaces));
 
     // Map dimensions
-    const int MAP_SIZE = 15;
+    const int MAP_SIZE = options.mapSize;
     const float TILE_SIZE = 1.0f;
     const float MAP_OFFSET = -(MAP_SIZE - 1) * TILE_SIZE / 2.0f;
 
-    // Helper function to check if a position is a red block (unbreakable pattern)
-    auto isRedBlock = [](int x, int z) -> bool {
-        // Red blocks are placed at even x and even z (2,4,6,8,10,12)
-        // This matches the current rendering pattern
-        return (x >= 2 && x <= 12 && x % 2 == 0 && 
-                z >= 2 && z <= 12 && z % 2 == 0);
-    };
-
-    // Helper function to check if a position is a green cell (player spawn)
-    // Green cells are 2x2 clusters at top-left and bottom-right
-    // Top-left cluster: (1,1), (1,2), (2,1), (2,2)
-    // Bottom-right cluster: (12,12), (12,13), (13,12), (13,13)
-    auto isGreenCell = [](int x, int z) -> bool {
-        // Top-left 2x2 cluster
-        if ((x == 1 || x == 2) && (z == 1 || z == 2))
-            return true;
-        // Bottom-right 2x2 cluster
-        if ((x == 12 || x == 13) && (z == 12 || z == 13))
-            return true;
-        return false;
-    };
-
-    // Helper function to check if a position is a white cell (where breakable blocks can be placed)
-    auto isWhiteCell = [&](int x, int z) -> bool {
-        // Not border (x=0, x=14, z=0, z=14)
-        if (x == 0 || x == MAP_SIZE - 1 || z == 0 || z == MAP_SIZE - 1) 
-            return false;
-        // Not red block (pattern blocks)
-        if (isRedBlock(x, z)) 
-            return false;
-        // Not green cell (player spawn areas) - IMPORTANT: No breakable blocks here!
-        if (isGreenCell(x, z)) 
-            return false;
-        return true;
-    };
-
-    // Function to generate random breakable block positions
-    auto generateBreakableBlocks = [&](std::vector<std::pair<int, int>>& positions, std::mt19937& generator) {
-        positions.clear();
-        std::uniform_real_distribution<float> dis(0.0f, 1.0f);
-        const float BREAKABLE_BLOCK_PROBABILITY = 0.6f; // 60% chance
-        
-        for (int x = 1; x < MAP_SIZE - 1; x++)
-        {
-            for (int z = 1; z < MAP_SIZE - 1; z++)
-            {
-                // Only generate breakable blocks in white cells (not green, not red, not border)
-                if (isWhiteCell(x, z) && dis(generator) < BREAKABLE_BLOCK_PROBABILITY)
-                {
-                    positions.push_back({x, z});
-                }
-            }
-        }
-    };
-
-    // Generate random breakable block positions in white cells
-    std::vector<std::pair<int, int>> breakableBlockPositions;
+    // Map layout: border ring, red blocks on even interior cells and the two 2x2 player spawn
+    // clusters (top-left and bottom-right), plus randomly placed breakable blocks in the white cells.
+    // The map and its bombs live in the simulation, which advances in fixed ticks and depends only
+    // on the seed and the commands of each tick
+    SimulationConfig simulationConfig;
     std::random_device rd;
-    std::mt19937 gen(rd());
-    generateBreakableBlocks(breakableBlockPositions, gen);
-
-    // render loop
-    while (!glfwWindowShouldClose(window))
+    simulationConfig.seed = options.hasSeed || options.headless ? options.seed : rd();
+    simulationConfig.mapSize = MAP_SIZE;
+    simulationConfig.breakableProbability = 0.6f; // 60% chance
+    Simulation simulation(simulationConfig);
+    const TileGrid& grid = simulation.grid();
+    InputLog inputLog(simulationConfig);
+
+    // block heights: border blocks are 1.0 unit tall, red and breakable blocks 75% of that,
+    // all standing on a 0.2 high floor slab
+    MapLayout mapLayout;
+    mapLayout.originX = MAP_OFFSET;
+    mapLayout.originZ = MAP_OFFSET;
+    mapLayout.tileSize = TILE_SIZE;
+    mapLayout.floorHeight = 0.2f;
+    mapLayout.borderHeight = 1.0f;
+    mapLayout.redBlockHeight = mapLayout.borderHeight * 0.75f; // 75% of border height
+    mapLayout.breakableHeight = mapLayout.borderHeight * 0.75f;
+
+    // merged per-chunk geometry without hidden faces; remeshed only where the grid changes
+    MapMesher mapMesher(grid, mapLayout);
+
+    // create perspective projection
+    // Adjust size to fit a 15x15 map nicely in view; larger maps show a 15x15 window of their centre
+    float aspect = static_cast<float>(SCR_WIDTH) / static_cast<float>(SCR_HEIGHT);
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), aspect, 0.1f, 200.0f);
+
+    // position camera above board looking toward origin (tilted ~60°)
+    const float VIEW_SIZE = static_cast<float>(std::min(MAP_SIZE, 15));
+    glm::vec3 cameraPos(0.0f, VIEW_SIZE * 1.2f, VIEW_SIZE * 1.1f);
+    glm::vec3 cameraTarget(0.0f, 0.0f, 0.0f);
+    glm::vec3 cameraUp(0.0f, 1.0f, 0.0f);
+    glm::mat4 view = glm::lookAt(cameraPos, cameraTarget, cameraUp);
+
+    // Lighting setup
+    glm::vec3 lightPos(VIEW_SIZE * 0.5f, VIEW_SIZE * 1.5f, VIEW_SIZE * 0.5f); // Light above the map
+    glm::vec3 lightColor(1.0f, 1.0f, 0.95f); // Slightly warm white light
+
+    // camera and light are static, so the uniform buffer is filled once here;
+    // renderFrame() re-uploads it only if something calls setCamera/setLight with new values
+    FrameUniforms frameUniforms;
+    frameUniforms.setCamera(projection, view, cameraPos);
+    frameUniforms.setLight(lightPos, lightColor);
+    Frustum frustum(projection * view);
+
+    // startup timings (-1 until reached), reported once all textures have arrived
+    double timeToFirstFrameMs = -1.0;
+    double textureLoadMs = -1.0;
+
+    // every draw goes through the render queue, sorted once per frame and executed through
+    // the state cache; the map mesher fills in the chunk geometry of each material at submit time
+    RenderQueue renderQueue;
+    GLStateCache stateCache;
+    RenderCommand mapMaterials[MapMesher::MATERIAL_COUNT];
+    const unsigned int materialTextures[MapMesher::MATERIAL_COUNT] = { floorTexture, borderTexture, breakableTexture };
+    for (unsigned int m = 0; m < MapMesher::MATERIAL_COUNT; m++)
     {
-        // input
-        processInput(window, breakableBlockPositions, gen, generateBreakableBlocks);
+        mapMaterials[m].program = shader.ID;
+        mapMaterials[m].addTexture(GL_TEXTURE_2D, materialTextures[m]); // red blocks use the border texture
+    }
+    RenderCommand skyboxCommand;
+    // skybox last: view/projection come from the uniform block, the shader strips the translation
+    skyboxCommand.pass = RenderPass::Sky;
+    skyboxCommand.program = skyboxShader.ID;
+    skyboxCommand.vertexArray = skyboxVAO;
+    skyboxCommand.depthFunc = GL_LEQUAL;
+    skyboxCommand.indexed = false;
+    skyboxCommand.count = 36;
+    skyboxCommand.addTexture(GL_TEXTURE_CUBE_MAP, cubemapTexture);
+
+    // renders one frame of the map into the currently bound framebuffer; returns the draw and state change counts
+    auto renderFrame = [&]() -> RenderStats {
+        PROFILE_ZONE("renderFrame");
+        // stream in textures that finished decoding
+        {
+            PROFILE_ZONE("texture streaming");
+            textureLoader.update(TEXTURE_UPLOAD_BUDGET_MS);
+            resources.collectGarbage();
+        }
+        if (textureLoadMs < 0.0 && textureLoader.pending() == 0)
+            textureLoadMs = millisecondsSinceStartup();
+        // remesh the chunks whose cells changed
+        {
+            PROFILE_ZONE("MapMesher::update");
+            mapMesher.update();
+        }
+        // the uploads above bind textures and buffers behind the cache's back
+        stateCache.invalidate();
 
         // render
         glClearColor(0.1f, 0.1f, 0.15f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        // activate shader
-        shader.use();
-
-        // create orthographic projection
-        // Adjust size to fit the 15x15 map nicely in view
-        float aspect = static_cast<float>(SCR_WIDTH) / static_cast<float>(SCR_HEIGHT);
-        glm::mat4 projection = glm::perspective(glm::radians(45.0f), aspect, 0.1f, 200.0f);
-
-        // position camera above board looking toward origin (tilted ~60°)
-        glm::vec3 cameraPos(0.0f, MAP_SIZE * 1.2f, MAP_SIZE * 1.1f);
-        glm::vec3 cameraTarget(0.0f, 0.0f, 0.0f);
-        glm::vec3 cameraUp(0.0f, 1.0f, 0.0f);
-        glm::mat4 view = glm::lookAt(cameraPos, cameraTarget, cameraUp);
-
-        // Lighting setup
-        glm::vec3 lightPos(MAP_SIZE * 0.5f, MAP_SIZE * 1.5f, MAP_SIZE * 0.5f); // Light above the map
-        glm::vec3 lightColor(1.0f, 1.0f, 0.95f); // Slightly warm white light
-
-        // set uniforms
-        shader.setMat4("projection", projection);
-        shader.setMat4("view", view);
-        shader.setVec3("lightPos", lightPos);
-        shader.setVec3("lightColor", lightColor);
-        shader.setVec3("viewPos", cameraPos);
-
-        // bind texture
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, floorTexture);
-
-        // render all tiles in the 15x15 grid
-        glBindVertexArray(VAO);
-        for (int x = 0; x < MAP_SIZE; x++)
-        {
-            for (int z = 0; z < MAP_SIZE; z++)
-            {
-                // calculate tile position
-                float tileX = MAP_OFFSET + x * TILE_SIZE;
-                float tileZ = MAP_OFFSET + z * TILE_SIZE;
-
-                // create model matrix for this block
-                glm::mat4 model = glm::mat4(1.0f);
-                model = glm::translate(model, glm::vec3(tileX, 0.0f, tileZ));
-                shader.setMat4("model", model);
+        // camera/light uniform block (no-op unless it changed)
+        frameUniforms.upload();
 
-                // draw the block (36 indices for a cube: 6 faces * 2 triangles * 3 vertices)
-                glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
-            }
+        // the floor, the raised border layer and red blocks (red blocks are 25% shorter) and the
+        // breakable blocks (randomly placed in white sections), chunks outside the view culled
+        {
+            PROFILE_ZONE("submit");
+            mapMesher.submit(renderQueue, frustum, cameraPos, mapMaterials);
+            renderQueue.submit(skyboxCommand);
         }
+        PROFILE_GPU_ZONE("render queue");
+        RenderStats stats = renderQueue.execute(stateCache);
 
-        // render raised border layer with unbreakable blocks
-        glBindTexture(GL_TEXTURE_2D, borderTexture);
-        const float fullBlockHeight = 1.0f;
-        const float borderScaleY = fullBlockHeight / blockHeight;
-        for (int x = 0; x < MAP_SIZE; x++)
-        {
-            for (int z = 0; z < MAP_SIZE; z++)
-            {
-                bool isBorder = (x == 0 || x == MAP_SIZE - 1 || z == 0 || z == MAP_SIZE - 1);
-                if (!isBorder)
-                    continue;
+        if (timeToFirstFrameMs < 0.0)
+            timeToFirstFrameMs = millisecondsSinceStartup();
+        return stats;
+    };
 
-                float tileX = MAP_OFFSET + x * TILE_SIZE;
-                float tileZ = MAP_OFFSET + z * TILE_SIZE;
+    auto printStartupTimings = [&]() {
+        std::cout << "Startup: first frame after " << timeToFirstFrameMs << " ms, all textures loaded after "
+                  << textureLoadMs << " ms (" << textureLoader.workerCount() << " decode threads, "
+                  << textureLoader.bakedCount() << " baked textures)" << std::endl;
+        const ShaderManager::Stats& shaderStats = shaderManager.statistics();
+        std::cout << "Shaders: " << shaderStats.programs << " programs built in " << shaderStats.buildMs << " ms ("
+                  << shaderStats.cacheHits << " from the binary cache)" << std::endl;
+        resources.report().print(std::cout);
+        const RenderStats& stats = renderQueue.stats();
+        std::cout << "Render queue: " << stats.submitted << " draws submitted, " << stats.stateChanges()
+                  << " state changes issued, " << stats.elidedStateChanges() << " elided per frame" << std::endl;
+    };
 
-                glm::mat4 model = glm::mat4(1.0f);
-                model = glm::translate(model, glm::vec3(tileX, blockHeight, tileZ));
-                model = glm::scale(model, glm::vec3(1.0f, borderScaleY, 1.0f));
-                shader.setMat4("model", model);
+    int exitCode = 0;
+    if (options.headless)
+    {
+        // first frame as a player would see it, then wait for the remaining textures so
+        // every measured frame renders the final assets
+        renderFrame();
+        glFinish();
+        textureLoader.finish();
+        if (textureLoadMs < 0.0)
+            textureLoadMs = millisecondsSinceStartup();
+        printStartupTimings();
+
+        BenchmarkReport report;
+        report.timeToFirstFrameMs = timeToFirstFrameMs;
+        report.textureLoadMs = textureLoadMs;
+        report.textureThreads = textureLoader.workerCount();
+        report.bakedTextures = textureLoader.bakedCount();
+        report.shaderBuildMs = shaderManager.statistics().buildMs;
+        report.shaderPrograms = shaderManager.statistics().programs;
+        report.shaderCacheHits = shaderManager.statistics().cacheHits;
+        report.mapSize = MAP_SIZE;
+        report.mapChunks = mapMesher.chunkCount();
+        report.mapTriangles = mapMesher.triangleCount();
+        exitCode = runHeadlessBenchmark(options, report, renderFrame);
+    }
+    else
+    {
+        bool startupReported = false;
+
+        // fixed timestep: the simulation runs TICKS_PER_SECOND ticks per second of real time
+        // whatever the frame rate; after a stall it skips ahead instead of trying to catch up
+        const double TICK_SECONDS = 1.0 / Simulation::TICKS_PER_SECOND;
+        const int MAX_TICKS_PER_FRAME = 8;
+        double previousTime = glfwGetTime();
+        double accumulator = 0.0;
+        std::uint8_t pendingCommands = 0; // held until a tick consumes them
+        const double SHADER_CHECK_SECONDS = 0.5;
+        double lastShaderCheck = previousTime;
+
+        auto runTick = [&](std::uint8_t commands) {
+            const Simulation::TickEvents& events = simulation.tick(commands);
+            if (!options.recordPath.empty())
+                inputLog.record(commands, simulation);
+            if (events.regenerated)
+            {
+                mapMesher.rebuild();
+                PROFILE_COUNT("layouts regenerated", 1);
+            }
+            PROFILE_COUNT("bombs dropped", events.bombsDropped);
+            PROFILE_COUNT("blocks destroyed", events.destroyed->size());
+            // destroyed blocks are patched into the chunk meshes
+            for (const BlastSystem::CellChange& change : *events.destroyed)
+                mapMesher.cellChanged(change.x, change.z);
+        };
+
+        // render loop
+        while (!glfwWindowShouldClose(window))
+        {
+            PROFILE_ZONE("frame");
+            // input
+            pendingCommands |= processInput(window);
 
-                glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
+            double now = glfwGetTime();
+            accumulator = std::min(accumulator + (now - previousTime), MAX_TICKS_PER_FRAME * TICK_SECONDS);
+            previousTime = now;
+            {
+                PROFILE_ZONE("simulation");
+                while (accumulator >= TICK_SECONDS)
+                {
+                    accumulator -= TICK_SECONDS;
+                    runTick(pendingCommands);
+                    pendingCommands = 0;
+                }
             }
-        }
 
-        // render red blocks (shorter blocks with same texture as border)
-        // Red blocks are 25% shorter than border blocks
-        const float redBlockHeight = fullBlockHeight * 0.75f; // 75% of border height
-        const float redBlockScaleY = redBlockHeight / blockHeight;
-        // Pattern: red blocks at columns C, E, G, I, K, M (indices 2, 4, 6, 8, 10, 12)
-        // and rows 3, 5, 7, 9, 11, 13 (indices 2, 4, 6, 8, 10, 12)
-        for (int x = 2; x <= 12; x += 2)
-        {
-            for (int z = 2; z <= 12; z += 2)
+            // development: pick up edited shader files
+            if (options.hotReload && now - lastShaderCheck >= SHADER_CHECK_SECONDS)
             {
-                float tileX = MAP_OFFSET + x * TILE_SIZE;
-                float tileZ = MAP_OFFSET + z * TILE_SIZE;
+                shaderManager.checkForChanges();
+                lastShaderCheck = now;
+            }
 
-                glm::mat4 model = glm::mat4(1.0f);
-                model = glm::translate(model, glm::vec3(tileX, blockHeight, tileZ));
-                model = glm::scale(model, glm::vec3(1.0f, redBlockScaleY, 1.0f));
-                shader.setMat4("model", model);
+            renderFrame();
+            if (!startupReported && textureLoadMs >= 0.0)
+            {
+                printStartupTimings();
+                startupReported = true;
+            }
 
-                glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
+            // glfw: swap buffers and poll IO events
+            {
+                PROFILE_ZONE("swap buffers");
+                glfwSwapBuffers(window);
             }
+            glfwPollEvents();
+            PROFILE_FRAME();
         }
+    }
 
-        // render breakable blocks (randomly placed in white sections)
-        // Breakable blocks are 75% of unbreakable block height (same as red blocks)
-        const float breakableBlockHeight = fullBlockHeight * 0.75f; // 75% of border height
-        const float breakableBlockScaleY = breakableBlockHeight / blockHeight;
-        glBindTexture(GL_TEXTURE_2D, breakableTexture);
-        for (const auto& pos : breakableBlockPositions)
-        {
-            int x = pos.first;
-            int z = pos.second;
-            
-            // Double-check: Skip green cells (should not happen, but safety check)
-            if (isGreenCell(x, z))
-                continue;
-            
-            float tileX = MAP_OFFSET + x * TILE_SIZE;
-            float tileZ = MAP_OFFSET + z * TILE_SIZE;
-            
-            glm::mat4 model = glm::mat4(1.0f);
-            model = glm::translate(model, glm::vec3(tileX, blockHeight, tileZ));
-            model = glm::scale(model, glm::vec3(1.0f, breakableBlockScaleY, 1.0f));
-            shader.setMat4("model", model);
-            
-            glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
-        }
+    if (!options.recordPath.empty())
+    {
+        if (inputLog.save(options.recordPath, simulation))
+            std::cout << "Recorded " << inputLog.tickCount() << " ticks to " << options.recordPath
+                      << " (final state hash " << std::hex << inputLog.finalHash() << std::dec << ")" << std::endl;
+        else
+            std::cout << "Failed to write input log " << options.recordPath << std::endl;
+    }
 
-        // glfw: swap buffers and poll IO events
-
-        // draw skybox last
-        glDepthFunc(GL_LEQUAL);
-        skyboxShader.use();
-        glm::mat4 viewNoTranslation = glm::mat4(glm::mat3(view));
-        skyboxShader.setMat4("view", viewNoTranslation);
-        skyboxShader.setMat4("projection", projection);
-        glBindVertexArray(skyboxVAO);
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_CUBE_MAP, cubemapTexture);
-        glDrawArrays(GL_TRIANGLES, 0, 36);
-        glBindVertexArray(0);
-        glDepthFunc(GL_LESS);
-
-        glfwSwapBuffers(window);
-        glfwPollEvents();
+#if PALBOM_PROFILER
+    if (!options.profilePath.empty())
+    {
+        Profiler& profiler = Profiler::instance();
+        profiler.printSummary(std::cout);
+        if (profiler.writeChromeTrace(options.profilePath))
+            std::cout << "Profile written to " << options.profilePath << std::endl;
+        else
+            std::cout << "Failed to write profile " << options.profilePath << std::endl;
     }
+    GpuProfiler::instance().release();
+#endif
 
     // optional: de-allocate all resources
-    glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
-    glDeleteBuffers(1, &EBO);
+    mapMesher.release();
+    frameUniforms.release();
+    textureLoader.release();
+    resources.release();
     glDeleteVertexArrays(1, &skyboxVAO);
     glDeleteBuffers(1, &skyboxVBO);
 
     // glfw: terminate, clearing all previously allocated GLFW resources
     glfwTerminate();
-    return 0;
+    return exitCode;
 }
 
 // process all input: query GLFW whether relevant keys are pressed/released this frame and react accordingly
-void processInput(GLFWwindow *window, std::vector<std::pair<int, int>>& breakableBlockPositions, 
-                 std::mt19937& gen, const std::function<void(std::vector<std::pair<int, int>>&, std::mt19937&)>& generateBlocks)
+// returns the simulation commands of the keys pressed since the last call (TickCommand mask)
+std::uint8_t processInput(GLFWwindow *window)
 {
     if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
         glfwSetWindowShouldClose(window, true);
-    
+
+    std::uint8_t commands = 0;
+
     // R key to regenerate breakable blocks
     static bool rKeyPressed = false;
     if (glfwGetKey(window, GLFW_KEY_R) == GLFW_PRESS && !rKeyPressed)
     {
         rKeyPressed = true;
-        generateBlocks(breakableBlockPositions, gen);
-        std::cout << "Breakable blocks regenerated! (" << breakableBlockPositions.size() << " blocks)" << std::endl;
+        commands |= COMMAND_REGENERATE;
     }
     else if (glfwGetKey(window, GLFW_KEY_R) == GLFW_RELEASE)
     {
         rKeyPressed = false;
     }
+
+    // B key to drop a few bombs on random free cells (2 s fuse)
+    static bool bKeyPressed = false;
+    if (glfwGetKey(window, GLFW_KEY_B) == GLFW_PRESS && !bKeyPressed)
+    {
+        bKeyPressed = true;
+        commands |= COMMAND_DROP_BOMBS;
+    }
+    else if (glfwGetKey(window, GLFW_KEY_B) == GLFW_RELEASE)
+    {
+        bKeyPressed = false;
+    }
+    return commands;
 }
 
 // glfw: whenever the window size changed (by OS or user resize) this callback function executes
@@ -526,34 +532,150 @@ void framebuffer_size_callback(GLFWwindow* window, int width, int height)
     glViewport(0, 0, width, height);
 }
 
-unsigned int loadCubemap(const std::vector<std::string>& faces)
+// resolve an asset through FileSystem (LOGL_ROOT_PATH / source directory); if the file is
+// not there, fall back to the path relative to the working directory
+std::string assetPath(const std::string& relativePath)
 {
-    unsigned int textureID;
-    glGenTextures(1, &textureID);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, textureID);
+    std::string path = FileSystem::getPath(relativePath);
+    if (std::ifstream(path).good())
+        return path;
+    std::cout << "Failed to find " << path << ". Trying alternative path..." << std::endl;
+    return relativePath;
+}
 
-    int width, height, nrChannels;
-    for (unsigned int i = 0; i < faces.size(); i++)
+bool parseArguments(int argc, char* argv[], LaunchOptions& options)
+{
+    for (int i = 1; i < argc; i++)
     {
-        unsigned char *data = stbi_load(faces[i].c_str(), &width, &height, &nrChannels, 0);
-        if (data)
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--headless") == 0)
+        {
+            options.headless = true;
+        }
+        else if (std::strcmp(argv[i], "--frames") == 0 && hasValue)
+        {
+            options.frames = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (std::strcmp(argv[i], "--seed") == 0 && hasValue)
         {
-            GLenum format = nrChannels == 4 ? GL_RGBA : GL_RGB;
-            glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-            stbi_image_free(data);
+            options.seed = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+            options.hasSeed = true;
+        }
+        else if (std::strcmp(argv[i], "--report") == 0 && hasValue)
+        {
+            options.reportPath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--texture-threads") == 0 && hasValue)
+        {
+            options.textureThreads = std::max(0, std::atoi(argv[++i]));
+        }
+        else if (std::strcmp(argv[i], "--no-baked-textures") == 0)
+        {
+            options.bakedTextures = false;
+        }
+        else if (std::strcmp(argv[i], "--map-size") == 0 && hasValue)
+        {
+            options.mapSize = std::max(5, std::atoi(argv[++i]));
+        }
+        else if (std::strcmp(argv[i], "--record") == 0 && hasValue)
+        {
+            options.recordPath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--shader-cache") == 0 && hasValue)
+        {
+            options.shaderCachePath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--no-shader-cache") == 0)
+        {
+            options.shaderCache = false;
+        }
+        else if (std::strcmp(argv[i], "--hot-reload") == 0)
+        {
+            options.hotReload = true;
+        }
+        else if (std::strcmp(argv[i], "--profile") == 0 && hasValue)
+        {
+            options.profilePath = argv[++i];
         }
         else
         {
-            std::cout << "Cubemap texture failed to load at path: " << faces[i] << std::endl;
-            stbi_image_free(data);
+            std::cout << "Unknown or incomplete argument: " << argv[i] << std::endl;
+            std::cout << "Usage: " << argv[0] << " [--headless] [--frames <n>] [--seed <n>] [--report <path>] [--texture-threads <n>] [--no-baked-textures] [--map-size <n>] [--record <path>] [--shader-cache <dir>] [--no-shader-cache] [--hot-reload] [--profile <path>]" << std::endl;
+            return false;
         }
     }
+    return true;
+}
+
+// renders a fixed number of frames into an offscreen framebuffer and writes per-frame CPU/GPU timings as JSON.
+// Works with any GL 3.3 driver including Mesa llvmpipe (e.g. LIBGL_ALWAYS_SOFTWARE=1 xvfb-run ./PlayableCharacter --headless)
+int runHeadlessBenchmark(const LaunchOptions& options, BenchmarkReport& report, const std::function<RenderStats()>& renderFrame)
+{
+    // offscreen render target, so the result does not depend on the (hidden) window surface
+    unsigned int framebuffer, colorBuffer, depthBuffer;
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glGenRenderbuffers(1, &colorBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, SCR_WIDTH, SCR_HEIGHT);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+    glGenRenderbuffers(1, &depthBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, SCR_WIDTH, SCR_HEIGHT);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        std::cout << "ERROR::FRAMEBUFFER:: Offscreen framebuffer is not complete!" << std::endl;
+        return -1;
+    }
+    glViewport(0, 0, SCR_WIDTH, SCR_HEIGHT);
+
+    report.renderer = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+    report.version = reinterpret_cast<const char*>(glGetString(GL_VERSION));
+    report.seed = options.seed;
+    report.width = SCR_WIDTH;
+    report.height = SCR_HEIGHT;
 
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    // untimed warm-up frames absorb shader compilation and first-use driver work
+    const int WARMUP_FRAMES = 5;
+    for (int frame = 0; frame < WARMUP_FRAMES; frame++)
+    {
+        renderFrame();
+        PROFILE_FRAME();
+    }
+    glFinish();
 
-    return textureID;
+    std::vector<RenderStats> stats;
+    std::vector<double> cpuTimes;
+    GpuFrameTimer gpuTimer;
+    for (int frame = 0; frame < options.frames; frame++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        gpuTimer.begin();
+        stats.push_back(renderFrame());
+        cpuTimes.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        // submit the frame inside the query so deferred renderers (llvmpipe) account for it
+        glFlush();
+        gpuTimer.end();
+        PROFILE_FRAME();
+    }
+    const std::vector<double>& gpuTimes = gpuTimer.finish();
+    for (int frame = 0; frame < options.frames; frame++)
+        report.frames.push_back({ cpuTimes[frame], gpuTimes[frame], stats[frame].drawCalls, stats[frame].triangles,
+            stats[frame].submitted, stats[frame].stateChanges(), stats[frame].elidedStateChanges() });
+
+    gpuTimer.release();
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDeleteRenderbuffers(1, &colorBuffer);
+    glDeleteRenderbuffers(1, &depthBuffer);
+    glDeleteFramebuffers(1, &framebuffer);
+
+    if (!report.write(options.reportPath))
+    {
+        std::cout << "Failed to write benchmark report to " << options.reportPath << std::endl;
+        return -1;
+    }
+    std::cout << "Rendered " << options.frames << " frames on " << report.renderer
+              << ", report written to " << options.reportPath << std::endl;
+    return 0;
 }
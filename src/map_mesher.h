@@ -0,0 +1,491 @@
+#ifndef MAP_MESHER_H
+#define MAP_MESHER_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "frustum.h"
+#include "profiler.h"
+#include "render_queue.h"
+#include "tile_grid.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+// textures of the map geometry; red blocks share the border texture
+enum class MapMaterial
+{
+    Floor = 0,
+    Border,
+    Breakable,
+    Count
+};
+
+// placement and heights of the map in world space
+struct MapLayout
+{
+    float originX = 0.0f;         // centre of cell (0, 0)
+    float originZ = 0.0f;
+    float tileSize = 1.0f;
+    float floorHeight = 0.2f;     // every cell has a floor slab from y = 0 to floorHeight
+    float borderHeight = 1.0f;    // block heights on top of the slab
+    float redBlockHeight = 0.75f;
+    float breakableHeight = 0.75f;
+};
+
+// Static map geometry, merged per chunk of CHUNK_SIZE x CHUNK_SIZE cells. Every cell is a
+// floor slab with an optional block standing on it; the mesher emits only the faces that can
+// be seen from above the map:
+//  - no bottom faces,
+//  - a slab's top only where no block stands on it,
+//  - side faces only where they rise above the neighbouring column (the part of a border
+//    side above a red block is kept, a side between two blocks of the same height is not),
+//  - consecutive faces of the same material and height merged into one quad along a row or
+//    column; their texture coordinates run on in tile units, so the repeating textures look
+//    exactly like one quad per cell.
+// Each chunk has its own vertex buffer with the indices grouped by material, so a chunk is
+// one draw per material. Changing a cell only remeshes its chunk, plus the chunk across the
+// edge when the cell lies on one (its neighbour's side face appears or disappears). Chunks
+// whose bounds are outside the view frustum are not submitted.
+//
+// The vertex layout is the one of the block mesh (position, normal, texcoord; 8 floats) in
+// world space; draw with shaders/tile.vs.
+class MapMesher
+{
+public:
+    static constexpr int CHUNK_SIZE = 16;
+    static constexpr unsigned int MATERIAL_COUNT = static_cast<unsigned int>(MapMaterial::Count);
+
+    struct Vertex
+    {
+        glm::vec3 position;
+        glm::vec3 normal;
+        glm::vec2 texCoords;
+    };
+
+    // CPU geometry of one chunk: indices[firstIndex[m], firstIndex[m] + indexCount[m]) use material m
+    struct ChunkGeometry
+    {
+        std::vector<Vertex> vertices;
+        std::vector<unsigned int> indices;
+        unsigned int firstIndex[MATERIAL_COUNT] = {};
+        unsigned int indexCount[MATERIAL_COUNT] = {};
+        glm::vec3 boundsMin = glm::vec3(0.0f);
+        glm::vec3 boundsMax = glm::vec3(0.0f);
+    };
+
+    MapMesher(const TileGrid& grid, const MapLayout& layout)
+        : grid(grid), layout(layout), chunksX((grid.width() + CHUNK_SIZE - 1) / CHUNK_SIZE),
+          chunksZ((grid.height() + CHUNK_SIZE - 1) / CHUNK_SIZE), chunks(static_cast<std::size_t>(chunksX) * chunksZ)
+    {
+        rebuild();
+    }
+
+    MapMesher(const MapMesher&) = delete;
+    MapMesher& operator=(const MapMesher&) = delete;
+
+    // de-allocate the GL objects; must be called while the context is still current
+    void release()
+    {
+        for (Chunk& chunk : chunks)
+        {
+            glDeleteVertexArrays(1, &chunk.VAO);
+            glDeleteBuffers(1, &chunk.VBO);
+            glDeleteBuffers(1, &chunk.EBO);
+            chunk = Chunk();
+        }
+    }
+
+    // remesh every chunk (e.g. after the breakable blocks were regenerated)
+    // ------------------------------------------------------------------------
+    void rebuild()
+    {
+        for (Chunk& chunk : chunks)
+            chunk.dirty = true;
+        update();
+    }
+
+    // a cell changed (e.g. a destroyed block): its chunk, and the neighbouring chunk if the
+    // cell lies on a chunk edge, are remeshed by the next update()
+    // ------------------------------------------------------------------------
+    void cellChanged(int x, int z)
+    {
+        markDirty(x, z);
+        for (int dir = 0; dir < 4; dir++)
+            markDirty(x + TileGrid::DX[dir], z + TileGrid::DZ[dir]);
+    }
+
+    // remesh and upload the dirty chunks; returns how many there were
+    std::size_t update()
+    {
+        std::size_t remeshed = 0;
+        for (int cz = 0; cz < chunksZ; cz++)
+        {
+            for (int cx = 0; cx < chunksX; cx++)
+            {
+                Chunk& chunk = chunks[static_cast<std::size_t>(cz) * chunksX + cx];
+                if (!chunk.dirty)
+                    continue;
+                buildChunk(grid, layout, cx, cz, scratch);
+                upload(chunk, scratch);
+                chunk.dirty = false;
+                remeshed++;
+            }
+        }
+        return remeshed;
+    }
+
+    // queue the chunks inside the frustum, one command per non-empty material; materials
+    // carries program and texture of each material. returns the number of visible chunks
+    // ------------------------------------------------------------------------
+    unsigned int submit(RenderQueue& queue, const Frustum& frustum, const glm::vec3& viewPos,
+        const RenderCommand (&materials)[MATERIAL_COUNT]) const
+    {
+        float extent = std::max(grid.width(), grid.height()) * layout.tileSize * 2.0f;
+        unsigned int visible = 0;
+        for (const Chunk& chunk : chunks)
+        {
+            if (chunk.VAO == 0 || !frustum.intersects(chunk.boundsMin, chunk.boundsMax))
+                continue;
+            visible++;
+            float depth = glm::length(0.5f * (chunk.boundsMin + chunk.boundsMax) - viewPos) / extent;
+            for (unsigned int m = 0; m < MATERIAL_COUNT; m++)
+            {
+                if (chunk.indexCount[m] == 0)
+                    continue;
+                RenderCommand command = materials[m];
+                command.depth = depth;
+                command.vertexArray = chunk.VAO;
+                command.indexed = true;
+                command.first = static_cast<GLint>(chunk.firstIndex[m]);
+                command.count = static_cast<GLsizei>(chunk.indexCount[m]);
+                command.instances = 1;
+                queue.submit(command);
+            }
+        }
+        return visible;
+    }
+
+    int chunkCount() const { return chunksX * chunksZ; }
+
+    // triangles of all chunks
+    std::size_t triangleCount() const
+    {
+        std::size_t triangles = 0;
+        for (const Chunk& chunk : chunks)
+            for (unsigned int m = 0; m < MATERIAL_COUNT; m++)
+                triangles += chunk.indexCount[m] / 3;
+        return triangles;
+    }
+
+    // Meshes chunk (cx, cz) of grid into geometry; no GL involved
+    // ------------------------------------------------------------------------
+    static void buildChunk(const TileGrid& grid, const MapLayout& layout, int cx, int cz, ChunkGeometry& geometry)
+    {
+        ChunkBuilder builder(grid, layout, cx * CHUNK_SIZE, cz * CHUNK_SIZE, std::min(grid.width(), (cx + 1) * CHUNK_SIZE),
+            std::min(grid.height(), (cz + 1) * CHUNK_SIZE));
+        builder.build(geometry);
+    }
+
+private:
+    struct Chunk
+    {
+        unsigned int VAO = 0, VBO = 0, EBO = 0;
+        unsigned int firstIndex[MATERIAL_COUNT] = {};
+        unsigned int indexCount[MATERIAL_COUNT] = {};
+        glm::vec3 boundsMin = glm::vec3(0.0f);
+        glm::vec3 boundsMax = glm::vec3(0.0f);
+        bool dirty = true;
+    };
+
+    // A visible face of a box, as compared when merging neighbouring faces: same material,
+    // same box (for the texture's v mapping) and same visible height range
+    struct Face
+    {
+        bool present = false;
+        MapMaterial material = MapMaterial::Floor;
+        float base = 0.0f, top = 0.0f; // the box
+        float y0 = 0.0f, y1 = 0.0f;    // its visible part (top faces: y0 == y1 == top)
+
+        bool operator==(const Face& other) const
+        {
+            return present == other.present && (!present || (material == other.material && base == other.base
+                && top == other.top && y0 == other.y0 && y1 == other.y1));
+        }
+    };
+
+    class ChunkBuilder
+    {
+    public:
+        ChunkBuilder(const TileGrid& grid, const MapLayout& layout, int x0, int z0, int x1, int z1)
+            : grid(grid), layout(layout), x0(x0), z0(z0), x1(x1), z1(z1)
+        {
+        }
+
+        void build(ChunkGeometry& geometry)
+        {
+            vertices.clear();
+            for (unsigned int m = 0; m < MATERIAL_COUNT; m++)
+                indices[m].clear();
+            maxTop = 0.0f;
+
+            // tops and the +-z sides merge along x, the +-x sides along z; the slab and the
+            // block of a column are swept separately so their faces never interleave
+            for (int box = 0; box < 2; box++)
+            {
+                sweepRows([&](int x, int z) { return topFace(x, z, box); }, [&](int a, int b, int z, const Face& face) {
+                    float minX = cellMin(a, layout.originX), maxX = cellMax(b, layout.originX);
+                    float minZ = cellMin(z, layout.originZ), maxZ = cellMax(z, layout.originZ);
+                    float length = float(b - a + 1);
+                    emitQuad(face.material, glm::vec3(0.0f, 1.0f, 0.0f),
+                        glm::vec3(minX, face.top, maxZ), glm::vec3(maxX, face.top, maxZ), glm::vec3(maxX, face.top, minZ), glm::vec3(minX, face.top, minZ),
+                        glm::vec2(0.0f, 1.0f), glm::vec2(length, 1.0f), glm::vec2(length, 0.0f), glm::vec2(0.0f, 0.0f));
+                });
+                for (int dir : { TileGrid::NORTH, TileGrid::SOUTH })
+                {
+                    sweepRows([&](int x, int z) { return sideFace(x, z, box, dir); }, [&](int a, int b, int z, const Face& face) {
+                        float minX = cellMin(a, layout.originX), maxX = cellMax(b, layout.originX);
+                        float length = float(b - a + 1), v0 = texV(face, face.y0), v1 = texV(face, face.y1);
+                        if (dir == TileGrid::SOUTH)
+                        {
+                            float faceZ = cellMax(z, layout.originZ);
+                            emitQuad(face.material, glm::vec3(0.0f, 0.0f, 1.0f),
+                                glm::vec3(minX, face.y0, faceZ), glm::vec3(maxX, face.y0, faceZ), glm::vec3(maxX, face.y1, faceZ), glm::vec3(minX, face.y1, faceZ),
+                                glm::vec2(0.0f, v0), glm::vec2(length, v0), glm::vec2(length, v1), glm::vec2(0.0f, v1));
+                        }
+                        else
+                        {
+                            float faceZ = cellMin(z, layout.originZ);
+                            emitQuad(face.material, glm::vec3(0.0f, 0.0f, -1.0f),
+                                glm::vec3(maxX, face.y0, faceZ), glm::vec3(minX, face.y0, faceZ), glm::vec3(minX, face.y1, faceZ), glm::vec3(maxX, face.y1, faceZ),
+                                glm::vec2(length, v0), glm::vec2(0.0f, v0), glm::vec2(0.0f, v1), glm::vec2(length, v1));
+                        }
+                    });
+                }
+                for (int dir : { TileGrid::WEST, TileGrid::EAST })
+                {
+                    sweepColumns([&](int x, int z) { return sideFace(x, z, box, dir); }, [&](int a, int b, int x, const Face& face) {
+                        float minZ = cellMin(a, layout.originZ), maxZ = cellMax(b, layout.originZ);
+                        float length = float(b - a + 1), v0 = texV(face, face.y0), v1 = texV(face, face.y1);
+                        if (dir == TileGrid::EAST)
+                        {
+                            float faceX = cellMax(x, layout.originX);
+                            emitQuad(face.material, glm::vec3(1.0f, 0.0f, 0.0f),
+                                glm::vec3(faceX, face.y0, maxZ), glm::vec3(faceX, face.y0, minZ), glm::vec3(faceX, face.y1, minZ), glm::vec3(faceX, face.y1, maxZ),
+                                glm::vec2(length, v0), glm::vec2(0.0f, v0), glm::vec2(0.0f, v1), glm::vec2(length, v1));
+                        }
+                        else
+                        {
+                            float faceX = cellMin(x, layout.originX);
+                            emitQuad(face.material, glm::vec3(-1.0f, 0.0f, 0.0f),
+                                glm::vec3(faceX, face.y0, minZ), glm::vec3(faceX, face.y0, maxZ), glm::vec3(faceX, face.y1, maxZ), glm::vec3(faceX, face.y1, minZ),
+                                glm::vec2(0.0f, v0), glm::vec2(length, v0), glm::vec2(length, v1), glm::vec2(0.0f, v1));
+                        }
+                    });
+                }
+            }
+
+            // one buffer, indices grouped by material
+            geometry.vertices.swap(vertices);
+            geometry.indices.clear();
+            for (unsigned int m = 0; m < MATERIAL_COUNT; m++)
+            {
+                geometry.firstIndex[m] = static_cast<unsigned int>(geometry.indices.size());
+                geometry.indexCount[m] = static_cast<unsigned int>(indices[m].size());
+                geometry.indices.insert(geometry.indices.end(), indices[m].begin(), indices[m].end());
+            }
+            geometry.boundsMin = glm::vec3(cellMin(x0, layout.originX), 0.0f, cellMin(z0, layout.originZ));
+            geometry.boundsMax = glm::vec3(cellMax(x1 - 1, layout.originX), maxTop, cellMax(z1 - 1, layout.originZ));
+        }
+
+    private:
+        const TileGrid& grid;
+        const MapLayout& layout;
+        int x0, z0, x1, z1; // cells [x0, x1) x [z0, z1)
+        std::vector<Vertex> vertices;
+        std::vector<unsigned int> indices[MATERIAL_COUNT];
+        float maxTop = 0.0f;
+
+        float cellMin(int cell, float origin) const { return origin + (cell - 0.5f) * layout.tileSize; }
+        float cellMax(int cell, float origin) const { return origin + (cell + 0.5f) * layout.tileSize; }
+
+        // height of the block standing on a cell (0 for floor)
+        float blockHeight(CellType type) const
+        {
+            switch (type)
+            {
+            case CellType::Border: return layout.borderHeight;
+            case CellType::RedBlock: return layout.redBlockHeight;
+            case CellType::Breakable: return layout.breakableHeight;
+            default: return 0.0f;
+            }
+        }
+
+        // top of the column of a cell; 0 outside the map
+        float columnTop(int x, int z) const
+        {
+            if (!grid.inBounds(x, z))
+                return 0.0f;
+            return layout.floorHeight + blockHeight(grid.cell(x, z));
+        }
+
+        // box 0 is the floor slab, box 1 the block (if any)
+        bool boxOf(int x, int z, int box, Face& face) const
+        {
+            CellType type = grid.cell(x, z);
+            if (box == 0)
+            {
+                face.material = MapMaterial::Floor;
+                face.base = 0.0f;
+                face.top = layout.floorHeight;
+                return true;
+            }
+            if (type == CellType::Floor)
+                return false;
+            face.material = type == CellType::Breakable ? MapMaterial::Breakable : MapMaterial::Border;
+            face.base = layout.floorHeight;
+            face.top = layout.floorHeight + blockHeight(type);
+            return true;
+        }
+
+        Face topFace(int x, int z, int box) const
+        {
+            Face face;
+            // the slab's top is covered by the block standing on it
+            if (!boxOf(x, z, box, face) || face.top < columnTop(x, z))
+                return Face();
+            face.present = true;
+            face.y0 = face.y1 = face.top;
+            return face;
+        }
+
+        Face sideFace(int x, int z, int box, int dir) const
+        {
+            Face face;
+            if (!boxOf(x, z, box, face))
+                return Face();
+            float neighbourTop = columnTop(x + TileGrid::DX[dir], z + TileGrid::DZ[dir]);
+            if (neighbourTop >= face.top)
+                return Face();
+            face.present = true;
+            face.y0 = std::max(face.base, neighbourTop);
+            face.y1 = face.top;
+            return face;
+        }
+
+        float texV(const Face& face, float y) const
+        {
+            return (y - face.base) / (face.top - face.base);
+        }
+
+        // merge runs of equal faces along x within each row of the chunk
+        template <typename FaceFn, typename EmitFn>
+        void sweepRows(FaceFn faceAt, EmitFn emit)
+        {
+            for (int z = z0; z < z1; z++)
+            {
+                int start = x0;
+                Face run = faceAt(x0, z);
+                for (int x = x0 + 1; x <= x1; x++)
+                {
+                    Face face = x < x1 ? faceAt(x, z) : Face();
+                    if (face == run)
+                        continue;
+                    if (run.present)
+                        emit(start, x - 1, z, run);
+                    run = face;
+                    start = x;
+                }
+            }
+        }
+
+        // merge runs of equal faces along z within each column of the chunk
+        template <typename FaceFn, typename EmitFn>
+        void sweepColumns(FaceFn faceAt, EmitFn emit)
+        {
+            for (int x = x0; x < x1; x++)
+            {
+                int start = z0;
+                Face run = faceAt(x, z0);
+                for (int z = z0 + 1; z <= z1; z++)
+                {
+                    Face face = z < z1 ? faceAt(x, z) : Face();
+                    if (face == run)
+                        continue;
+                    if (run.present)
+                        emit(start, z - 1, x, run);
+                    run = face;
+                    start = z;
+                }
+            }
+        }
+
+        // corners counter-clockwise seen from the side the normal points to
+        void emitQuad(MapMaterial material, const glm::vec3& normal, const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2,
+            const glm::vec3& p3, const glm::vec2& uv0, const glm::vec2& uv1, const glm::vec2& uv2, const glm::vec2& uv3)
+        {
+            unsigned int first = static_cast<unsigned int>(vertices.size());
+            vertices.push_back({ p0, normal, uv0 });
+            vertices.push_back({ p1, normal, uv1 });
+            vertices.push_back({ p2, normal, uv2 });
+            vertices.push_back({ p3, normal, uv3 });
+            std::vector<unsigned int>& target = indices[static_cast<unsigned int>(material)];
+            const unsigned int quad[] = { 0, 1, 2, 2, 3, 0 };
+            for (unsigned int index : quad)
+                target.push_back(first + index);
+            maxTop = std::max(maxTop, std::max(p2.y, p0.y));
+        }
+    };
+
+    const TileGrid& grid;
+    MapLayout layout;
+    int chunksX, chunksZ;
+    std::vector<Chunk> chunks;
+    ChunkGeometry scratch;
+
+    void markDirty(int x, int z)
+    {
+        if (grid.inBounds(x, z))
+            chunks[static_cast<std::size_t>(z / CHUNK_SIZE) * chunksX + x / CHUNK_SIZE].dirty = true;
+    }
+
+    void upload(Chunk& chunk, const ChunkGeometry& geometry)
+    {
+        if (chunk.VAO == 0)
+        {
+            glGenVertexArrays(1, &chunk.VAO);
+            glGenBuffers(1, &chunk.VBO);
+            glGenBuffers(1, &chunk.EBO);
+            glBindVertexArray(chunk.VAO);
+            glBindBuffer(GL_ARRAY_BUFFER, chunk.VBO);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, chunk.EBO);
+            glEnableVertexAttribArray(0);
+            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, position));
+            glEnableVertexAttribArray(1);
+            glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
+            glEnableVertexAttribArray(2);
+            glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, texCoords));
+        }
+        else
+        {
+            glBindVertexArray(chunk.VAO);
+            glBindBuffer(GL_ARRAY_BUFFER, chunk.VBO);
+        }
+        glBufferData(GL_ARRAY_BUFFER, geometry.vertices.size() * sizeof(Vertex), geometry.vertices.data(), GL_STATIC_DRAW);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, geometry.indices.size() * sizeof(unsigned int), geometry.indices.data(), GL_STATIC_DRAW);
+        PROFILE_COUNT("bytes uploaded", geometry.vertices.size() * sizeof(Vertex) + geometry.indices.size() * sizeof(unsigned int));
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        for (unsigned int m = 0; m < MATERIAL_COUNT; m++)
+        {
+            chunk.firstIndex[m] = geometry.firstIndex[m];
+            chunk.indexCount[m] = geometry.indexCount[m];
+        }
+        chunk.boundsMin = geometry.boundsMin;
+        chunk.boundsMax = geometry.boundsMax;
+    }
+};
+
+#endif
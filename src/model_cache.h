@@ -0,0 +1,662 @@
+#ifndef MODEL_CACHE_H
+#define MODEL_CACHE_H
+
+#include <assimp/scene.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <learnopengl/animdata.h>
+#include <learnopengl/assimp_glm_helpers.h>
+#include <learnopengl/mesh.h>
+
+#include "texture_cache.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Baked model / animation container (.bmdl), written by tools/model_baker and read by Model and
+// Animation, which otherwise import the source file (FBX, glTF, ...) with Assimp every launch.
+//
+//     ModelFileHeader
+//     ModelFileMesh[meshCount], ModelFileTexture[], ModelFileBone[boneCount],
+//     ModelFileNode[nodeCount], ModelFileChannel[channelCount]
+//     vertex, index and key arrays       each on a 16 byte boundary
+//     string table                       NUL terminated, referenced by byte offset
+//
+// Vertices are stored as the Vertex struct Mesh uploads, bone ids already resolved, nodes in
+// pre-order (parents first) and keys as float times plus glm values, so loading is mapping the
+// file and pointing at it. Like .btex the header records size and hash of the source file and
+// a stale container is ignored. The layouts are those of the machine that baked the file;
+// vertexSize guards against a changed Vertex.
+struct ModelFileHeader
+{
+    static constexpr uint32_t MAGIC = 0x444D4250; // "PBMD"
+    static constexpr uint32_t VERSION = 1;
+    static constexpr uint32_t FLAG_ANIMATION = 1;
+
+    uint32_t magic = MAGIC;
+    uint32_t version = VERSION;
+    uint32_t flags = 0;
+    uint32_t vertexSize = sizeof(Vertex);
+    uint64_t sourceSize = 0;
+    uint64_t sourceHash = 0;
+    uint32_t meshCount = 0;
+    uint32_t textureCount = 0;
+    uint32_t boneCount = 0;  // entries in the bone table
+    int32_t boneCounter = 0; // Model::GetBoneCount() after loading
+    uint32_t nodeCount = 0;
+    uint32_t channelCount = 0;
+    float duration = 0.0f;
+    float ticksPerSecond = 0.0f;
+    uint64_t meshOffset = 0;
+    uint64_t textureOffset = 0;
+    uint64_t boneOffset = 0;
+    uint64_t nodeOffset = 0;
+    uint64_t channelOffset = 0;
+    uint64_t stringOffset = 0;
+    uint64_t stringSize = 0;
+};
+
+struct ModelFileMesh
+{
+    uint64_t vertexOffset;
+    uint64_t indexOffset;
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    uint32_t firstTexture;
+    uint32_t textureCount;
+    uint32_t skinned;
+    uint32_t reserved;
+};
+
+struct ModelFileTexture
+{
+    uint32_t type; // string offsets
+    uint32_t path;
+};
+
+struct ModelFileBone
+{
+    glm::mat4 offset;
+    uint32_t name;
+    int32_t id;
+    uint32_t reserved[2];
+};
+
+struct ModelFileNode
+{
+    glm::mat4 transformation;
+    uint32_t name;
+    int32_t parent;
+    uint32_t childCount;
+    uint32_t reserved;
+};
+
+struct ModelFileChannel
+{
+    uint32_t name;
+    uint32_t positionCount;
+    uint32_t rotationCount;
+    uint32_t scaleCount;
+    uint64_t positionTimes; // float[positionCount]
+    uint64_t positions;     // glm::vec3[positionCount]
+    uint64_t rotationTimes;
+    uint64_t rotations;     // glm::quat[rotationCount]
+    uint64_t scaleTimes;
+    uint64_t scales;        // glm::vec3[scaleCount]
+};
+
+static_assert(sizeof(ModelFileHeader) == 120, "ModelFileHeader layout is part of the file format");
+static_assert(sizeof(ModelFileMesh) == 40, "ModelFileMesh layout is part of the file format");
+static_assert(sizeof(ModelFileBone) == 80, "ModelFileBone layout is part of the file format");
+static_assert(sizeof(ModelFileNode) == 80, "ModelFileNode layout is part of the file format");
+static_assert(sizeof(ModelFileChannel) == 64, "ModelFileChannel layout is part of the file format");
+static_assert(std::is_trivially_copyable<Vertex>::value, "Vertex is stored as raw bytes");
+static_assert(sizeof(glm::quat) == 16, "glm::quat is stored as raw bytes");
+
+namespace ModelCache
+{
+    // Read-only view of a scene, pointing either into a mapped .bmdl or into a SceneData.
+    // Model and Animation build themselves from this, whichever path it came from.
+    struct TextureView
+    {
+        const char* type; // "texture_diffuse", "texture_specular", ...
+        const char* path; // relative to the model's directory
+    };
+
+    struct MeshView
+    {
+        const Vertex* vertices;
+        std::size_t vertexCount;
+        const unsigned int* indices;
+        std::size_t indexCount;
+        std::vector<TextureView> textures;
+        bool skinned;
+    };
+
+    struct BoneView
+    {
+        const char* name;
+        BoneInfo info;
+    };
+
+    struct NodeView
+    {
+        const char* name;
+        glm::mat4 transformation;
+        int parent; // index into SceneView::nodes, -1 for the root
+        unsigned int childCount;
+    };
+
+    template<typename T>
+    struct KeysView
+    {
+        const float* times;
+        const T* values;
+        std::size_t count;
+    };
+
+    struct ChannelView
+    {
+        const char* name;
+        KeysView<glm::vec3> positions;
+        KeysView<glm::quat> rotations;
+        KeysView<glm::vec3> scales;
+    };
+
+    struct SceneView
+    {
+        std::vector<MeshView> meshes;
+        std::vector<BoneView> bones;
+        int boneCount = 0;
+        std::vector<NodeView> nodes; // pre-order
+        bool hasAnimation = false;   // the first animation of the source
+        float duration = 0.0f;
+        float ticksPerSecond = 0.0f;
+        std::vector<ChannelView> channels;
+    };
+
+    // owning counterpart of SceneView, filled from an Assimp scene
+    struct MeshData
+    {
+        std::vector<Vertex> vertices;
+        std::vector<unsigned int> indices;
+        std::vector<std::pair<std::string, std::string>> textures; // type, path
+        bool skinned = false;
+    };
+
+    struct NodeData
+    {
+        std::string name;
+        glm::mat4 transformation;
+        int parent;
+        unsigned int childCount;
+    };
+
+    struct ChannelData
+    {
+        std::string name;
+        std::vector<float> positionTimes, rotationTimes, scaleTimes;
+        std::vector<glm::vec3> positions, scales;
+        std::vector<glm::quat> rotations;
+    };
+
+    struct SceneData
+    {
+        std::vector<MeshData> meshes;
+        std::map<std::string, BoneInfo> boneInfoMap;
+        int boneCount = 0;
+        std::vector<NodeData> nodes;
+        bool hasAnimation = false;
+        float duration = 0.0f;
+        float ticksPerSecond = 0.0f;
+        std::vector<ChannelData> channels;
+
+        SceneView view() const
+        {
+            SceneView scene;
+            for (const MeshData& mesh : meshes)
+            {
+                MeshView view{ mesh.vertices.data(), mesh.vertices.size(), mesh.indices.data(), mesh.indices.size(), {}, mesh.skinned };
+                for (const auto& texture : mesh.textures)
+                    view.textures.push_back(TextureView{ texture.first.c_str(), texture.second.c_str() });
+                scene.meshes.push_back(view);
+            }
+            for (const auto& bone : boneInfoMap)
+                scene.bones.push_back(BoneView{ bone.first.c_str(), bone.second });
+            scene.boneCount = boneCount;
+            for (const NodeData& node : nodes)
+                scene.nodes.push_back(NodeView{ node.name.c_str(), node.transformation, node.parent, node.childCount });
+            scene.hasAnimation = hasAnimation;
+            scene.duration = duration;
+            scene.ticksPerSecond = ticksPerSecond;
+            for (const ChannelData& channel : channels)
+            {
+                scene.channels.push_back(ChannelView{ channel.name.c_str(),
+                    { channel.positionTimes.data(), channel.positions.data(), channel.positions.size() },
+                    { channel.rotationTimes.data(), channel.rotations.data(), channel.rotations.size() },
+                    { channel.scaleTimes.data(), channel.scales.data(), channel.scales.size() } });
+            }
+            return scene;
+        }
+    };
+
+    // where the baked version of a model lives: next to it, with the extension replaced
+    inline std::string bakedPath(const std::string& sourcePath)
+    {
+        std::string::size_type dot = sourcePath.find_last_of('.');
+        std::string::size_type slash = sourcePath.find_last_of("/\\");
+        if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+            return sourcePath + ".bmdl";
+        return sourcePath.substr(0, dot) + ".bmdl";
+    }
+
+    namespace Detail
+    {
+        inline void extractNode(const aiNode* node, const aiScene* scene, SceneData& data, bool includeMeshes, int parent)
+        {
+            int index = static_cast<int>(data.nodes.size());
+            data.nodes.push_back(NodeData{ node->mName.C_Str(), AssimpGLMHelpers::ConvertMatrixToGLMFormat(node->mTransformation),
+                parent, node->mNumChildren });
+
+            // same order as Model::processNode walked the scene
+            for (unsigned int m = 0; includeMeshes && m < node->mNumMeshes; m++)
+            {
+                const aiMesh* source = scene->mMeshes[node->mMeshes[m]];
+                MeshData mesh;
+                mesh.skinned = source->HasBones();
+                for (unsigned int i = 0; i < source->mNumVertices; i++)
+                {
+                    Vertex vertex;
+                    for (int b = 0; b < MAX_BONE_INFLUENCE; b++)
+                    {
+                        vertex.m_BoneIDs[b] = -1;
+                        vertex.m_Weights[b] = 0.0f;
+                    }
+                    vertex.Position = AssimpGLMHelpers::GetGLMVec(source->mVertices[i]);
+                    vertex.Normal = AssimpGLMHelpers::GetGLMVec(source->mNormals[i]);
+                    vertex.TexCoords = source->mTextureCoords[0]
+                        ? glm::vec2(source->mTextureCoords[0][i].x, source->mTextureCoords[0][i].y) : glm::vec2(0.0f, 0.0f);
+                    bool tangents = source->mTangents && source->mBitangents;
+                    vertex.Tangent = tangents ? AssimpGLMHelpers::GetGLMVec(source->mTangents[i]) : glm::vec3(0.0f);
+                    vertex.Bitangent = tangents ? AssimpGLMHelpers::GetGLMVec(source->mBitangents[i]) : glm::vec3(0.0f);
+                    mesh.vertices.push_back(vertex);
+                }
+                for (unsigned int f = 0; f < source->mNumFaces; f++)
+                {
+                    for (unsigned int j = 0; j < source->mFaces[f].mNumIndices; j++)
+                        mesh.indices.push_back(source->mFaces[f].mIndices[j]);
+                }
+
+                const aiMaterial* material = scene->mMaterials[source->mMaterialIndex];
+                const std::pair<aiTextureType, const char*> types[] = { { aiTextureType_DIFFUSE, "texture_diffuse" },
+                    { aiTextureType_SPECULAR, "texture_specular" }, { aiTextureType_HEIGHT, "texture_normal" },
+                    { aiTextureType_AMBIENT, "texture_height" } };
+                for (const auto& type : types)
+                {
+                    for (unsigned int t = 0; t < material->GetTextureCount(type.first); t++)
+                    {
+                        aiString path;
+                        material->GetTexture(type.first, t, &path);
+                        mesh.textures.push_back({ type.second, path.C_Str() });
+                    }
+                }
+
+                for (unsigned int b = 0; b < source->mNumBones; b++)
+                {
+                    const aiBone* bone = source->mBones[b];
+                    std::string name = bone->mName.C_Str();
+                    auto found = data.boneInfoMap.find(name);
+                    if (found == data.boneInfoMap.end())
+                    {
+                        BoneInfo info;
+                        info.id = data.boneCount++;
+                        info.offset = AssimpGLMHelpers::ConvertMatrixToGLMFormat(bone->mOffsetMatrix);
+                        found = data.boneInfoMap.emplace(name, info).first;
+                    }
+                    for (unsigned int w = 0; w < bone->mNumWeights; w++)
+                    {
+                        Vertex& vertex = mesh.vertices[bone->mWeights[w].mVertexId];
+                        for (int i = 0; i < MAX_BONE_INFLUENCE; i++)
+                        {
+                            if (vertex.m_BoneIDs[i] < 0)
+                            {
+                                vertex.m_BoneIDs[i] = found->second.id;
+                                vertex.m_Weights[i] = bone->mWeights[w].mWeight;
+                                break;
+                            }
+                        }
+                    }
+                }
+                data.meshes.push_back(std::move(mesh));
+            }
+
+            for (unsigned int c = 0; c < node->mNumChildren; c++)
+                extractNode(node->mChildren[c], scene, data, includeMeshes, index);
+        }
+    }
+
+    // everything Model and Animation take from an imported scene: processed meshes with their
+    // bone weights and material textures, the bone map, the node hierarchy and the channels of
+    // the first animation
+    inline void extractScene(const aiScene* scene, SceneData& data, bool includeMeshes = true)
+    {
+        data = SceneData();
+        Detail::extractNode(scene->mRootNode, scene, data, includeMeshes, -1);
+        if (scene->mNumAnimations == 0)
+            return;
+
+        const aiAnimation* animation = scene->mAnimations[0];
+        data.hasAnimation = true;
+        data.duration = static_cast<float>(animation->mDuration);
+        data.ticksPerSecond = static_cast<float>(animation->mTicksPerSecond);
+        for (unsigned int c = 0; c < animation->mNumChannels; c++)
+        {
+            const aiNodeAnim* source = animation->mChannels[c];
+            ChannelData channel;
+            channel.name = source->mNodeName.C_Str();
+            for (unsigned int k = 0; k < source->mNumPositionKeys; k++)
+            {
+                channel.positionTimes.push_back(static_cast<float>(source->mPositionKeys[k].mTime));
+                channel.positions.push_back(AssimpGLMHelpers::GetGLMVec(source->mPositionKeys[k].mValue));
+            }
+            for (unsigned int k = 0; k < source->mNumRotationKeys; k++)
+            {
+                channel.rotationTimes.push_back(static_cast<float>(source->mRotationKeys[k].mTime));
+                channel.rotations.push_back(AssimpGLMHelpers::GetGLMQuat(source->mRotationKeys[k].mValue));
+            }
+            for (unsigned int k = 0; k < source->mNumScalingKeys; k++)
+            {
+                channel.scaleTimes.push_back(static_cast<float>(source->mScalingKeys[k].mTime));
+                channel.scales.push_back(AssimpGLMHelpers::GetGLMVec(source->mScalingKeys[k].mValue));
+            }
+            data.channels.push_back(std::move(channel));
+        }
+    }
+
+    // a mapped, validated baked model
+    struct BakedModel
+    {
+        MappedFile file;
+        const ModelFileHeader* header = NULL;
+
+        template<typename T>
+        const T* at(uint64_t offset) const
+        {
+            return reinterpret_cast<const T*>(file.data() + offset);
+        }
+
+        const char* string(uint32_t offset) const
+        {
+            return at<char>(header->stringOffset + offset);
+        }
+
+        // pointers into the mapping; valid as long as this BakedModel
+        SceneView view() const
+        {
+            SceneView scene;
+            const ModelFileMesh* meshes = at<ModelFileMesh>(header->meshOffset);
+            const ModelFileTexture* textures = at<ModelFileTexture>(header->textureOffset);
+            for (uint32_t m = 0; m < header->meshCount; m++)
+            {
+                const ModelFileMesh& mesh = meshes[m];
+                MeshView view{ at<Vertex>(mesh.vertexOffset), mesh.vertexCount, at<unsigned int>(mesh.indexOffset), mesh.indexCount,
+                    {}, mesh.skinned != 0 };
+                for (uint32_t t = mesh.firstTexture; t < mesh.firstTexture + mesh.textureCount; t++)
+                    view.textures.push_back(TextureView{ string(textures[t].type), string(textures[t].path) });
+                scene.meshes.push_back(view);
+            }
+            const ModelFileBone* bones = at<ModelFileBone>(header->boneOffset);
+            for (uint32_t b = 0; b < header->boneCount; b++)
+            {
+                BoneInfo info;
+                info.id = bones[b].id;
+                info.offset = bones[b].offset;
+                scene.bones.push_back(BoneView{ string(bones[b].name), info });
+            }
+            scene.boneCount = header->boneCounter;
+            const ModelFileNode* nodes = at<ModelFileNode>(header->nodeOffset);
+            for (uint32_t n = 0; n < header->nodeCount; n++)
+                scene.nodes.push_back(NodeView{ string(nodes[n].name), nodes[n].transformation, nodes[n].parent, nodes[n].childCount });
+            scene.hasAnimation = (header->flags & ModelFileHeader::FLAG_ANIMATION) != 0;
+            scene.duration = header->duration;
+            scene.ticksPerSecond = header->ticksPerSecond;
+            const ModelFileChannel* channels = at<ModelFileChannel>(header->channelOffset);
+            for (uint32_t c = 0; c < header->channelCount; c++)
+            {
+                const ModelFileChannel& channel = channels[c];
+                scene.channels.push_back(ChannelView{ string(channel.name),
+                    { at<float>(channel.positionTimes), at<glm::vec3>(channel.positions), channel.positionCount },
+                    { at<float>(channel.rotationTimes), at<glm::quat>(channel.rotations), channel.rotationCount },
+                    { at<float>(channel.scaleTimes), at<glm::vec3>(channel.scales), channel.scaleCount } });
+            }
+            return scene;
+        }
+    };
+
+    namespace Detail
+    {
+        inline bool inside(uint64_t offset, uint64_t size, std::size_t fileSize)
+        {
+            return offset <= fileSize && size <= fileSize - offset;
+        }
+    }
+
+    // map a baked model and check it against its source; false if the baked file is missing,
+    // malformed, written for a different Vertex layout or older than the source
+    inline bool openBaked(const std::string& sourcePath, BakedModel& baked)
+    {
+        if (!baked.file.open(bakedPath(sourcePath)))
+            return false;
+        std::size_t size = baked.file.size();
+        if (size < sizeof(ModelFileHeader))
+            return false;
+        const ModelFileHeader* header = reinterpret_cast<const ModelFileHeader*>(baked.file.data());
+        if (header->magic != ModelFileHeader::MAGIC || header->version != ModelFileHeader::VERSION || header->vertexSize != sizeof(Vertex))
+            return false;
+
+        using Detail::inside;
+        if (!inside(header->meshOffset, uint64_t(header->meshCount) * sizeof(ModelFileMesh), size)
+            || !inside(header->textureOffset, uint64_t(header->textureCount) * sizeof(ModelFileTexture), size)
+            || !inside(header->boneOffset, uint64_t(header->boneCount) * sizeof(ModelFileBone), size)
+            || !inside(header->nodeOffset, uint64_t(header->nodeCount) * sizeof(ModelFileNode), size)
+            || !inside(header->channelOffset, uint64_t(header->channelCount) * sizeof(ModelFileChannel), size)
+            || !inside(header->stringOffset, header->stringSize, size)
+            || header->stringSize == 0 || baked.file.data()[header->stringOffset + header->stringSize - 1] != '\0')
+            return false;
+        // every string is a name offset into the table, which ends with its terminator
+        auto validString = [header](uint32_t offset) { return offset < header->stringSize; };
+        if (header->boneCounter < 0)
+            return false;
+
+        const ModelFileTexture* textures = reinterpret_cast<const ModelFileTexture*>(baked.file.data() + header->textureOffset);
+        for (uint32_t t = 0; t < header->textureCount; t++)
+        {
+            if (!validString(textures[t].type) || !validString(textures[t].path))
+                return false;
+        }
+        const ModelFileMesh* meshes = reinterpret_cast<const ModelFileMesh*>(baked.file.data() + header->meshOffset);
+        for (uint32_t m = 0; m < header->meshCount; m++)
+        {
+            const ModelFileMesh& mesh = meshes[m];
+            if (!inside(mesh.vertexOffset, uint64_t(mesh.vertexCount) * sizeof(Vertex), size)
+                || !inside(mesh.indexOffset, uint64_t(mesh.indexCount) * sizeof(unsigned int), size)
+                || uint64_t(mesh.firstTexture) + mesh.textureCount > header->textureCount)
+                return false;
+            // indices reach glDrawElements and bone ids the bone palette unchecked
+            const unsigned int* indices = reinterpret_cast<const unsigned int*>(baked.file.data() + mesh.indexOffset);
+            for (uint32_t i = 0; i < mesh.indexCount; i++)
+            {
+                if (indices[i] >= mesh.vertexCount)
+                    return false;
+            }
+            const Vertex* vertices = reinterpret_cast<const Vertex*>(baked.file.data() + mesh.vertexOffset);
+            for (uint32_t v = 0; v < mesh.vertexCount; v++)
+            {
+                for (int i = 0; i < MAX_BONE_INFLUENCE; i++)
+                {
+                    if (vertices[v].m_BoneIDs[i] < -1 || vertices[v].m_BoneIDs[i] >= header->boneCounter)
+                        return false;
+                }
+            }
+        }
+        const ModelFileBone* bones = reinterpret_cast<const ModelFileBone*>(baked.file.data() + header->boneOffset);
+        for (uint32_t b = 0; b < header->boneCount; b++)
+        {
+            if (!validString(bones[b].name) || bones[b].id < 0 || bones[b].id >= header->boneCounter)
+                return false;
+        }
+        // nodes are in pre-order: replaying the child counts has to give every node the parent
+        // it names, which also puts every parent before its children
+        const ModelFileNode* nodes = reinterpret_cast<const ModelFileNode*>(baked.file.data() + header->nodeOffset);
+        std::vector<std::pair<int32_t, uint32_t>> open; // node, children still to come
+        for (uint32_t n = 0; n < header->nodeCount; n++)
+        {
+            while (!open.empty() && open.back().second == 0)
+                open.pop_back();
+            if (n > 0 && open.empty())
+                return false; // a second root
+            int32_t parent = open.empty() ? -1 : open.back().first;
+            if (!open.empty())
+                open.back().second--;
+            if (!validString(nodes[n].name) || nodes[n].parent != parent || nodes[n].childCount >= header->nodeCount)
+                return false;
+            open.push_back({ static_cast<int32_t>(n), nodes[n].childCount });
+        }
+        for (const auto& node : open)
+        {
+            if (node.second != 0)
+                return false; // children missing from the file
+        }
+        const ModelFileChannel* channels = reinterpret_cast<const ModelFileChannel*>(baked.file.data() + header->channelOffset);
+        for (uint32_t c = 0; c < header->channelCount; c++)
+        {
+            const ModelFileChannel& channel = channels[c];
+            if (!validString(channel.name))
+                return false;
+            if (!inside(channel.positionTimes, uint64_t(channel.positionCount) * sizeof(float), size)
+                || !inside(channel.positions, uint64_t(channel.positionCount) * sizeof(glm::vec3), size)
+                || !inside(channel.rotationTimes, uint64_t(channel.rotationCount) * sizeof(float), size)
+                || !inside(channel.rotations, uint64_t(channel.rotationCount) * sizeof(glm::quat), size)
+                || !inside(channel.scaleTimes, uint64_t(channel.scaleCount) * sizeof(float), size)
+                || !inside(channel.scales, uint64_t(channel.scaleCount) * sizeof(glm::vec3), size))
+                return false;
+        }
+
+        uint64_t sourceSize, sourceHash;
+        if (!TextureCache::hashFile(sourcePath, sourceSize, sourceHash) || sourceSize != header->sourceSize || sourceHash != header->sourceHash)
+            return false;
+
+        baked.header = header;
+        return true;
+    }
+
+    // write a container for scene; sourceSize/sourceHash identify the file it was baked from
+    inline bool writeBaked(const std::string& path, const SceneView& scene, uint64_t sourceSize, uint64_t sourceHash)
+    {
+        std::vector<unsigned char> bytes(sizeof(ModelFileHeader));
+        auto append = [&bytes](const void* data, std::size_t size) -> uint64_t {
+            bytes.resize((bytes.size() + 15) & ~std::size_t(15));
+            uint64_t offset = bytes.size();
+            bytes.insert(bytes.end(), static_cast<const unsigned char*>(data), static_cast<const unsigned char*>(data) + size);
+            return offset;
+        };
+        std::vector<char> strings;
+        auto addString = [&strings](const char* text) -> uint32_t {
+            uint32_t offset = static_cast<uint32_t>(strings.size());
+            strings.insert(strings.end(), text, text + std::strlen(text) + 1);
+            return offset;
+        };
+
+        ModelFileHeader header;
+        header.sourceSize = sourceSize;
+        header.sourceHash = sourceHash;
+        header.flags = scene.hasAnimation ? ModelFileHeader::FLAG_ANIMATION : 0;
+        header.boneCounter = scene.boneCount;
+        header.duration = scene.duration;
+        header.ticksPerSecond = scene.ticksPerSecond;
+
+        std::vector<ModelFileMesh> meshes;
+        std::vector<ModelFileTexture> textures;
+        for (const MeshView& mesh : scene.meshes)
+        {
+            ModelFileMesh record = {};
+            record.vertexOffset = append(mesh.vertices, mesh.vertexCount * sizeof(Vertex));
+            record.indexOffset = append(mesh.indices, mesh.indexCount * sizeof(unsigned int));
+            record.vertexCount = static_cast<uint32_t>(mesh.vertexCount);
+            record.indexCount = static_cast<uint32_t>(mesh.indexCount);
+            record.firstTexture = static_cast<uint32_t>(textures.size());
+            record.textureCount = static_cast<uint32_t>(mesh.textures.size());
+            record.skinned = mesh.skinned ? 1 : 0;
+            for (const TextureView& texture : mesh.textures)
+                textures.push_back(ModelFileTexture{ addString(texture.type), addString(texture.path) });
+            meshes.push_back(record);
+        }
+        std::vector<ModelFileBone> bones;
+        for (const BoneView& bone : scene.bones)
+        {
+            ModelFileBone record = {};
+            record.offset = bone.info.offset;
+            record.name = addString(bone.name);
+            record.id = bone.info.id;
+            bones.push_back(record);
+        }
+        std::vector<ModelFileNode> nodes;
+        for (const NodeView& node : scene.nodes)
+        {
+            ModelFileNode record = {};
+            record.transformation = node.transformation;
+            record.name = addString(node.name);
+            record.parent = node.parent;
+            record.childCount = node.childCount;
+            nodes.push_back(record);
+        }
+        std::vector<ModelFileChannel> channels;
+        for (const ChannelView& channel : scene.channels)
+        {
+            ModelFileChannel record = {};
+            record.name = addString(channel.name);
+            record.positionCount = static_cast<uint32_t>(channel.positions.count);
+            record.rotationCount = static_cast<uint32_t>(channel.rotations.count);
+            record.scaleCount = static_cast<uint32_t>(channel.scales.count);
+            record.positionTimes = append(channel.positions.times, channel.positions.count * sizeof(float));
+            record.positions = append(channel.positions.values, channel.positions.count * sizeof(glm::vec3));
+            record.rotationTimes = append(channel.rotations.times, channel.rotations.count * sizeof(float));
+            record.rotations = append(channel.rotations.values, channel.rotations.count * sizeof(glm::quat));
+            record.scaleTimes = append(channel.scales.times, channel.scales.count * sizeof(float));
+            record.scales = append(channel.scales.values, channel.scales.count * sizeof(glm::vec3));
+            channels.push_back(record);
+        }
+        if (strings.empty())
+            strings.push_back('\0');
+
+        header.meshCount = static_cast<uint32_t>(meshes.size());
+        header.meshOffset = append(meshes.data(), meshes.size() * sizeof(ModelFileMesh));
+        header.textureCount = static_cast<uint32_t>(textures.size());
+        header.textureOffset = append(textures.data(), textures.size() * sizeof(ModelFileTexture));
+        header.boneCount = static_cast<uint32_t>(bones.size());
+        header.boneOffset = append(bones.data(), bones.size() * sizeof(ModelFileBone));
+        header.nodeCount = static_cast<uint32_t>(nodes.size());
+        header.nodeOffset = append(nodes.data(), nodes.size() * sizeof(ModelFileNode));
+        header.channelCount = static_cast<uint32_t>(channels.size());
+        header.channelOffset = append(channels.data(), channels.size() * sizeof(ModelFileChannel));
+        header.stringSize = strings.size();
+        header.stringOffset = append(strings.data(), strings.size());
+        std::memcpy(bytes.data(), &header, sizeof(header));
+
+        FILE* file = std::fopen(path.c_str(), "wb");
+        if (file == NULL)
+            return false;
+        bool ok = std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+        ok = std::fclose(file) == 0 && ok;
+        return ok;
+    }
+}
+
+#endif
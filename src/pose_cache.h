@@ -0,0 +1,99 @@
+#ifndef POSE_CACHE_H
+#define POSE_CACHE_H
+
+#include <glm/glm.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+class Animation;
+
+// Bone palettes shared between characters that play the same clip at nearly the same time.
+//
+// Times are quantised to a grid of `quantum` ticks and a palette is evaluated once per
+// (clip, grid time, LOD variant). The entry is a pure function of its key, so it does not
+// matter which character evaluates it. Entries no character used in the last frame are
+// evicted by evictUnused(); references to the remaining entries stay valid across frames.
+class PoseCache
+{
+public:
+    struct Entry
+    {
+        std::vector<glm::mat4> palette;
+        uint64_t lastUsed = 0;
+    };
+
+    explicit PoseCache(std::size_t paletteSize)
+        : paletteSize(paletteSize)
+    {
+    }
+
+    // the entry for this clip time; `miss` is set when the caller has to evaluate its palette
+    // at `quantisedTime`
+    Entry& acquire(const Animation* clip, float time, float quantum, int variant, uint64_t frame, bool& miss, float& quantisedTime)
+    {
+        int64_t tick = static_cast<int64_t>(std::floor(time / quantum));
+        quantisedTime = static_cast<float>(tick * static_cast<double>(quantum));
+        auto result = entries.try_emplace(Key{ clip, tick, variant });
+        Entry& entry = result.first->second;
+        miss = result.second;
+        if (miss)
+            entry.palette.assign(paletteSize, glm::mat4(1.0f));
+        entry.lastUsed = frame;
+        return entry;
+    }
+
+    void evictUnused(uint64_t frame)
+    {
+        for (auto it = entries.begin(); it != entries.end();)
+        {
+            if (it->second.lastUsed != frame)
+                it = entries.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    void clear()
+    {
+        entries.clear();
+    }
+
+    std::size_t size() const
+    {
+        return entries.size();
+    }
+
+private:
+    struct Key
+    {
+        const Animation* clip;
+        int64_t tick;
+        int variant;
+
+        bool operator==(const Key& other) const
+        {
+            return clip == other.clip && tick == other.tick && variant == other.variant;
+        }
+    };
+
+    struct KeyHash
+    {
+        std::size_t operator()(const Key& key) const
+        {
+            std::size_t hash = std::hash<const void*>()(key.clip);
+            hash ^= std::hash<int64_t>()(key.tick) + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+            hash ^= std::hash<int>()(key.variant) + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+            return hash;
+        }
+    };
+
+    std::size_t paletteSize;
+    std::unordered_map<Key, Entry, KeyHash> entries;
+};
+
+#endif
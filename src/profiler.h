@@ -0,0 +1,477 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+// Frame profiler: scoped CPU zones on any thread and named per-frame counters, exported as a
+// Chrome trace (chrome://tracing, https://ui.perfetto.dev). Instrument code only through the
+// macros:
+//
+//     PROFILE_ZONE("MapMesher::update");        // CPU time until the end of the scope
+//     PROFILE_COUNT("draw calls", stats.drawCalls);
+//     PROFILE_THREAD("texture decode");         // names the calling thread in the trace
+//     PROFILE_FRAME();                          // once per frame, on the GL thread
+//
+// This header needs no GL, so GL-free code (the simulation, the job system, tools) can be
+// instrumented. GPU zones (PROFILE_GPU_ZONE) come from gpu_profiler.h and show up in the
+// same trace on their own "GPU" thread.
+//
+// They compile to nothing unless PALBOM_PROFILER is 1 (CMake option PALBOM_PROFILER, on by
+// default); the arguments of a disabled PROFILE_COUNT are not evaluated, so they must not
+// have side effects. Built in, zones cost one relaxed load until setCapturing(true).
+//
+// A zone is written to a buffer owned by its thread. Full buffers, and buffers older than
+// CHUNK_MAX_AGE_NS when a top-level zone ends, are pushed onto a lock-free list the exporter
+// takes as a whole, so threads never wait for each other or for the exporter. A thread's last
+// events are published when it exits; the exporting thread publishes its own.
+
+#ifndef PALBOM_PROFILER
+#define PALBOM_PROFILER 0
+#endif
+
+#if PALBOM_PROFILER
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct ProfileEvent
+{
+    const char* name; // string literal
+    uint64_t start;   // nanoseconds since the profiler was created
+    uint64_t end;
+    uint32_t depth;   // nesting level on its thread, 0 for top-level zones
+};
+
+class Profiler
+{
+public:
+    static constexpr std::size_t CHUNK_EVENTS = 1024;
+    static constexpr uint64_t CHUNK_MAX_AGE_NS = 10000000; // 10 ms
+    static constexpr std::size_t MAX_COUNTERS = 32;
+    static constexpr uint32_t GPU_THREAD = 0;              // trace thread of the GPU zones
+
+    static Profiler& instance()
+    {
+        static Profiler profiler;
+        return profiler;
+    }
+
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+    // record zones from now on (or stop); counters are kept per frame either way
+    void setCapturing(bool enabled)
+    {
+        capture.store(enabled, std::memory_order_relaxed);
+    }
+
+    bool capturing() const
+    {
+        return capture.load(std::memory_order_relaxed);
+    }
+
+    uint64_t now() const
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count());
+    }
+
+    void setThreadName(const char* name)
+    {
+        uint32_t thread = threadBuffer().id;
+        std::lock_guard<std::mutex> lock(mutex);
+        threadNames[thread] = name;
+    }
+
+    // CPU zones (ProfileZone)
+    // ------------------------------------------------------------------------
+    uint32_t enterZone()
+    {
+        return threadBuffer().depth++;
+    }
+
+    void leaveZone(const char* name, uint64_t start, uint32_t depth)
+    {
+        uint64_t end = now();
+        ThreadBuffer& buffer = threadBuffer();
+        buffer.depth = depth;
+        if (buffer.chunk == nullptr)
+        {
+            buffer.chunk = new Chunk();
+            buffer.chunk->thread = buffer.id;
+            buffer.chunk->started = start;
+            buffer.chunk->events.reserve(CHUNK_EVENTS);
+        }
+        buffer.chunk->events.push_back(ProfileEvent{ name, start, end, depth });
+        if (depth == 0 && (buffer.chunk->events.size() >= CHUNK_EVENTS || end - buffer.chunk->started >= CHUNK_MAX_AGE_NS))
+            publish(buffer);
+    }
+
+    // counters (PROFILE_COUNT)
+    // ------------------------------------------------------------------------
+    // index of the named counter, registered on first use; names beyond MAX_COUNTERS share
+    // a slot that is never reported
+    std::size_t counter(const char* name)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (std::size_t i = 0; i < counterNames.size(); i++)
+        {
+            if (std::strcmp(counterNames[i], name) == 0)
+                return i;
+        }
+        if (counterNames.size() == MAX_COUNTERS)
+            return MAX_COUNTERS;
+        counterNames.push_back(name);
+        return counterNames.size() - 1;
+    }
+
+    void add(std::size_t counter, int64_t value)
+    {
+        counters[counter].fetch_add(value, std::memory_order_relaxed);
+    }
+
+    // value of a counter over the last completed frame
+    int64_t lastFrame(const char* name)
+    {
+        std::size_t index = counter(name);
+        return index < MAX_COUNTERS ? lastFrameValues[index] : 0;
+    }
+
+    // close the frame: latch and reset the counters and pick up finished GPU zones
+    // ------------------------------------------------------------------------
+    void endFrame()
+    {
+        uint64_t end = now();
+        std::size_t count;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            count = counterNames.size();
+        }
+        FrameSample sample;
+        sample.start = frameStart;
+        sample.values.resize(count);
+        for (std::size_t i = 0; i < count; i++)
+            sample.values[i] = lastFrameValues[i] = counters[i].exchange(0, std::memory_order_relaxed);
+        if (capturing())
+            frames.push_back(std::move(sample));
+        frameStart = end;
+        if (gpuCollector != nullptr)
+            gpuCollector(false);
+    }
+
+    // GPU zones, recorded by GpuProfiler (gpu_profiler.h) on the GL thread
+    // ------------------------------------------------------------------------
+    // called with wait false by endFrame() and true before an export, to hand over the
+    // finished zones through addGpuEvent()
+    void setGpuCollector(void (*collector)(bool wait))
+    {
+        gpuCollector = collector;
+    }
+
+    void addGpuEvent(const ProfileEvent& event)
+    {
+        gpuEvents.push_back(event);
+    }
+
+    // export
+    // ------------------------------------------------------------------------
+    // Chrome trace event JSON: a complete event per zone, a counter track per counter and the
+    // thread names. Waits for outstanding GPU zones, so the GL context must be current if any
+    // were recorded.
+    bool writeChromeTrace(const std::string& path)
+    {
+        collect();
+        if (gpuCollector != nullptr)
+            gpuCollector(true);
+        FILE* file = std::fopen(path.c_str(), "w");
+        if (file == NULL)
+            return false;
+
+        std::fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+        std::fprintf(file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"PalBomb\"}}");
+        std::map<uint32_t, std::string> names = threadNameList();
+        for (const auto& thread : names)
+        {
+            std::fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}", thread.first,
+                escape(thread.second).c_str());
+            std::fprintf(file, ",\n{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"sort_index\":%u}}", thread.first,
+                thread.first == GPU_THREAD ? 1000000u : thread.first);
+        }
+        auto writeEvents = [&](uint32_t thread, const std::vector<ProfileEvent>& events) {
+            for (const ProfileEvent& event : events)
+            {
+                std::fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", escape(event.name).c_str(),
+                    thread, event.start / 1000.0, (event.end - event.start) / 1000.0);
+            }
+        };
+        for (const auto& thread : threadEvents)
+            writeEvents(thread.first, thread.second);
+        writeEvents(GPU_THREAD, gpuEvents);
+
+        std::vector<const char*> counterList;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            counterList = counterNames;
+        }
+        for (const FrameSample& frame : frames)
+        {
+            for (std::size_t i = 0; i < frame.values.size(); i++)
+            {
+                std::fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"C\",\"pid\":1,\"ts\":%.3f,\"args\":{\"value\":%lld}}",
+                    escape(counterList[i]).c_str(), frame.start / 1000.0, static_cast<long long>(frame.values[i]));
+            }
+        }
+        std::fprintf(file, "\n]}\n");
+        return std::fclose(file) == 0;
+    }
+
+    // per thread, every zone name with its calls and time per captured frame, indented by depth,
+    // followed by the counter averages
+    void printSummary(std::ostream& out)
+    {
+        collect();
+        std::size_t frameCount = std::max<std::size_t>(1, frames.size());
+        std::map<uint32_t, std::string> names = threadNameList();
+        out << "Profile: " << frames.size() << " frames captured, per frame:" << std::endl;
+        auto summarise = [&](uint32_t thread, const std::vector<ProfileEvent>& events) {
+            if (events.empty())
+                return;
+            struct Total
+            {
+                uint64_t first;
+                uint32_t depth;
+                std::size_t calls = 0;
+                uint64_t ns = 0;
+            };
+            std::map<std::pair<uint32_t, std::string>, Total> totals;
+            for (const ProfileEvent& event : events)
+            {
+                Total& total = totals.emplace(std::make_pair(event.depth, std::string(event.name)), Total{ event.start, event.depth }).first->second;
+                total.first = std::min(total.first, event.start);
+                total.calls++;
+                total.ns += event.end - event.start;
+            }
+            std::vector<std::pair<std::string, Total>> ordered;
+            for (const auto& total : totals)
+                ordered.emplace_back(total.first.second, total.second);
+            // first appearance order puts every zone below the one it first ran in
+            std::sort(ordered.begin(), ordered.end(), [](const std::pair<std::string, Total>& a, const std::pair<std::string, Total>& b) {
+                return a.second.first != b.second.first ? a.second.first < b.second.first : a.second.depth < b.second.depth;
+            });
+            out << "  " << (names.count(thread) ? names[thread] : "thread " + std::to_string(thread)) << std::endl;
+            for (const auto& entry : ordered)
+            {
+                out << "    " << std::string(entry.second.depth * 2, ' ') << std::left << std::setw(36 - entry.second.depth * 2) << entry.first
+                    << std::right << std::fixed << std::setprecision(3) << std::setw(10) << entry.second.ns / 1.0e6 / frameCount << " ms"
+                    << std::setprecision(1) << std::setw(10) << static_cast<double>(entry.second.calls) / frameCount << " calls" << std::endl;
+            }
+            out << std::defaultfloat;
+        };
+        for (const auto& thread : threadEvents)
+            summarise(thread.first, thread.second);
+        summarise(GPU_THREAD, gpuEvents);
+
+        std::vector<const char*> counterList;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            counterList = counterNames;
+        }
+        for (std::size_t i = 0; i < counterList.size(); i++)
+        {
+            int64_t total = 0;
+            for (const FrameSample& frame : frames)
+                total += i < frame.values.size() ? frame.values[i] : 0;
+            out << "  " << std::left << std::setw(38) << counterList[i] << std::right << std::fixed << std::setprecision(1)
+                << std::setw(14) << static_cast<double>(total) / frameCount << std::defaultfloat << std::endl;
+        }
+    }
+
+    // drop everything captured so far
+    void clear()
+    {
+        collect();
+        threadEvents.clear();
+        gpuEvents.clear();
+        frames.clear();
+    }
+
+private:
+    struct Chunk
+    {
+        Chunk* next = nullptr;
+        uint32_t thread = 0;
+        uint64_t started = 0;
+        std::vector<ProfileEvent> events;
+    };
+
+    // per-thread zone buffer; whatever it holds is published when its thread exits
+    struct ThreadBuffer
+    {
+        uint32_t id;
+        uint32_t depth = 0;
+        Chunk* chunk = nullptr;
+
+        ThreadBuffer() : id(Profiler::instance().nextThread.fetch_add(1, std::memory_order_relaxed)) {}
+        ~ThreadBuffer() { Profiler::instance().publish(*this); }
+    };
+
+    struct FrameSample
+    {
+        uint64_t start;
+        std::vector<int64_t> values; // per counter, in registration order
+    };
+
+    std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+    std::atomic<bool> capture{ false };
+    std::atomic<uint32_t> nextThread{ GPU_THREAD + 1 };
+    std::atomic<Chunk*> published{ nullptr }; // lock-free stack of full chunks
+    std::mutex mutex;                          // thread names and counter registration
+    std::map<uint32_t, std::string> threadNames;
+    std::vector<const char*> counterNames;
+    std::atomic<int64_t> counters[MAX_COUNTERS + 1] = {};
+    int64_t lastFrameValues[MAX_COUNTERS] = {};
+    uint64_t frameStart = 0;
+
+    // owned by the exporting (GL) thread
+    std::map<uint32_t, std::vector<ProfileEvent>> threadEvents;
+    std::vector<ProfileEvent> gpuEvents;
+    std::vector<FrameSample> frames;
+    void (*gpuCollector)(bool wait) = nullptr;
+
+    Profiler() = default;
+
+    ~Profiler()
+    {
+        Chunk* chunk = published.exchange(nullptr);
+        while (chunk != nullptr)
+        {
+            Chunk* next = chunk->next;
+            delete chunk;
+            chunk = next;
+        }
+    }
+
+    static ThreadBuffer& threadBuffer()
+    {
+        thread_local ThreadBuffer buffer;
+        return buffer;
+    }
+
+    void publish(ThreadBuffer& buffer)
+    {
+        Chunk* chunk = buffer.chunk;
+        buffer.chunk = nullptr;
+        if (chunk == nullptr)
+            return;
+        chunk->next = published.load(std::memory_order_relaxed);
+        while (!published.compare_exchange_weak(chunk->next, chunk, std::memory_order_release, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    // take every published chunk, and the calling thread's own buffer
+    void collect()
+    {
+        publish(threadBuffer());
+        Chunk* chunk = published.exchange(nullptr, std::memory_order_acquire);
+        while (chunk != nullptr)
+        {
+            std::vector<ProfileEvent>& events = threadEvents[chunk->thread];
+            events.insert(events.end(), chunk->events.begin(), chunk->events.end());
+            Chunk* next = chunk->next;
+            delete chunk;
+            chunk = next;
+        }
+        for (auto& thread : threadEvents)
+        {
+            std::sort(thread.second.begin(), thread.second.end(), [](const ProfileEvent& a, const ProfileEvent& b) {
+                return a.start < b.start || (a.start == b.start && a.depth < b.depth);
+            });
+        }
+    }
+
+    std::map<uint32_t, std::string> threadNameList()
+    {
+        std::map<uint32_t, std::string> names;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            names = threadNames;
+        }
+        if (!gpuEvents.empty())
+            names[GPU_THREAD] = "GPU";
+        return names;
+    }
+
+    static std::string escape(const std::string& text)
+    {
+        std::string result;
+        for (char c : text)
+        {
+            if (c == '"' || c == '\\')
+                result += '\\';
+            result += c;
+        }
+        return result;
+    }
+};
+
+// times its scope on the calling thread (PROFILE_ZONE)
+class ProfileZone
+{
+public:
+    explicit ProfileZone(const char* name) : name(name)
+    {
+        Profiler& profiler = Profiler::instance();
+        if (!profiler.capturing())
+            return;
+        active = true;
+        depth = profiler.enterZone();
+        start = profiler.now();
+    }
+
+    ~ProfileZone()
+    {
+        if (active)
+            Profiler::instance().leaveZone(name, start, depth);
+    }
+
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+    const char* name;
+    bool active = false;
+    uint32_t depth = 0;
+    uint64_t start = 0;
+};
+
+#define PALBOM_PROFILE_CONCAT_(a, b) a##b
+#define PALBOM_PROFILE_CONCAT(a, b) PALBOM_PROFILE_CONCAT_(a, b)
+#define PROFILE_ZONE(name) ProfileZone PALBOM_PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define PROFILE_COUNT(name, value)                                                                  \
+    do                                                                                              \
+    {                                                                                               \
+        static const std::size_t profileCounter = Profiler::instance().counter(name);              \
+        Profiler::instance().add(profileCounter, static_cast<int64_t>(value));                     \
+    } while (0)
+#define PROFILE_THREAD(name) Profiler::instance().setThreadName(name)
+#define PROFILE_FRAME() Profiler::instance().endFrame()
+
+#else
+
+#define PROFILE_ZONE(name) ((void)0)
+#define PROFILE_COUNT(name, value) ((void)sizeof(name), (void)sizeof(value))
+#define PROFILE_THREAD(name) ((void)0)
+#define PROFILE_FRAME() ((void)0)
+
+#endif
+
+#endif
@@ -0,0 +1,406 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_inverse.hpp>
+
+#include "profiler.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// render passes in execution order; the pass is the most significant part of a sort key
+enum class RenderPass : uint8_t
+{
+    Opaque = 0,
+    Sky,         // drawn after the opaque geometry with GL_LEQUAL, so it only fills the background
+    Transparent, // back to front
+    Count
+};
+
+// kinds of GL state tracked by GLStateCache
+enum class RenderState
+{
+    Program = 0,
+    TextureUnit, // glActiveTexture
+    Texture,
+    VertexArray,
+    DepthFunc,
+    Sampler,     // sampler uniform of the current program
+    Count
+};
+
+// GL state calls of one frame: issued ones and the ones skipped because the state was already set
+struct RenderStats
+{
+    static constexpr unsigned int STATE_COUNT = static_cast<unsigned int>(RenderState::Count);
+
+    unsigned int submitted = 0; // commands submitted to the queue
+    unsigned int drawCalls = 0;
+    unsigned int triangles = 0; // of GL_TRIANGLES draws, all instances
+    unsigned int uniformUploads = 0; // per-draw uniforms set (model and normal matrix, normal map flag, palette offset)
+    unsigned int changes[STATE_COUNT] = {};
+    unsigned int elided[STATE_COUNT] = {};
+
+    unsigned int stateChanges() const
+    {
+        unsigned int total = 0;
+        for (unsigned int i = 0; i < STATE_COUNT; i++)
+            total += changes[i];
+        return total;
+    }
+
+    unsigned int elidedStateChanges() const
+    {
+        unsigned int total = 0;
+        for (unsigned int i = 0; i < STATE_COUNT; i++)
+            total += elided[i];
+        return total;
+    }
+
+    static const char* stateName(RenderState state)
+    {
+        static const char* names[STATE_COUNT] = { "program", "texture unit", "texture", "vertex array", "depth func", "sampler" };
+        return names[static_cast<unsigned int>(state)];
+    }
+};
+
+// Mirror of the GL state the render queue touches. Every setter compares against the last
+// value it set and only calls GL when it differs. The cache cannot see GL calls made behind
+// its back (texture uploads, Mesh::Draw, other renderers): call invalidate() after any such
+// code ran, which makes the next setter of every state issue its call again.
+class GLStateCache
+{
+public:
+    static constexpr unsigned int TEXTURE_UNITS = 16;
+
+    GLStateCache()
+    {
+        invalidate();
+    }
+
+    void invalidate()
+    {
+        program = UNKNOWN;
+        activeUnit = UNKNOWN;
+        vertexArray = UNKNOWN;
+        depth = 0; // not a valid depth function
+        for (unsigned int i = 0; i < TEXTURE_UNITS; i++)
+            units[i] = TextureBinding();
+        samplers.clear();
+    }
+
+    void useProgram(unsigned int id)
+    {
+        if (!changed(RenderState::Program, program != id))
+            return;
+        program = id;
+        glUseProgram(id);
+    }
+
+    void bindTexture(unsigned int unit, GLenum target, unsigned int texture)
+    {
+        TextureBinding& binding = units[unit];
+        if (!changed(RenderState::Texture, binding.target != target || binding.texture != texture))
+            return;
+        if (changed(RenderState::TextureUnit, activeUnit != unit))
+        {
+            activeUnit = unit;
+            glActiveTexture(GL_TEXTURE0 + unit);
+        }
+        binding.target = target;
+        binding.texture = texture;
+        glBindTexture(target, texture);
+    }
+
+    void bindVertexArray(unsigned int id)
+    {
+        if (!changed(RenderState::VertexArray, vertexArray != id))
+            return;
+        vertexArray = id;
+        glBindVertexArray(id);
+    }
+
+    void depthFunc(GLenum func)
+    {
+        if (!changed(RenderState::DepthFunc, depth != func))
+            return;
+        depth = func;
+        glDepthFunc(func);
+    }
+
+    // point a sampler uniform of the current program at a texture unit
+    void setSampler(GLint location, int unit)
+    {
+        if (location < 0)
+            return;
+        uint64_t key = static_cast<uint64_t>(program) << 32 | static_cast<uint32_t>(location);
+        auto it = samplers.find(key);
+        if (!changed(RenderState::Sampler, it == samplers.end() || it->second != unit))
+            return;
+        samplers[key] = unit;
+        glUniform1i(location, unit);
+    }
+
+    // counts since the last takeStats()
+    RenderStats takeStats()
+    {
+        RenderStats result = stats;
+        stats = RenderStats();
+        return result;
+    }
+
+private:
+    static constexpr unsigned int UNKNOWN = ~0u;
+
+    struct TextureBinding
+    {
+        GLenum target = 0;
+        unsigned int texture = UNKNOWN;
+    };
+
+    unsigned int program;
+    unsigned int activeUnit;
+    unsigned int vertexArray;
+    GLenum depth;
+    TextureBinding units[TEXTURE_UNITS];
+    std::unordered_map<uint64_t, int> samplers; // (program, location) -> unit
+    RenderStats stats;
+
+    bool changed(RenderState state, bool differs)
+    {
+        unsigned int index = static_cast<unsigned int>(state);
+        if (differs)
+            stats.changes[index]++;
+        else
+            stats.elided[index]++;
+        return differs;
+    }
+};
+
+// One draw: the state it needs and the call that draws it. Textures are bound to units
+// 0..textureCount-1; a texture with a sampler location also points that sampler at its unit.
+struct RenderCommand
+{
+    static constexpr unsigned int MAX_TEXTURES = 4;
+
+    struct Texture
+    {
+        GLenum target = GL_TEXTURE_2D;
+        unsigned int id = 0;
+        GLint sampler = -1;
+    };
+
+    RenderPass pass = RenderPass::Opaque;
+    float depth = 0.0f; // view depth normalised to [0, 1]
+    uint64_t key = 0;   // filled in by RenderQueue::submit
+
+    unsigned int program = 0;
+    unsigned int vertexArray = 0;
+    GLenum depthFunc = GL_LESS;
+    unsigned int textureCount = 0;
+    Texture textures[MAX_TEXTURES];
+
+    // glDrawElements(Instanced) with unsigned int indices when indexed, else glDrawArrays(Instanced);
+    // first is the first index (indexed) or vertex drawn
+    bool indexed = true;
+    GLenum primitive = GL_TRIANGLES;
+    GLint first = 0;
+    GLsizei count = 0;
+    GLsizei instances = 1;
+
+    // optional per-draw model matrix uniform and the normal matrix uniform that goes with it
+    // (transpose(inverse(mat3(model))), computed on the CPU; setModel fills in both)
+    GLint modelLocation = -1;
+    GLint normalMatrixLocation = -1;
+    glm::mat4 model = glm::mat4(1.0f);
+    glm::mat3 normalMatrix = glm::mat3(1.0f);
+
+    // optional per-draw useNormalMap uniform of shaders/model.fs, filled in by Mesh::Submit
+    GLint normalMapLocation = -1;
+    GLint normalMap = 0;
+
+    // optional per-draw bone palette offset uniform of skinned draws (see bone_palette_buffer.h)
+    GLint paletteLocation = -1;
+    GLint paletteOffset = 0;
+
+    void setModel(const glm::mat4& matrix)
+    {
+        model = matrix;
+        normalMatrix = glm::inverseTranspose(glm::mat3(matrix));
+    }
+
+    void addTexture(GLenum target, unsigned int id, GLint sampler = -1)
+    {
+        if (textureCount == MAX_TEXTURES)
+            return;
+        textures[textureCount].target = target;
+        textures[textureCount].id = id;
+        textures[textureCount].sampler = sampler;
+        textureCount++;
+    }
+};
+
+// Collects the draws of a frame, sorts them once by their 64-bit key and executes them
+// through a GLStateCache, so draws sharing a program, textures or a vertex array run back to
+// back and the cache skips the repeated state. Keys are laid out from the most significant
+// bit as
+//
+//     opaque, sky:  pass 4 | program 10 | material 16 | vertex array 10 | depth 24 (front to back)
+//     transparent:  pass 4 | depth 24 (back to front) | program 10 | material 16 | vertex array 10
+//
+// GL names and the material hash are truncated to their fields; a collision only costs
+// sorting quality, never correctness. Draws with equal keys keep their submission order.
+class RenderQueue
+{
+public:
+    static uint64_t makeKey(RenderPass pass, unsigned int program, unsigned int material, unsigned int vertexArray, float depth)
+    {
+        uint64_t depthBits = static_cast<uint64_t>(std::min(std::max(depth, 0.0f), 1.0f) * DEPTH_MASK);
+        uint64_t state = (static_cast<uint64_t>(program) & PROGRAM_MASK) << 26 | (static_cast<uint64_t>(material) & MATERIAL_MASK) << 10
+            | (static_cast<uint64_t>(vertexArray) & VERTEX_ARRAY_MASK);
+        uint64_t key = static_cast<uint64_t>(pass) << 60;
+        if (pass == RenderPass::Transparent)
+            return key | (DEPTH_MASK - depthBits) << 36 | state;
+        return key | state << 24 | depthBits;
+    }
+
+    // FNV-1a over the bound textures
+    static unsigned int materialId(const RenderCommand& command)
+    {
+        uint32_t hash = 2166136261u;
+        for (unsigned int i = 0; i < command.textureCount; i++)
+        {
+            hash = (hash ^ command.textures[i].id) * 16777619u;
+            hash = (hash ^ command.textures[i].target) * 16777619u;
+        }
+        return hash ^ hash >> 16;
+    }
+
+    // queue a draw for this frame; its key is derived from its state and depth
+    void submit(const RenderCommand& command)
+    {
+        if (command.count <= 0 || command.instances <= 0)
+            return;
+        commands.push_back(command);
+        commands.back().key = makeKey(command.pass, command.program, materialId(command), command.vertexArray, command.depth);
+    }
+
+    std::size_t size() const
+    {
+        return commands.size();
+    }
+
+    // sort and draw everything submitted since the last execute(), then empty the queue.
+    // Leaves vertex array 0 bound, so later buffer setup cannot modify a queued VAO.
+    // returns the counts of this frame (also kept in stats())
+    const RenderStats& execute(GLStateCache& state)
+    {
+        PROFILE_ZONE("RenderQueue::execute");
+        order.resize(commands.size());
+        for (std::size_t i = 0; i < commands.size(); i++)
+            order[i] = { commands[i].key, static_cast<uint32_t>(i) };
+        std::sort(order.begin(), order.end(), [](const SortEntry& a, const SortEntry& b) {
+            return a.key < b.key || (a.key == b.key && a.index < b.index);
+        });
+
+        state.takeStats();
+        unsigned int drawCalls = 0, triangles = 0, uniformUploads = 0;
+        for (const SortEntry& entry : order)
+        {
+            const RenderCommand& command = commands[entry.index];
+            state.useProgram(command.program);
+            for (unsigned int unit = 0; unit < command.textureCount; unit++)
+            {
+                const RenderCommand::Texture& texture = command.textures[unit];
+                state.setSampler(texture.sampler, static_cast<int>(unit));
+                state.bindTexture(unit, texture.target, texture.id);
+            }
+            state.bindVertexArray(command.vertexArray);
+            state.depthFunc(command.depthFunc);
+            if (command.modelLocation >= 0)
+            {
+                glUniformMatrix4fv(command.modelLocation, 1, GL_FALSE, &command.model[0][0]);
+                uniformUploads++;
+            }
+            if (command.normalMatrixLocation >= 0)
+            {
+                glUniformMatrix3fv(command.normalMatrixLocation, 1, GL_FALSE, &command.normalMatrix[0][0]);
+                uniformUploads++;
+            }
+            if (command.normalMapLocation >= 0)
+            {
+                glUniform1i(command.normalMapLocation, command.normalMap);
+                uniformUploads++;
+            }
+            if (command.paletteLocation >= 0)
+            {
+                glUniform1i(command.paletteLocation, command.paletteOffset);
+                uniformUploads++;
+            }
+            draw(command);
+            drawCalls++;
+            if (command.primitive == GL_TRIANGLES)
+                triangles += static_cast<unsigned int>(command.count / 3 * command.instances);
+        }
+        state.bindVertexArray(0);
+
+        lastStats = state.takeStats();
+        lastStats.submitted = static_cast<unsigned int>(commands.size());
+        lastStats.drawCalls = drawCalls;
+        lastStats.triangles = triangles;
+        lastStats.uniformUploads = uniformUploads;
+        commands.clear();
+
+        PROFILE_COUNT("draw calls", drawCalls);
+        PROFILE_COUNT("uniform uploads", uniformUploads + lastStats.changes[static_cast<unsigned int>(RenderState::Sampler)]);
+        PROFILE_COUNT("texture binds", lastStats.changes[static_cast<unsigned int>(RenderState::Texture)]);
+        return lastStats;
+    }
+
+    // counts of the last execute()
+    const RenderStats& stats() const
+    {
+        return lastStats;
+    }
+
+private:
+    static constexpr uint64_t PROGRAM_MASK = (1u << 10) - 1;
+    static constexpr uint64_t MATERIAL_MASK = (1u << 16) - 1;
+    static constexpr uint64_t VERTEX_ARRAY_MASK = (1u << 10) - 1;
+    static constexpr uint64_t DEPTH_MASK = (1u << 24) - 1;
+
+    struct SortEntry
+    {
+        uint64_t key;
+        uint32_t index;
+    };
+
+    std::vector<RenderCommand> commands;
+    std::vector<SortEntry> order;
+    RenderStats lastStats;
+
+    static void draw(const RenderCommand& command)
+    {
+        if (command.indexed)
+        {
+            const void* offset = reinterpret_cast<const void*>(static_cast<uintptr_t>(command.first) * sizeof(unsigned int));
+            if (command.instances == 1)
+                glDrawElements(command.primitive, command.count, GL_UNSIGNED_INT, offset);
+            else
+                glDrawElementsInstanced(command.primitive, command.count, GL_UNSIGNED_INT, offset, command.instances);
+        }
+        else
+        {
+            if (command.instances == 1)
+                glDrawArrays(command.primitive, command.first, command.count);
+            else
+                glDrawArraysInstanced(command.primitive, command.first, command.count, command.instances);
+        }
+    }
+};
+
+#endif
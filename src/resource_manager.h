@@ -0,0 +1,485 @@
+#ifndef RESOURCE_MANAGER_H
+#define RESOURCE_MANAGER_H
+
+#include <glad/glad.h>
+
+#include <learnopengl/shader_m.h>
+
+#include "shader_manager.h"
+#include "texture_loader.h"
+#include "vertex_formats.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <iomanip>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// typed reference to a resource of a ResourceManager; generation 0 is the null handle
+template<typename Tag>
+struct ResourceHandle
+{
+    uint32_t index = 0;
+    uint32_t generation = 0;
+
+    bool valid() const
+    {
+        return generation != 0;
+    }
+
+    bool operator==(const ResourceHandle& other) const
+    {
+        return index == other.index && generation == other.generation;
+    }
+
+    bool operator!=(const ResourceHandle& other) const
+    {
+        return !(*this == other);
+    }
+};
+
+struct TextureResourceTag {};
+struct MeshResourceTag {};
+struct ShaderResourceTag {};
+using TextureHandle = ResourceHandle<TextureResourceTag>;
+using MeshHandle = ResourceHandle<MeshResourceTag>;
+using ShaderHandle = ResourceHandle<ShaderResourceTag>;
+
+// GPU memory held by a ResourceManager, see ResourceManager::report()
+struct ResourceReport
+{
+    struct Entry
+    {
+        const char* kind; // "texture", "mesh" or "shader"
+        std::string name;
+        uint32_t references; // 0 while waiting for deferred destruction
+        std::size_t bytes;   // estimated from the level 0 size and format for textures
+    };
+
+    struct Totals
+    {
+        std::size_t count = 0;
+        std::size_t references = 0;
+        std::size_t bytes = 0;
+    };
+
+    std::vector<Entry> entries; // largest first
+    Totals textures, meshes, shaders;
+    std::size_t acquisitions = 0; // acquire calls so far
+    std::size_t sharedHits = 0;   // acquire calls served by a resident resource
+
+    std::size_t totalBytes() const
+    {
+        return textures.bytes + meshes.bytes + shaders.bytes;
+    }
+
+    void print(std::ostream& out, std::size_t maxEntries = 10) const
+    {
+        auto line = [&out](const char* kind, const Totals& totals) {
+            out << "  " << std::left << std::setw(9) << kind << std::right << std::setw(5) << totals.count << " objects "
+                << std::setw(6) << totals.references << " refs " << std::fixed << std::setprecision(2) << std::setw(9)
+                << totals.bytes / (1024.0 * 1024.0) << " MiB" << std::endl;
+        };
+        out << "GPU resources: " << std::fixed << std::setprecision(2) << totalBytes() / (1024.0 * 1024.0) << " MiB, "
+            << sharedHits << " of " << acquisitions << " acquisitions shared" << std::endl;
+        line("textures", textures);
+        line("meshes", meshes);
+        line("shaders", shaders);
+        for (std::size_t i = 0; i < entries.size() && i < maxEntries; i++)
+        {
+            out << "    " << std::left << std::setw(8) << entries[i].kind << std::right << std::setw(4) << entries[i].references
+                << "x " << std::setprecision(1) << std::setw(9) << entries[i].bytes / 1024.0 << " KiB  " << entries[i].name << std::endl;
+        }
+    }
+};
+
+// Process-wide owner of textures, meshes and shader programs, so objects loaded from the same
+// source exist once on the GPU however many models, renderers or characters use them.
+//
+// Resources are looked up by a 64 bit FNV-1a hash of their normalised path (plus the load
+// options), handed out as typed, generation-checked handles and reference counted: every
+// acquire must be paired with a release. A resource whose count drops to 0 is not deleted
+// right away but DESTROY_DELAY_FRAMES collectGarbage() calls later, since frames already
+// submitted may still read it, and acquiring it again in between revives it without a reload.
+//
+// Textures are created through the TextureLoader (asynchronous decode, baked containers).
+// Meshes are uploaded by the caller on the first acquire and adopted here. Shader programs are
+// built by the ShaderManager (includes, variants, binary cache, hot reload), see shaderManager().
+class ResourceManager
+{
+public:
+    static constexpr uint64_t DESTROY_DELAY_FRAMES = 3;
+
+    explicit ResourceManager(TextureLoader& textureLoader)
+        : textureLoader(textureLoader)
+    {
+    }
+
+    ResourceManager(const ResourceManager&) = delete;
+    ResourceManager& operator=(const ResourceManager&) = delete;
+
+    // delete every GL object, referenced or not; must be called while the context is still current
+    void release()
+    {
+        for (auto& slot : textures.slots)
+        {
+            if (slot.live)
+                destroy(slot.resource);
+        }
+        for (auto& slot : meshes.slots)
+        {
+            if (slot.live)
+                destroy(slot.resource);
+        }
+        for (auto& slot : shaders.slots)
+        {
+            if (slot.live)
+                destroy(slot.resource);
+        }
+        textures = Pool<TextureEntry>();
+        meshes = Pool<GpuMesh>();
+        shaders = Pool<std::unique_ptr<Shader>>();
+    }
+
+    // textures
+    // ------------------------------------------------------------------------
+    TextureHandle acquireTexture(const std::string& path, bool flipVertically = true)
+    {
+        std::string name = normalise(path) + (flipVertically ? "" : " (unflipped)");
+        return acquire<TextureHandle>(textures, name, [&]() {
+            return TextureEntry{ textureLoader.load2D(path, flipVertically), GL_TEXTURE_2D };
+        });
+    }
+
+    TextureHandle acquireCubemap(const std::vector<std::string>& faces)
+    {
+        std::string name = "cubemap";
+        for (const std::string& face : faces)
+            name += " " + normalise(face);
+        return acquire<TextureHandle>(textures, name, [&]() {
+            return TextureEntry{ textureLoader.loadCubemap(faces), GL_TEXTURE_CUBE_MAP };
+        });
+    }
+
+    // GL texture name, 0 for a stale handle
+    unsigned int texture(TextureHandle handle) const
+    {
+        const auto* slot = textures.find(handle);
+        return slot ? slot->resource.id : 0;
+    }
+
+    // meshes
+    // ------------------------------------------------------------------------
+    // the mesh stored under key; upload() runs only if it is not resident, and the manager
+    // takes ownership of the buffers it returns
+    MeshHandle acquireMesh(const std::string& key, const std::function<GpuMesh()>& upload)
+    {
+        return acquire<MeshHandle>(meshes, key, upload);
+    }
+
+    const GpuMesh& mesh(MeshHandle handle) const
+    {
+        const auto* slot = meshes.find(handle);
+        assert(slot);
+        return slot->resource;
+    }
+
+    // shader programs; defines select a variant of the sources (see ShaderManager)
+    // ------------------------------------------------------------------------
+    ShaderHandle acquireShader(const std::string& vertexPath, const std::string& fragmentPath,
+        const std::vector<std::string>& defines = std::vector<std::string>())
+    {
+        std::string name = normalise(vertexPath) + " + " + normalise(fragmentPath);
+        for (const std::string& define : defines)
+            name += " " + define;
+        return acquire<ShaderHandle>(shaders, name, [&]() {
+            return shaderPrograms.build(vertexPath, fragmentPath, defines);
+        });
+    }
+
+    Shader& shader(ShaderHandle handle)
+    {
+        auto* slot = shaders.find(handle);
+        assert(slot);
+        return *slot->resource;
+    }
+
+    ShaderManager& shaderManager()
+    {
+        return shaderPrograms;
+    }
+
+    // reference counting
+    // ------------------------------------------------------------------------
+    void release(TextureHandle handle)
+    {
+        releaseSlot(textures, handle);
+    }
+
+    void release(MeshHandle handle)
+    {
+        releaseSlot(meshes, handle);
+    }
+
+    void release(ShaderHandle handle)
+    {
+        releaseSlot(shaders, handle);
+    }
+
+    // call once per frame: deletes the resources released DESTROY_DELAY_FRAMES frames ago
+    // and not acquired again since. Returns the number of GL objects deleted.
+    std::size_t collectGarbage()
+    {
+        frame++;
+        return collect(textures) + collect(meshes) + collect(shaders);
+    }
+
+    // every resident resource with its reference count and estimated size; textures are
+    // measured by querying GL, so call it outside the frame loop
+    ResourceReport report() const
+    {
+        ResourceReport result;
+        for (const auto& slot : textures.slots)
+        {
+            if (slot.live)
+                add(result, result.textures, "texture", slot, textureBytes(slot.resource));
+        }
+        for (const auto& slot : meshes.slots)
+        {
+            if (slot.live)
+                add(result, result.meshes, "mesh", slot, slot.resource.vertexBufferSize + slot.resource.indexBufferSize);
+        }
+        for (const auto& slot : shaders.slots)
+        {
+            if (slot.live)
+                add(result, result.shaders, "shader", slot, 0);
+        }
+        std::stable_sort(result.entries.begin(), result.entries.end(),
+            [](const ResourceReport::Entry& a, const ResourceReport::Entry& b) { return a.bytes > b.bytes; });
+        result.acquisitions = acquisitions;
+        result.sharedHits = sharedHits;
+        return result;
+    }
+
+    // FNV-1a, the same hash the baked containers use for their sources
+    static uint64_t hashKey(const std::string& key)
+    {
+        uint64_t hash = 14695981039346656037ull;
+        for (unsigned char c : key)
+        {
+            hash ^= c;
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    // "assets/Character/../Character/a.png" and "assets/Character/a.png" name the same file
+    static std::string normalise(const std::string& path)
+    {
+        return std::filesystem::path(path).lexically_normal().generic_string();
+    }
+
+private:
+    struct TextureEntry
+    {
+        unsigned int id = 0;
+        GLenum target = GL_TEXTURE_2D;
+    };
+
+    template<typename Resource>
+    struct Slot
+    {
+        Resource resource{};
+        std::string name;
+        uint64_t key = 0;
+        uint32_t generation = 0;
+        uint32_t references = 0;
+        uint64_t releasedFrame = 0;
+        bool live = false;
+    };
+
+    template<typename Resource>
+    struct Pool
+    {
+        std::vector<Slot<Resource>> slots;
+        std::vector<uint32_t> freeSlots;
+        std::unordered_map<uint64_t, uint32_t> lookup; // hashed key -> slot
+        std::size_t waiting = 0; // live slots without references
+
+        template<typename Handle>
+        Slot<Resource>* find(Handle handle)
+        {
+            if (handle.index >= slots.size() || slots[handle.index].generation != handle.generation || !slots[handle.index].live)
+                return nullptr;
+            return &slots[handle.index];
+        }
+
+        template<typename Handle>
+        const Slot<Resource>* find(Handle handle) const
+        {
+            return const_cast<Pool*>(this)->find(handle);
+        }
+    };
+
+    TextureLoader& textureLoader;
+    ShaderManager shaderPrograms;
+    Pool<TextureEntry> textures;
+    Pool<GpuMesh> meshes;
+    Pool<std::unique_ptr<Shader>> shaders;
+    uint64_t frame = 0;
+    std::size_t acquisitions = 0;
+    std::size_t sharedHits = 0;
+
+    template<typename Handle, typename Resource, typename Create>
+    Handle acquire(Pool<Resource>& pool, const std::string& name, const Create& create)
+    {
+        acquisitions++;
+        uint64_t key = hashKey(name);
+        auto it = pool.lookup.find(key);
+        if (it != pool.lookup.end())
+        {
+            Slot<Resource>& slot = pool.slots[it->second];
+            assert(slot.name == name && "resource key hash collision");
+            if (slot.references++ == 0)
+                pool.waiting--; // revived before its deferred destruction
+            sharedHits++;
+            return Handle{ it->second, slot.generation };
+        }
+
+        uint32_t index;
+        if (!pool.freeSlots.empty())
+        {
+            index = pool.freeSlots.back();
+            pool.freeSlots.pop_back();
+        }
+        else
+        {
+            index = static_cast<uint32_t>(pool.slots.size());
+            pool.slots.emplace_back();
+        }
+        Slot<Resource>& slot = pool.slots[index];
+        slot.resource = create();
+        slot.name = name;
+        slot.key = key;
+        slot.generation++;
+        slot.references = 1;
+        slot.live = true;
+        pool.lookup[key] = index;
+        return Handle{ index, slot.generation };
+    }
+
+    template<typename Resource, typename Handle>
+    void releaseSlot(Pool<Resource>& pool, Handle handle)
+    {
+        Slot<Resource>* slot = pool.find(handle);
+        if (slot == nullptr || slot->references == 0)
+            return;
+        if (--slot->references == 0)
+        {
+            slot->releasedFrame = frame;
+            pool.waiting++;
+        }
+    }
+
+    template<typename Resource>
+    std::size_t collect(Pool<Resource>& pool)
+    {
+        if (pool.waiting == 0)
+            return 0;
+        std::size_t destroyed = 0;
+        for (uint32_t index = 0; index < pool.slots.size(); index++)
+        {
+            Slot<Resource>& slot = pool.slots[index];
+            if (!slot.live || slot.references > 0 || frame - slot.releasedFrame < DESTROY_DELAY_FRAMES)
+                continue;
+            destroy(slot.resource);
+            pool.lookup.erase(slot.key);
+            slot.resource = Resource();
+            slot.name.clear();
+            slot.live = false;
+            pool.freeSlots.push_back(index);
+            pool.waiting--;
+            destroyed++;
+        }
+        return destroyed;
+    }
+
+    void destroy(TextureEntry& texture)
+    {
+        textureLoader.cancel(texture.id);
+        glDeleteTextures(1, &texture.id);
+    }
+
+    static void destroy(GpuMesh& mesh)
+    {
+        if (mesh.VAO != 0)
+            glDeleteVertexArrays(1, &mesh.VAO);
+        glDeleteBuffers(1, &mesh.VBO);
+        glDeleteBuffers(1, &mesh.EBO);
+    }
+
+    void destroy(std::unique_ptr<Shader>& shader)
+    {
+        shaderPrograms.forget(shader.get());
+        glDeleteProgram(shader->ID);
+    }
+
+    template<typename Resource>
+    static void add(ResourceReport& report, ResourceReport::Totals& totals, const char* kind, const Slot<Resource>& slot, std::size_t bytes)
+    {
+        totals.count++;
+        totals.references += slot.references;
+        totals.bytes += bytes;
+        report.entries.push_back(ResourceReport::Entry{ kind, slot.name, slot.references, bytes });
+    }
+
+    // level 0 size times the bytes per texel of its format, plus a third for the mip chain
+    static std::size_t textureBytes(const TextureEntry& texture)
+    {
+        GLenum level0 = texture.target == GL_TEXTURE_CUBE_MAP ? GL_TEXTURE_CUBE_MAP_POSITIVE_X : texture.target;
+        GLint width = 0, height = 0, format = 0, compressed = 0, compressedSize = 0, maxLevel = 0;
+        glBindTexture(texture.target, texture.id);
+        glGetTexLevelParameteriv(level0, 0, GL_TEXTURE_WIDTH, &width);
+        glGetTexLevelParameteriv(level0, 0, GL_TEXTURE_HEIGHT, &height);
+        glGetTexLevelParameteriv(level0, 0, GL_TEXTURE_INTERNAL_FORMAT, &format);
+        glGetTexLevelParameteriv(level0, 0, GL_TEXTURE_COMPRESSED, &compressed);
+        if (compressed)
+            glGetTexLevelParameteriv(level0, 0, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &compressedSize);
+        glGetTexParameteriv(texture.target, GL_TEXTURE_MAX_LEVEL, &maxLevel);
+        GLint minFilter = 0;
+        glGetTexParameteriv(texture.target, GL_TEXTURE_MIN_FILTER, &minFilter);
+        glBindTexture(texture.target, 0);
+
+        std::size_t bytes;
+        if (compressed)
+        {
+            bytes = static_cast<std::size_t>(compressedSize);
+        }
+        else
+        {
+            std::size_t texel = 4;
+            if (format == GL_RED || format == GL_R8)
+                texel = 1;
+            else if (format == GL_RG || format == GL_RG8)
+                texel = 2;
+            else if (format == GL_RGB || format == GL_RGB8 || format == GL_SRGB8)
+                texel = 3;
+            bytes = static_cast<std::size_t>(width) * height * texel;
+        }
+        bool mipmapped = minFilter != GL_LINEAR && minFilter != GL_NEAREST && maxLevel > 0;
+        if (mipmapped)
+            bytes += bytes / 3;
+        if (texture.target == GL_TEXTURE_CUBE_MAP)
+            bytes *= 6;
+        return bytes;
+    }
+};
+
+#endif
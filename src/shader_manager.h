@@ -0,0 +1,519 @@
+#ifndef SHADER_MANAGER_H
+#define SHADER_MANAGER_H
+
+#include <glad/glad.h>
+
+#include <learnopengl/shader_m.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Program binary cache entry (.pbsh): the driver's binary of a linked program, named after and
+// tagged with the hash of its preprocessed sources and the driver strings.
+struct ProgramBinaryHeader
+{
+    static constexpr uint32_t MAGIC = 0x48534250; // "PBSH"
+    static constexpr uint32_t VERSION = 1;
+
+    uint32_t magic = MAGIC;
+    uint32_t version = VERSION;
+    uint32_t format = 0; // binaryFormat reported by glGetProgramBinary
+    uint32_t size = 0;
+    uint64_t key = 0;
+};
+
+static_assert(sizeof(ProgramBinaryHeader) == 24, "ProgramBinaryHeader layout is part of the file format");
+
+// Builds shader programs from files with two additions to GLSL and two ways to skip work:
+//  - `#include "file"` pastes another file, so stages share the uniform block, lighting and
+//    decoding code. The path is relative to the directory of the including file (shaders/tile.vs
+//    has `#include "include/frame_uniforms.glsl"`); each file is pasted at most once per stage;
+//  - defines (e.g. "SKINNED", "MAX_LIGHTS=4") are inserted after the #version line, so one
+//    source yields several variants selected with #ifdef. A file built with defines must have
+//    a #version line, otherwise the build fails;
+//  - with enableBinaryCache(), linked programs are stored through glGetProgramBinary and
+//    later created with glProgramBinary instead of compiling and linking. Entries are keyed
+//    by a hash of the preprocessed sources and the GL vendor, renderer and version strings;
+//    a missing, stale or rejected entry falls back to compiling from source;
+//  - with setHotReload(true) (development), checkForChanges() relinks every program one of
+//    whose files changed on disk into the same program object, so handles and render
+//    commands stay valid. A source that fails to compile keeps the old program running.
+class ShaderManager
+{
+public:
+    struct Stats
+    {
+        unsigned int programs = 0;     // built through build()
+        unsigned int cacheHits = 0;    // created from a cached binary
+        unsigned int cacheMisses = 0;  // compiled although the cache is enabled
+        unsigned int reloads = 0;      // relinked by checkForChanges()
+        double buildMs = 0.0;          // total time spent in build()
+    };
+
+    ShaderManager() = default;
+    ShaderManager(const ShaderManager&) = delete;
+    ShaderManager& operator=(const ShaderManager&) = delete;
+
+    // store linked programs under directory (created if needed). Needs GL 4.1 or
+    // ARB_get_program_binary with at least one binary format; returns false (and keeps
+    // compiling from source) otherwise. load resolves the entry points, e.g. glfwGetProcAddress
+    bool enableBinaryCache(const std::string& directory, GLADloadproc load)
+    {
+        GLint major = 0, minor = 0, formats = 0;
+        glGetIntegerv(GL_MAJOR_VERSION, &major);
+        glGetIntegerv(GL_MINOR_VERSION, &minor);
+        bool supported = major > 4 || (major == 4 && minor >= 1) || hasExtension("GL_ARB_get_program_binary");
+        if (supported)
+        {
+            getProgramBinary = reinterpret_cast<GetProgramBinaryProc>(load("glGetProgramBinary"));
+            programBinary = reinterpret_cast<ProgramBinaryProc>(load("glProgramBinary"));
+            programParameteri = reinterpret_cast<ProgramParameteriProc>(load("glProgramParameteri"));
+            glGetIntegerv(NUM_PROGRAM_BINARY_FORMATS, &formats);
+        }
+        if (!supported || formats <= 0 || !getProgramBinary || !programBinary || !programParameteri)
+        {
+            std::cout << "Shader binary cache unavailable (needs GL 4.1 or ARB_get_program_binary)" << std::endl;
+            return false;
+        }
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+        cacheDirectory = directory;
+        driver = std::string(glString(GL_VENDOR)) + "\n" + glString(GL_RENDERER) + "\n" + glString(GL_VERSION);
+        return true;
+    }
+
+    bool binaryCacheEnabled() const { return !cacheDirectory.empty(); }
+
+    // watch the files of every program built from now on
+    void setHotReload(bool enabled)
+    {
+        hotReload = enabled;
+        if (!enabled)
+            watched.clear();
+    }
+
+    // build the program of a vertex and a fragment shader file with the given defines
+    // ------------------------------------------------------------------------
+    std::unique_ptr<Shader> build(const std::string& vertexPath, const std::string& fragmentPath,
+        const std::vector<std::string>& defines = std::vector<std::string>())
+    {
+        auto start = std::chrono::steady_clock::now();
+        Watch watch;
+        watch.vertexPath = vertexPath;
+        watch.fragmentPath = fragmentPath;
+        watch.defines = defines;
+        Sources sources = preprocessProgram(watch);
+
+        uint64_t key = programKey(sources);
+        unsigned int program = binaryCacheEnabled() && sources.ok ? loadBinary(key) : 0;
+        if (program != 0)
+        {
+            stats.cacheHits++;
+        }
+        else
+        {
+            program = glCreateProgram();
+            if (binaryCacheEnabled())
+                programParameteri(program, PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+            if (link(program, sources) && binaryCacheEnabled())
+                saveBinary(program, key);
+            if (binaryCacheEnabled())
+                stats.cacheMisses++;
+        }
+
+        std::unique_ptr<Shader> shader(new Shader(program));
+        if (hotReload)
+        {
+            watch.shader = shader.get();
+            watched.push_back(watch);
+        }
+        stats.programs++;
+        stats.buildMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        return shader;
+    }
+
+    // stop watching a program (call before deleting it)
+    void forget(const Shader* shader)
+    {
+        for (std::size_t i = 0; i < watched.size(); i++)
+        {
+            if (watched[i].shader == shader)
+            {
+                watched[i] = watched.back();
+                watched.pop_back();
+                return;
+            }
+        }
+    }
+
+    // hot reload: relink the programs whose files changed since they were built or last
+    // checked. Cheap when nothing changed (one timestamp query per file), but still meant to
+    // be called a few times per second rather than every frame. Returns the programs relinked
+    // ------------------------------------------------------------------------
+    std::size_t checkForChanges()
+    {
+        std::size_t relinked = 0;
+        for (Watch& watch : watched)
+        {
+            bool changed = false;
+            for (WatchedFile& file : watch.files)
+                changed |= file.refresh();
+            if (!changed)
+                continue;
+
+            Sources sources = preprocessProgram(watch);
+            unsigned int test = glCreateProgram();
+            bool ok = link(test, sources);
+            glDeleteProgram(test);
+            if (!ok)
+            {
+                std::cout << "Shader reload failed, keeping the previous program: " << watch.vertexPath << " + " << watch.fragmentPath << std::endl;
+                continue;
+            }
+            // the sources link: relink the live program object so every reference to it stays valid
+            if (binaryCacheEnabled())
+                programParameteri(watch.shader->ID, PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+            link(watch.shader->ID, sources);
+            if (binaryCacheEnabled())
+                saveBinary(watch.shader->ID, programKey(sources));
+            watch.shader->relinked();
+            stats.reloads++;
+            relinked++;
+            std::cout << "Shader reloaded: " << watch.vertexPath << " + " << watch.fragmentPath << std::endl;
+        }
+        return relinked;
+    }
+
+    const Stats& statistics() const { return stats; }
+
+    // expand the #includes of a shader file into out and insert the defines after its #version
+    // line; files receives every file read, in the order of the `#line` source numbers emitted.
+    // Returns false (after printing why) if a file is missing or an include is malformed, or
+    // if there are defines but no #version line to insert them after
+    // ------------------------------------------------------------------------
+    static bool preprocess(const std::string& path, const std::vector<std::string>& defines, std::vector<std::string>& files, std::string& out)
+    {
+        std::string prelude;
+        for (const std::string& define : defines)
+        {
+            std::string text = define;
+            std::string::size_type equals = text.find('=');
+            if (equals != std::string::npos)
+                text[equals] = ' ';
+            prelude += "#define " + text + "\n";
+        }
+        return expand(ResourcePath(path), prelude, files, out, 0);
+    }
+
+private:
+    // entry points of GL 4.1 / ARB_get_program_binary, which a GL 3.3 loader does not provide
+    typedef void (APIENTRYP GetProgramBinaryProc)(GLuint, GLsizei, GLsizei*, GLenum*, void*);
+    typedef void (APIENTRYP ProgramBinaryProc)(GLuint, GLenum, const void*, GLsizei);
+    typedef void (APIENTRYP ProgramParameteriProc)(GLuint, GLenum, GLint);
+    static constexpr GLenum PROGRAM_BINARY_RETRIEVABLE_HINT = 0x8257;
+    static constexpr GLenum PROGRAM_BINARY_LENGTH = 0x8741;
+    static constexpr GLenum NUM_PROGRAM_BINARY_FORMATS = 0x87FE;
+    static constexpr int MAX_INCLUDE_DEPTH = 16;
+
+    // a file a program was built from and its last known modification time
+    struct WatchedFile
+    {
+        std::string path;
+        std::filesystem::file_time_type time;
+
+        // true if the file changed since the last call
+        bool refresh()
+        {
+            std::error_code error;
+            std::filesystem::file_time_type current = std::filesystem::last_write_time(path, error);
+            if (error || current == time)
+                return false;
+            time = current;
+            return true;
+        }
+    };
+
+    struct Watch
+    {
+        Shader* shader = nullptr;
+        std::string vertexPath;
+        std::string fragmentPath;
+        std::vector<std::string> defines;
+        std::vector<WatchedFile> files; // both stages, includes included
+    };
+
+    struct Sources
+    {
+        std::string vertex;
+        std::string fragment;
+        std::vector<std::string> vertexFiles;
+        std::vector<std::string> fragmentFiles;
+        bool ok = true; // false if either stage failed to preprocess
+    };
+
+    typedef std::filesystem::path ResourcePath;
+
+    GetProgramBinaryProc getProgramBinary = nullptr;
+    ProgramBinaryProc programBinary = nullptr;
+    ProgramParameteriProc programParameteri = nullptr;
+    std::string cacheDirectory;
+    std::string driver;
+    bool hotReload = false;
+    std::vector<Watch> watched;
+    Stats stats;
+
+    static const char* glString(GLenum name)
+    {
+        const GLubyte* value = glGetString(name);
+        return value ? reinterpret_cast<const char*>(value) : "";
+    }
+
+    static bool hasExtension(const char* name)
+    {
+        GLint count = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+        for (GLint i = 0; i < count; i++)
+        {
+            const GLubyte* extension = glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i));
+            if (extension && std::string(reinterpret_cast<const char*>(extension)) == name)
+                return true;
+        }
+        return false;
+    }
+
+    // preprocess both stages and (re)record the files to watch with their current times
+    Sources preprocessProgram(Watch& watch) const
+    {
+        Sources sources;
+        sources.ok = preprocess(watch.vertexPath, watch.defines, sources.vertexFiles, sources.vertex);
+        sources.ok &= preprocess(watch.fragmentPath, watch.defines, sources.fragmentFiles, sources.fragment);
+        watch.files.clear();
+        for (const std::vector<std::string>* files : { &sources.vertexFiles, &sources.fragmentFiles })
+        {
+            for (const std::string& path : *files)
+            {
+                WatchedFile file;
+                file.path = path;
+                file.refresh();
+                watch.files.push_back(file);
+            }
+        }
+        return sources;
+    }
+
+    static bool expand(const ResourcePath& path, const std::string& prelude, std::vector<std::string>& files, std::string& out, int depth)
+    {
+        std::string normalised = path.lexically_normal().generic_string();
+        for (const std::string& file : files)
+        {
+            if (file == normalised)
+                return true; // already pasted once
+        }
+        std::ifstream stream(normalised);
+        if (!stream || depth > MAX_INCLUDE_DEPTH)
+        {
+            std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << normalised << std::endl;
+            return false;
+        }
+        int source = static_cast<int>(files.size());
+        files.push_back(normalised);
+        if (depth > 0)
+            out += "#line 1 " + std::to_string(source) + "\n";
+
+        std::string line;
+        int number = 0;
+        bool ok = true;
+        bool versionFound = false;
+        while (std::getline(stream, line))
+        {
+            number++;
+            std::string::size_type start = line.find_first_not_of(" \t");
+            if (start != std::string::npos && line.compare(start, 8, "#include") == 0)
+            {
+                std::string::size_type open = line.find('"', start), close = line.rfind('"');
+                if (open == std::string::npos || close <= open)
+                {
+                    std::cout << "ERROR::SHADER::BAD_INCLUDE: " << normalised << ":" << number << std::endl;
+                    ok = false;
+                    continue;
+                }
+                ResourcePath included = path.parent_path() / line.substr(open + 1, close - open - 1);
+                std::size_t filesBefore = files.size();
+                ok &= expand(included, std::string(), files, out, depth + 1);
+                // nothing pasted (already included or unreadable): a blank line keeps the numbering
+                if (files.size() != filesBefore)
+                    out += "#line " + std::to_string(number + 1) + " " + std::to_string(source) + "\n";
+                else
+                    out += '\n';
+                continue;
+            }
+            out += line;
+            out += '\n';
+            // the first #version, possibly after comments or blank lines
+            if (!versionFound && start != std::string::npos && line.compare(start, 8, "#version") == 0)
+            {
+                versionFound = true;
+                if (!prelude.empty())
+                    out += prelude + "#line " + std::to_string(number + 1) + " " + std::to_string(source) + "\n";
+            }
+        }
+        if (!prelude.empty() && !versionFound)
+        {
+            std::cout << "ERROR::SHADER::NO_VERSION: " << normalised << " needs a #version line for its defines" << std::endl;
+            ok = false;
+        }
+        return ok;
+    }
+
+    uint64_t programKey(const Sources& sources) const
+    {
+        // FNV-1a, like the other caches
+        uint64_t hash = 14695981039346656037ull;
+        for (const std::string* text : { &sources.vertex, &sources.fragment, &driver })
+        {
+            for (unsigned char c : *text)
+                hash = (hash ^ c) * 1099511628211ull;
+            hash = (hash ^ 0xff) * 1099511628211ull; // separator
+        }
+        return hash;
+    }
+
+    std::string binaryPath(uint64_t key) const
+    {
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016llx.pbsh", static_cast<unsigned long long>(key));
+        return (ResourcePath(cacheDirectory) / name).generic_string();
+    }
+
+    // a program created from the cached binary, 0 if there is none or the driver rejects it
+    unsigned int loadBinary(uint64_t key)
+    {
+        std::string path = binaryPath(key);
+        FILE* file = std::fopen(path.c_str(), "rb");
+        if (file == NULL)
+            return 0;
+        ProgramBinaryHeader header;
+        std::vector<char> binary;
+        bool ok = std::fread(&header, sizeof(header), 1, file) == 1 && header.magic == ProgramBinaryHeader::MAGIC
+            && header.version == ProgramBinaryHeader::VERSION && header.key == key;
+        if (ok)
+        {
+            binary.resize(header.size);
+            ok = std::fread(binary.data(), 1, binary.size(), file) == binary.size();
+        }
+        std::fclose(file);
+
+        unsigned int program = 0;
+        if (ok)
+        {
+            program = glCreateProgram();
+            programBinary(program, header.format, binary.data(), static_cast<GLsizei>(binary.size()));
+            GLint linked = 0;
+            glGetProgramiv(program, GL_LINK_STATUS, &linked);
+            if (!linked)
+            {
+                // e.g. the driver was updated: rebuilt and stored again by the caller
+                glDeleteProgram(program);
+                program = 0;
+            }
+        }
+        if (program == 0)
+            std::remove(path.c_str());
+        return program;
+    }
+
+    void saveBinary(unsigned int program, uint64_t key)
+    {
+        GLint length = 0;
+        glGetProgramiv(program, PROGRAM_BINARY_LENGTH, &length);
+        if (length <= 0)
+            return;
+        std::vector<char> binary(static_cast<std::size_t>(length));
+        GLenum format = 0;
+        GLsizei written = 0;
+        getProgramBinary(program, length, &written, &format, binary.data());
+        if (written <= 0)
+            return;
+
+        ProgramBinaryHeader header;
+        header.format = format;
+        header.size = static_cast<uint32_t>(written);
+        header.key = key;
+        // written under a temporary name and renamed, so a crash never leaves a torn entry
+        std::string path = binaryPath(key);
+        std::string temporary = path + ".tmp";
+        FILE* file = std::fopen(temporary.c_str(), "wb");
+        if (file == NULL)
+            return;
+        bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1
+            && std::fwrite(binary.data(), 1, header.size, file) == header.size;
+        ok = std::fclose(file) == 0 && ok;
+        std::error_code error;
+        if (ok)
+            std::filesystem::rename(temporary, path, error);
+        if (!ok || error)
+            std::remove(temporary.c_str());
+    }
+
+    // compile both stages and link them into program; prints the logs on failure
+    static bool link(unsigned int program, const Sources& sources)
+    {
+        if (!sources.ok)
+            return false; // the preprocessor has printed why
+        unsigned int vertex = compile(GL_VERTEX_SHADER, sources.vertex, sources.vertexFiles);
+        unsigned int fragment = compile(GL_FRAGMENT_SHADER, sources.fragment, sources.fragmentFiles);
+        bool ok = vertex != 0 && fragment != 0;
+        if (ok)
+        {
+            glAttachShader(program, vertex);
+            glAttachShader(program, fragment);
+            glLinkProgram(program);
+            glDetachShader(program, vertex);
+            glDetachShader(program, fragment);
+            GLint linked = 0;
+            glGetProgramiv(program, GL_LINK_STATUS, &linked);
+            if (!linked)
+            {
+                GLchar infoLog[1024];
+                glGetProgramInfoLog(program, sizeof(infoLog), NULL, infoLog);
+                std::cout << "ERROR::PROGRAM_LINKING_ERROR of " << (sources.vertexFiles.empty() ? std::string() : sources.vertexFiles.front()) << "\n"
+                          << infoLog << "\n -- --------------------------------------------------- -- " << std::endl;
+                ok = false;
+            }
+        }
+        glDeleteShader(vertex);
+        glDeleteShader(fragment);
+        return ok;
+    }
+
+    static unsigned int compile(GLenum type, const std::string& source, const std::vector<std::string>& files)
+    {
+        unsigned int shader = glCreateShader(type);
+        const char* code = source.c_str();
+        glShaderSource(shader, 1, &code, NULL);
+        glCompileShader(shader);
+        GLint success = 0;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+        if (success)
+            return shader;
+
+        // messages refer to files by their #line source number
+        GLchar infoLog[1024];
+        glGetShaderInfoLog(shader, sizeof(infoLog), NULL, infoLog);
+        std::cout << "ERROR::SHADER_COMPILATION_ERROR of type: " << (type == GL_VERTEX_SHADER ? "VERTEX" : "FRAGMENT") << "\n";
+        for (std::size_t i = 0; i < files.size(); i++)
+            std::cout << "  source " << i << ": " << files[i] << "\n";
+        std::cout << infoLog << "\n -- --------------------------------------------------- -- " << std::endl;
+        glDeleteShader(shader);
+        return 0;
+    }
+};
+
+#endif
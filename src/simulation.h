@@ -0,0 +1,133 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include "blast_system.h"
+#include "tile_grid.h"
+
+#include <cstdint>
+#include <vector>
+
+// commands of one simulation tick, as a bit mask (one byte per tick in input logs)
+enum TickCommand : std::uint8_t
+{
+    COMMAND_REGENERATE = 1 << 0, // new breakable block layout, all bombs removed
+    COMMAND_DROP_BOMBS = 1 << 1, // drop a few bombs on random free cells
+    COMMAND_MASK = COMMAND_REGENERATE | COMMAND_DROP_BOMBS
+};
+
+struct SimulationConfig
+{
+    std::uint32_t seed = 1337;
+    int mapSize = 15;
+    float breakableProbability = 0.6f;
+};
+
+// The game state advanced in fixed ticks, independent of GL, windows and wall-clock time:
+// the map and the bombs on it. The state after any number of ticks depends only on the
+// config and the commands given to each tick, bit for bit. Randomness comes from the
+// simulation's own splitmix64 generator (standard library distributions differ between
+// implementations). The only floating point is TileGrid turning breakableProbability into
+// its 16-bit integer threshold on each layout (initial and COMMAND_REGENERATE): a single
+// IEEE multiply and truncation of the same config value, so every layout uses the same
+// threshold. stateHash() condenses the state for comparing runs.
+class Simulation
+{
+public:
+    static constexpr int TICKS_PER_SECOND = 60;
+
+    // what a bomb drop command does
+    static constexpr int DROPPED_BOMBS = 8;
+    static constexpr int BOMB_RANGE = 2;
+    static constexpr int BOMB_FUSE_TICKS = 2 * TICKS_PER_SECOND;
+
+    // what happened during the last tick, for the renderer and the profiler counters
+    struct TickEvents
+    {
+        bool regenerated = false;                         // the whole layout changed
+        int bombsDropped = 0;
+        const std::vector<BlastSystem::CellChange>* destroyed = nullptr; // blocks blown up
+    };
+
+    explicit Simulation(const SimulationConfig& config)
+        : simulationConfig(config), mapGrid(config.mapSize, config.mapSize), blastSystem(mapGrid),
+          random(config.seed)
+    {
+        mapGrid.generateBreakableBlocks(nextRandom(), simulationConfig.breakableProbability);
+    }
+
+    // advance by one tick with the given TickCommand mask
+    // ------------------------------------------------------------------------
+    const TickEvents& tick(std::uint8_t commands)
+    {
+        events = TickEvents();
+        if (commands & COMMAND_REGENERATE)
+        {
+            mapGrid.generateBreakableBlocks(nextRandom(), simulationConfig.breakableProbability);
+            blastSystem.clear();
+            events.regenerated = true;
+        }
+        if (commands & COMMAND_DROP_BOMBS)
+        {
+            for (int attempt = 0; attempt < DROPPED_BOMBS * 16 && events.bombsDropped < DROPPED_BOMBS; attempt++)
+            {
+                std::uint64_t draw = nextRandom();
+                int x = static_cast<int>((draw & 0xffffffffu) % static_cast<std::uint32_t>(mapGrid.width()));
+                int z = static_cast<int>((draw >> 32) % static_cast<std::uint32_t>(mapGrid.height()));
+                events.bombsDropped += blastSystem.placeBomb(x, z, BOMB_RANGE, BOMB_FUSE_TICKS);
+            }
+        }
+        events.destroyed = &blastSystem.tick().destroyed;
+        tickCount++;
+        return events;
+    }
+
+    // FNV-1a over everything that makes up the state: tick, generator, cells and bombs
+    std::uint64_t stateHash() const
+    {
+        std::uint64_t hash = 14695981039346656037ull;
+        auto mix = [&hash](std::uint64_t value, int bytes) {
+            for (int i = 0; i < bytes; i++)
+                hash = (hash ^ ((value >> (i * 8)) & 0xff)) * 1099511628211ull;
+        };
+        mix(tickCount, 8);
+        mix(random, 8);
+        for (int z = 0; z < mapGrid.height(); z++)
+        {
+            for (int x = 0; x < mapGrid.width(); x++)
+            {
+                mix(static_cast<std::uint8_t>(mapGrid.cell(x, z)), 1);
+                int bomb = blastSystem.bombAt(x, z);
+                if (bomb != BlastSystem::NO_BOMB)
+                {
+                    mix(static_cast<std::uint32_t>(blastSystem.range(bomb)), 2);
+                    mix(static_cast<std::uint32_t>(blastSystem.fuse(bomb)), 4);
+                }
+            }
+        }
+        return hash;
+    }
+
+    const SimulationConfig& config() const { return simulationConfig; }
+    std::uint64_t ticks() const { return tickCount; }
+    const TileGrid& grid() const { return mapGrid; }
+    const BlastSystem& blasts() const { return blastSystem; }
+
+private:
+    SimulationConfig simulationConfig;
+    TileGrid mapGrid;
+    BlastSystem blastSystem;
+    std::uint64_t random;
+    std::uint64_t tickCount = 0;
+    TickEvents events;
+
+    // splitmix64, the same generator TileGrid uses for the layout
+    std::uint64_t nextRandom()
+    {
+        std::uint64_t z = (random += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+};
+
+#endif
@@ -0,0 +1,304 @@
+#ifndef TEXTURE_CACHE_H
+#define TEXTURE_CACHE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Baked texture container (.btex), written by tools/texture_baker and read by TextureLoader.
+//
+//     TextureFileHeader
+//     TextureFileLevel[levelCount]      largest level first
+//     level data                        each level starts on a 16 byte boundary
+//
+// Every level is stored exactly as glTexImage2D / glCompressedTexImage2D consume it: tightly
+// packed rows (GL_UNPACK_ALIGNMENT 1), bottom row first when the texture was baked flipped.
+// The header records size and hash of the source PNG, so a baked file whose PNG changed
+// afterwards is detected as stale and the loader falls back to decoding the PNG.
+enum class TextureFileFormat : uint32_t
+{
+    R8 = 1,
+    RGB8,
+    RGBA8,
+    BC1 // DXT1, RGB without alpha
+};
+
+struct TextureFileHeader
+{
+    static constexpr uint32_t MAGIC = 0x58544250; // "PBTX"
+    static constexpr uint32_t VERSION = 1;
+    static constexpr uint32_t FLAG_FLIPPED = 1;
+
+    uint32_t magic = MAGIC;
+    uint32_t version = VERSION;
+    uint32_t format = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t levelCount = 0;
+    uint32_t flags = 0;
+    uint32_t reserved = 0;
+    uint64_t sourceSize = 0;
+    uint64_t sourceHash = 0;
+};
+
+struct TextureFileLevel
+{
+    uint64_t offset; // from the start of the file
+    uint64_t size;
+    uint32_t width;
+    uint32_t height;
+};
+
+static_assert(sizeof(TextureFileHeader) == 48, "TextureFileHeader layout is part of the file format");
+static_assert(sizeof(TextureFileLevel) == 24, "TextureFileLevel layout is part of the file format");
+
+// read-only memory mapping of a whole file
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile()
+    {
+        close();
+    }
+
+    bool open(const std::string& path)
+    {
+        close();
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file == INVALID_HANDLE_VALUE)
+            return false;
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+        {
+            close();
+            return false;
+        }
+        mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping == NULL)
+        {
+            close();
+            return false;
+        }
+        bytes = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        length = static_cast<std::size_t>(fileSize.QuadPart);
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size == 0)
+        {
+            ::close(fd);
+            return false;
+        }
+        void* address = mmap(NULL, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd); // the mapping keeps the file alive
+        if (address == MAP_FAILED)
+            return false;
+        bytes = static_cast<const unsigned char*>(address);
+        length = static_cast<std::size_t>(info.st_size);
+#endif
+        if (bytes == NULL)
+        {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close()
+    {
+#ifdef _WIN32
+        if (bytes != NULL)
+            UnmapViewOfFile(bytes);
+        if (mapping != NULL)
+            CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE)
+            CloseHandle(file);
+        mapping = NULL;
+        file = INVALID_HANDLE_VALUE;
+#else
+        if (bytes != NULL)
+            munmap(const_cast<unsigned char*>(bytes), length);
+#endif
+        bytes = NULL;
+        length = 0;
+    }
+
+    const unsigned char* data() const { return bytes; }
+    std::size_t size() const { return length; }
+
+private:
+    const unsigned char* bytes = NULL;
+    std::size_t length = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = NULL;
+#endif
+};
+
+namespace TextureCache
+{
+    // where the baked version of a PNG lives: next to it, with the extension replaced
+    inline std::string bakedPath(const std::string& sourcePath)
+    {
+        std::string::size_type dot = sourcePath.find_last_of('.');
+        std::string::size_type slash = sourcePath.find_last_of("/\\");
+        if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+            return sourcePath + ".btex";
+        return sourcePath.substr(0, dot) + ".btex";
+    }
+
+    // FNV-1a over the whole file; much cheaper than decoding the PNG it guards
+    inline bool hashFile(const std::string& path, uint64_t& size, uint64_t& hash)
+    {
+        FILE* file = std::fopen(path.c_str(), "rb");
+        if (file == NULL)
+            return false;
+        size = 0;
+        hash = 1469598103934665603ull;
+        unsigned char buffer[64 * 1024];
+        std::size_t count;
+        while ((count = std::fread(buffer, 1, sizeof(buffer), file)) > 0)
+        {
+            for (std::size_t i = 0; i < count; i++)
+                hash = (hash ^ buffer[i]) * 1099511628211ull;
+            size += count;
+        }
+        std::fclose(file);
+        return true;
+    }
+
+    // size in bytes of one mip level
+    inline uint64_t levelSize(TextureFileFormat format, uint32_t width, uint32_t height)
+    {
+        switch (format)
+        {
+        case TextureFileFormat::R8:
+            return uint64_t(width) * height;
+        case TextureFileFormat::RGB8:
+            return uint64_t(width) * height * 3;
+        case TextureFileFormat::RGBA8:
+            return uint64_t(width) * height * 4;
+        case TextureFileFormat::BC1:
+            return uint64_t((width + 3) / 4) * ((height + 3) / 4) * 8;
+        }
+        return 0;
+    }
+
+    // a mapped, validated baked texture
+    struct BakedTexture
+    {
+        MappedFile file;
+        const TextureFileHeader* header = NULL;
+        const TextureFileLevel* levels = NULL;
+
+        const unsigned char* levelData(uint32_t level) const
+        {
+            return file.data() + levels[level].offset;
+        }
+    };
+
+    // map a baked texture and check it against its source PNG; false if the baked file is
+    // missing, malformed, baked with a different flip setting or older than the PNG. A
+    // well-formed file has a known format and the full mip chain of its size, down to 1x1
+    inline bool openBaked(const std::string& sourcePath, bool flipVertically, BakedTexture& baked)
+    {
+        if (!baked.file.open(bakedPath(sourcePath)))
+            return false;
+        const unsigned char* data = baked.file.data();
+        std::size_t size = baked.file.size();
+        if (size < sizeof(TextureFileHeader))
+            return false;
+
+        const TextureFileHeader* header = reinterpret_cast<const TextureFileHeader*>(data);
+        if (header->magic != TextureFileHeader::MAGIC || header->version != TextureFileHeader::VERSION
+            || header->format < static_cast<uint32_t>(TextureFileFormat::R8)
+            || header->format > static_cast<uint32_t>(TextureFileFormat::BC1)
+            || header->width == 0 || header->height == 0
+            || header->levelCount == 0 || header->levelCount > 32
+            || sizeof(TextureFileHeader) + header->levelCount * sizeof(TextureFileLevel) > size)
+            return false;
+        if (((header->flags & TextureFileHeader::FLAG_FLIPPED) != 0) != flipVertically)
+            return false;
+
+        const TextureFileLevel* levels = reinterpret_cast<const TextureFileLevel*>(data + sizeof(TextureFileHeader));
+        for (uint32_t level = 0; level < header->levelCount; level++)
+        {
+            uint32_t width = std::max<uint32_t>(1, header->width >> level);
+            uint32_t height = std::max<uint32_t>(1, header->height >> level);
+            if (levels[level].width != width || levels[level].height != height
+                || levels[level].offset > size || levels[level].size > size - levels[level].offset
+                || levels[level].size != levelSize(static_cast<TextureFileFormat>(header->format), width, height))
+                return false;
+        }
+        const TextureFileLevel& last = levels[header->levelCount - 1];
+        if (last.width != 1 || last.height != 1)
+            return false;
+
+        uint64_t sourceSize, sourceHash;
+        if (!hashFile(sourcePath, sourceSize, sourceHash) || sourceSize != header->sourceSize || sourceHash != header->sourceHash)
+            return false;
+
+        baked.header = header;
+        baked.levels = levels;
+        return true;
+    }
+
+    // write a container; levels[i] points at level i's bytes, sizes are derived from the header
+    inline bool writeBaked(const std::string& path, const TextureFileHeader& header, const std::vector<const unsigned char*>& levels)
+    {
+        std::vector<TextureFileLevel> table(header.levelCount);
+        uint64_t offset = sizeof(TextureFileHeader) + header.levelCount * sizeof(TextureFileLevel);
+        uint32_t width = header.width, height = header.height;
+        for (uint32_t level = 0; level < header.levelCount; level++)
+        {
+            offset = (offset + 15) & ~uint64_t(15);
+            table[level].offset = offset;
+            table[level].size = levelSize(static_cast<TextureFileFormat>(header.format), width, height);
+            table[level].width = width;
+            table[level].height = height;
+            offset += table[level].size;
+            width = width > 1 ? width / 2 : 1;
+            height = height > 1 ? height / 2 : 1;
+        }
+
+        FILE* file = std::fopen(path.c_str(), "wb");
+        if (file == NULL)
+            return false;
+        bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1
+            && std::fwrite(table.data(), sizeof(TextureFileLevel), table.size(), file) == table.size();
+        const unsigned char padding[16] = {};
+        uint64_t position = sizeof(TextureFileHeader) + header.levelCount * sizeof(TextureFileLevel);
+        for (uint32_t level = 0; ok && level < header.levelCount; level++)
+        {
+            ok = std::fwrite(padding, 1, table[level].offset - position, file) == table[level].offset - position
+                && std::fwrite(levels[level], 1, table[level].size, file) == table[level].size;
+            position = table[level].offset + table[level].size;
+        }
+        ok = std::fclose(file) == 0 && ok;
+        return ok;
+    }
+}
+
+#endif
@@ -0,0 +1,485 @@
+#ifndef TEXTURE_LOADER_H
+#define TEXTURE_LOADER_H
+
+#include <glad/glad.h>
+#include <stb_image.h>
+
+#include "profiler.h"
+#include "texture_cache.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Loads textures without blocking the render thread on image decoding.
+//
+// load2D()/loadCubemap() return a GL texture name right away. The texture holds a 1x1
+// placeholder until a worker thread has decoded the image with stb_image and update(),
+// called once per frame on the GL thread, has streamed the pixels in through a pixel
+// buffer object. update() stops uploading once its time budget for the frame is spent.
+// Cubemap faces are decoded in parallel but uploaded together, so a cubemap is never
+// sampled while only some of its faces have their final size; if any face fails to decode
+// or the faces differ in size, the whole cubemap keeps its placeholder.
+//
+// A texture that has an up-to-date baked container next to its PNG (tools/texture_baker,
+// see texture_cache.h) skips all of that: the container is memory-mapped and its mip chain
+// uploaded straight from the mapping inside the load call.
+//
+// With workerCount 0 every image is decoded and uploaded inside the load call on the
+// calling thread, which reproduces the old serial stbi_load behaviour for comparisons.
+class TextureLoader
+{
+public:
+    // workerCount < 0 picks one thread per spare hardware thread
+    explicit TextureLoader(int workerCount = -1)
+    {
+        if (workerCount < 0)
+            workerCount = static_cast<int>(std::max(2u, std::thread::hardware_concurrency()) - 1);
+        for (int i = 0; i < workerCount; i++)
+            workers.emplace_back(&TextureLoader::workerLoop, this);
+    }
+
+    TextureLoader(const TextureLoader&) = delete;
+    TextureLoader& operator=(const TextureLoader&) = delete;
+
+    ~TextureLoader()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        jobAvailable.notify_all();
+        for (std::thread& worker : workers)
+            worker.join();
+        for (Decoded& decoded : ready)
+            stbi_image_free(decoded.image.pixels);
+        for (Request& request : requests)
+            for (Image& face : request.faces)
+                stbi_image_free(face.pixels);
+    }
+
+    // de-allocate the pixel buffers; must be called while the context is still current.
+    // The textures themselves belong to the caller.
+    void release()
+    {
+        if (uploadBuffers[0] != 0)
+            glDeleteBuffers(UPLOAD_BUFFER_COUNT, uploadBuffers);
+        std::fill(uploadBuffers, uploadBuffers + UPLOAD_BUFFER_COUNT, 0u);
+    }
+
+    unsigned int workerCount() const
+    {
+        return static_cast<unsigned int>(workers.size());
+    }
+
+    // whether .btex containers are used when they are up to date (default true)
+    void setUseBaked(bool enabled)
+    {
+        useBaked = enabled;
+    }
+
+    // number of textures that were uploaded from baked containers
+    unsigned int bakedCount() const
+    {
+        return bakedTextures;
+    }
+
+    // 2D texture with mipmaps and repeat wrapping, as the old loadTexture() created
+    // ------------------------------------------------------------------------
+    unsigned int load2D(const std::string& path, bool flipVertically = true)
+    {
+        PROFILE_ZONE("TextureLoader::load2D");
+        unsigned int textureID;
+        glGenTextures(1, &textureID);
+        glBindTexture(GL_TEXTURE_2D, textureID);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        if (uploadBaked(GL_TEXTURE_2D, { path }, flipVertically))
+            return textureID;
+
+        const unsigned char placeholder[4] = { 128, 128, 128, 255 };
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, placeholder);
+        glGenerateMipmap(GL_TEXTURE_2D);
+
+        submit(textureID, false, { path }, flipVertically);
+        return textureID;
+    }
+
+    // cubemap from six faces in +X, -X, +Y, -Y, +Z, -Z order (never flipped)
+    // ------------------------------------------------------------------------
+    unsigned int loadCubemap(const std::vector<std::string>& faces)
+    {
+        PROFILE_ZONE("TextureLoader::loadCubemap");
+        unsigned int textureID;
+        glGenTextures(1, &textureID);
+        glBindTexture(GL_TEXTURE_CUBE_MAP, textureID);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+        if (uploadBaked(GL_TEXTURE_CUBE_MAP, faces, false))
+            return textureID;
+
+        const unsigned char placeholder[4] = { 26, 26, 38, 255 }; // matches the clear colour
+        for (unsigned int i = 0; i < 6; i++)
+            glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, placeholder);
+
+        submit(textureID, true, faces, false);
+        return textureID;
+    }
+
+    // upload decoded images until budgetMs is spent (at least one texture per call when
+    // something is ready); returns the number of textures that were completed
+    // ------------------------------------------------------------------------
+    unsigned int update(double budgetMs = 2.0)
+    {
+        PROFILE_ZONE("TextureLoader::update");
+        auto start = std::chrono::steady_clock::now();
+        unsigned int completed = 0;
+        while (true)
+        {
+            Decoded decoded;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (ready.empty())
+                    break;
+                decoded = ready.front();
+                ready.pop_front();
+            }
+            if (accept(decoded))
+                completed++;
+
+            double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            if (completed > 0 && elapsedMs >= budgetMs)
+                break;
+        }
+        return completed;
+    }
+
+    // block until every requested texture has been uploaded
+    // ------------------------------------------------------------------------
+    void finish()
+    {
+        while (pending() > 0)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                imageReady.wait(lock, [this]() { return !ready.empty(); });
+            }
+            update(1.0e9);
+        }
+    }
+
+    // number of textures that still show their placeholder
+    std::size_t pending() const
+    {
+        return outstanding;
+    }
+
+    // drop the upload of a texture that is about to be deleted, so its decoded pixels are
+    // not written into a name GL may have handed out again by then
+    void cancel(unsigned int texture)
+    {
+        for (Request& request : requests)
+        {
+            if (request.texture == texture)
+                request.texture = 0;
+        }
+    }
+
+private:
+    static constexpr unsigned int UPLOAD_BUFFER_COUNT = 2;
+
+    struct Image
+    {
+        int width = 0;
+        int height = 0;
+        int channels = 0;
+        unsigned char* pixels = nullptr;
+    };
+
+    struct Job
+    {
+        std::size_t request;
+        unsigned int face;
+        std::string path;
+        bool flip;
+    };
+
+    struct Decoded
+    {
+        std::size_t request = 0;
+        unsigned int face = 0;
+        std::string path;
+        Image image;
+    };
+
+    // owned by the GL thread only
+    struct Request
+    {
+        unsigned int texture = 0;
+        bool cubemap = false;
+        unsigned int facesDecoded = 0;
+        std::vector<Image> faces;
+    };
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable jobAvailable;
+    std::condition_variable imageReady;
+    std::deque<Job> jobs;      // guarded by mutex
+    std::deque<Decoded> ready; // guarded by mutex
+    bool stopping = false;     // guarded by mutex
+
+    std::vector<Request> requests;       // slots, reused once their texture is complete
+    std::vector<std::size_t> freeRequests;
+    std::size_t outstanding = 0;
+    bool useBaked = true;
+    unsigned int bakedTextures = 0;
+    int s3tcSupported = -1; // unknown until the first BC1 texture
+    unsigned int uploadBuffers[UPLOAD_BUFFER_COUNT] = {};
+    unsigned int nextUploadBuffer = 0;
+
+    // upload every face of the bound texture from its baked container; false (nothing uploaded)
+    // if any face has no usable container, so the caller can take the PNG path instead
+    bool uploadBaked(GLenum target, const std::vector<std::string>& paths, bool flip)
+    {
+        if (!useBaked)
+            return false;
+        std::vector<TextureCache::BakedTexture> baked(paths.size());
+        for (std::size_t face = 0; face < paths.size(); face++)
+        {
+            if (!TextureCache::openBaked(paths[face], flip, baked[face]))
+                return false;
+            if (baked[face].header->format == static_cast<uint32_t>(TextureFileFormat::BC1) && !supportsS3TC())
+                return false;
+            // cubemap faces must be square and all of one size, or the cubemap is incomplete
+            const TextureFileHeader& header = *baked[face].header;
+            if (target == GL_TEXTURE_CUBE_MAP && (header.width != header.height || header.width != baked[0].header->width))
+                return false;
+        }
+
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        for (std::size_t face = 0; face < baked.size(); face++)
+        {
+            const TextureFileHeader& header = *baked[face].header;
+            GLenum faceTarget = target == GL_TEXTURE_CUBE_MAP ? GL_TEXTURE_CUBE_MAP_POSITIVE_X + static_cast<GLenum>(face) : target;
+            for (uint32_t level = 0; level < header.levelCount; level++)
+            {
+                const TextureFileLevel& info = baked[face].levels[level];
+                const unsigned char* data = baked[face].levelData(level);
+                switch (static_cast<TextureFileFormat>(header.format))
+                {
+                case TextureFileFormat::BC1:
+                    glCompressedTexImage2D(faceTarget, level, COMPRESSED_RGB_S3TC_DXT1, info.width, info.height, 0, static_cast<GLsizei>(info.size), data);
+                    break;
+                case TextureFileFormat::R8:
+                    glTexImage2D(faceTarget, level, GL_RED, info.width, info.height, 0, GL_RED, GL_UNSIGNED_BYTE, data);
+                    break;
+                case TextureFileFormat::RGB8:
+                    glTexImage2D(faceTarget, level, GL_RGB, info.width, info.height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
+                    break;
+                case TextureFileFormat::RGBA8:
+                    glTexImage2D(faceTarget, level, GL_RGBA, info.width, info.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+                    break;
+                }
+                PROFILE_COUNT("bytes uploaded", info.size);
+            }
+            if (target != GL_TEXTURE_CUBE_MAP)
+                glTexParameteri(target, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(header.levelCount - 1));
+        }
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        bakedTextures++;
+        return true;
+    }
+
+    // GL_EXT_texture_compression_s3tc is not part of core GL 3.3, but every desktop driver has it
+    static constexpr GLenum COMPRESSED_RGB_S3TC_DXT1 = 0x83F0;
+
+    bool supportsS3TC()
+    {
+        if (s3tcSupported < 0)
+        {
+            s3tcSupported = 0;
+            GLint count = 0;
+            glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+            for (GLint i = 0; i < count; i++)
+            {
+                const char* name = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+                if (name != NULL && std::strcmp(name, "GL_EXT_texture_compression_s3tc") == 0)
+                    s3tcSupported = 1;
+            }
+        }
+        return s3tcSupported == 1;
+    }
+
+    void submit(unsigned int texture, bool cubemap, const std::vector<std::string>& paths, bool flip)
+    {
+        std::size_t requestIndex = requests.size();
+        if (freeRequests.empty())
+        {
+            requests.emplace_back();
+        }
+        else
+        {
+            requestIndex = freeRequests.back();
+            freeRequests.pop_back();
+        }
+        Request& request = requests[requestIndex];
+        request.texture = texture;
+        request.cubemap = cubemap;
+        request.faces.assign(paths.size(), Image());
+        outstanding++;
+
+        if (workers.empty())
+        {
+            // serial mode: decode right here with the global flip flag, as the old loaders did
+            stbi_set_flip_vertically_on_load(flip);
+            for (unsigned int face = 0; face < paths.size(); face++)
+                accept({ requestIndex, face, paths[face], decode(paths[face]) });
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (unsigned int face = 0; face < paths.size(); face++)
+                jobs.push_back({ requestIndex, face, paths[face], flip });
+        }
+        jobAvailable.notify_all();
+    }
+
+    static Image decode(const std::string& path)
+    {
+        PROFILE_ZONE("decode texture");
+        Image image;
+        image.pixels = stbi_load(path.c_str(), &image.width, &image.height, &image.channels, 0);
+        return image;
+    }
+
+    void workerLoop()
+    {
+        PROFILE_THREAD("texture decode");
+        while (true)
+        {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                jobAvailable.wait(lock, [this]() { return stopping || !jobs.empty(); });
+                if (stopping)
+                    return;
+                job = jobs.front();
+                jobs.pop_front();
+            }
+
+            // per-thread flag, so workers never race on stb_image's global flip setting
+            stbi_set_flip_vertically_on_load_thread(job.flip);
+            Image image = decode(job.path);
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                ready.push_back({ job.request, job.face, job.path, image });
+            }
+            imageReady.notify_one();
+        }
+    }
+
+    // store a decoded face; uploads the texture once all of its faces are present.
+    // returns true if the texture was completed
+    bool accept(const Decoded& decoded)
+    {
+        Request& request = requests[decoded.request];
+        request.faces[decoded.face] = decoded.image;
+        if (decoded.image.pixels == NULL)
+            std::cout << (request.cubemap ? "Cubemap texture" : "Texture") << " failed to load at path: " << decoded.path << std::endl;
+        if (++request.facesDecoded < request.faces.size())
+            return false;
+
+        if (request.texture != 0)
+            upload(request);
+        for (Image& face : request.faces)
+            stbi_image_free(face.pixels);
+        request = Request();
+        freeRequests.push_back(decoded.request);
+        outstanding--;
+        return true;
+    }
+
+    void upload(const Request& request)
+    {
+        PROFILE_ZONE("TextureLoader::upload");
+        if (request.cubemap)
+        {
+            // a cubemap with missing or differently sized faces is incomplete and samples as
+            // black, so it stays at the placeholder unless all faces can replace it
+            for (const Image& image : request.faces)
+            {
+                if (image.pixels == NULL)
+                    return; // already reported by accept()
+                if (image.width != request.faces[0].width || image.height != request.faces[0].height)
+                {
+                    std::cout << "Cubemap faces differ in size, keeping the placeholder" << std::endl;
+                    return;
+                }
+            }
+        }
+        if (uploadBuffers[0] == 0)
+            glGenBuffers(UPLOAD_BUFFER_COUNT, uploadBuffers);
+
+        GLenum target = request.cubemap ? GL_TEXTURE_CUBE_MAP : GL_TEXTURE_2D;
+        glBindTexture(target, request.texture);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // tightly packed rows, also for odd-width RGB images
+        for (unsigned int face = 0; face < request.faces.size(); face++)
+        {
+            const Image& image = request.faces[face];
+            if (image.pixels == NULL)
+                continue; // keep the placeholder (2D textures only, see above)
+            GLenum format;
+            if (image.channels == 1)
+                format = GL_RED;
+            else if (image.channels == 3)
+                format = GL_RGB;
+            else
+                format = GL_RGBA;
+
+            // copy into a freshly orphaned PBO and let the driver source the texture from it
+            // asynchronously; alternating buffers avoids waiting on the previous transfer
+            std::size_t size = static_cast<std::size_t>(image.width) * image.height * image.channels;
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, uploadBuffers[nextUploadBuffer]);
+            nextUploadBuffer = (nextUploadBuffer + 1) % UPLOAD_BUFFER_COUNT;
+            glBufferData(GL_PIXEL_UNPACK_BUFFER, size, NULL, GL_STREAM_DRAW);
+            const void* source = (void*)0; // offset into the bound PBO
+            void* mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+            if (mapped != NULL)
+            {
+                std::memcpy(mapped, image.pixels, size);
+                glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+            }
+            else
+            {
+                // mapping failed: fall back to a plain client memory upload
+                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+                source = image.pixels;
+            }
+            GLenum imageTarget = request.cubemap ? GL_TEXTURE_CUBE_MAP_POSITIVE_X + face : GL_TEXTURE_2D;
+            glTexImage2D(imageTarget, 0, format, image.width, image.height, 0, format, GL_UNSIGNED_BYTE, source);
+            PROFILE_COUNT("bytes uploaded", size);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        }
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        if (!request.cubemap && request.faces[0].pixels != NULL)
+            glGenerateMipmap(GL_TEXTURE_2D);
+        glBindTexture(target, 0);
+    }
+};
+
+#endif
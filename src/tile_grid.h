@@ -0,0 +1,363 @@
+#ifndef TILE_GRID_H
+#define TILE_GRID_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// what occupies a cell of the map
+enum class CellType : std::uint8_t
+{
+    Floor = 0,  // walkable (white/green cells)
+    Border,     // raised unbreakable block around the map
+    RedBlock,   // unbreakable pattern block
+    Breakable   // randomly placed, destructible block
+};
+
+// Map state of the arena: one byte per cell for the cell type plus bitset layers
+// (solid, breakable, spawn) stored row by row, so occupancy and neighbour queries are
+// O(1) bit tests and whole-map operations work on 64 cells at a time.
+class TileGrid
+{
+public:
+    enum Layer
+    {
+        SOLID = 0,  // blocks movement and blasts (border, red and breakable blocks)
+        BREAKABLE,  // destructible blocks
+        SPAWN,      // player spawn cells, always kept free
+        LAYER_COUNT
+    };
+
+    // neighbour directions, also used as bit positions of neighbourMask()
+    enum Direction
+    {
+        NORTH = 0, // -z
+        SOUTH,     // +z
+        WEST,      // -x
+        EAST       // +x
+    };
+
+    static constexpr int DX[4] = { 0, 0, -1, 1 };
+    static constexpr int DZ[4] = { -1, 1, 0, 0 };
+
+    // builds the arena layout for the given size: border ring, red blocks on every
+    // even interior cell and 2x2 spawn clusters in the top-left and bottom-right corners
+    TileGrid(int width = 15, int height = 15)
+        : gridWidth(width), gridHeight(height), wordsPerRow((width + 63) / 64)
+    {
+        cells.assign(static_cast<std::size_t>(width) * height, CellType::Floor);
+        for (int layer = 0; layer < LAYER_COUNT; layer++)
+            layers[layer].assign(static_cast<std::size_t>(wordsPerRow) * height, 0);
+
+        for (int z = 0; z < height; z++)
+        {
+            for (int x = 0; x < width; x++)
+            {
+                if (x == 0 || x == width - 1 || z == 0 || z == height - 1)
+                    setCell(x, z, CellType::Border);
+                else if (x % 2 == 0 && z % 2 == 0 && x <= width - 3 && z <= height - 3)
+                    setCell(x, z, CellType::RedBlock);
+            }
+        }
+
+        const int spawnCorners[2][2] = { { 1, 1 }, { width - 3, height - 3 } };
+        for (const auto& corner : spawnCorners)
+        {
+            for (int dz = 0; dz < 2; dz++)
+                for (int dx = 0; dx < 2; dx++)
+                    if (inBounds(corner[0] + dx, corner[1] + dz) && !isSolid(corner[0] + dx, corner[1] + dz))
+                        setBit(SPAWN, corner[0] + dx, corner[1] + dz, true);
+        }
+    }
+
+    int width() const { return gridWidth; }
+    int height() const { return gridHeight; }
+
+    bool inBounds(int x, int z) const
+    {
+        return static_cast<unsigned int>(x) < static_cast<unsigned int>(gridWidth)
+            && static_cast<unsigned int>(z) < static_cast<unsigned int>(gridHeight);
+    }
+
+    int index(int x, int z) const { return z * gridWidth + x; }
+
+    // cell queries (coordinates must be in bounds)
+    // ------------------------------------------------------------------------
+    CellType cell(int x, int z) const { return cells[index(x, z)]; }
+    bool test(Layer layer, int x, int z) const
+    {
+        return (layers[layer][wordIndex(x, z)] >> (x & 63)) & 1u;
+    }
+    bool isSolid(int x, int z) const { return test(SOLID, x, z); }
+    bool isBreakable(int x, int z) const { return test(BREAKABLE, x, z); }
+    bool isSpawn(int x, int z) const { return test(SPAWN, x, z); }
+    bool isBorder(int x, int z) const { return cell(x, z) == CellType::Border; }
+    bool isRedBlock(int x, int z) const { return cell(x, z) == CellType::RedBlock; }
+    // a white cell is floor that may hold a breakable block (not border, red or spawn)
+    bool isWhiteCell(int x, int z) const
+    {
+        return cell(x, z) != CellType::Border && cell(x, z) != CellType::RedBlock && !isSpawn(x, z);
+    }
+
+    // bit i (see Direction) is set when the neighbour in that direction is in bounds and not solid
+    unsigned int neighbourMask(int x, int z) const
+    {
+        unsigned int mask = 0;
+        for (int dir = 0; dir < 4; dir++)
+        {
+            int nx = x + DX[dir];
+            int nz = z + DZ[dir];
+            mask |= static_cast<unsigned int>(inBounds(nx, nz) && !isSolid(nx, nz)) << dir;
+        }
+        return mask;
+    }
+
+    // change a single cell, keeping the bitset layers in sync
+    // ------------------------------------------------------------------------
+    void setCell(int x, int z, CellType type)
+    {
+        cells[index(x, z)] = type;
+        setBit(SOLID, x, z, type != CellType::Floor);
+        setBit(BREAKABLE, x, z, type == CellType::Breakable);
+    }
+
+    // turns a breakable block into floor; returns false if there was none
+    bool destroyBlock(int x, int z)
+    {
+        if (!inBounds(x, z) || !isBreakable(x, z))
+            return false;
+        setCell(x, z, CellType::Floor);
+        return true;
+    }
+
+    // Replaces all breakable blocks with a new random layout. Each white cell receives a
+    // block with the given probability; the result only depends on the seed. Works a row
+    // word (64 cells) at a time: candidates and the random draws are combined with bit
+    // operations, only the cells that actually receive a block are touched individually.
+    // ------------------------------------------------------------------------
+    void generateBreakableBlocks(std::uint64_t seed, float probability = 0.6f)
+    {
+        const std::uint32_t threshold = static_cast<std::uint32_t>(probability * 65536.0f);
+        std::uint64_t state = seed;
+
+        std::vector<std::uint64_t>& solid = layers[SOLID];
+        std::vector<std::uint64_t>& breakable = layers[BREAKABLE];
+        const std::vector<std::uint64_t>& spawn = layers[SPAWN];
+
+        for (int z = 0; z < gridHeight; z++)
+        {
+            for (int w = 0; w < wordsPerRow; w++)
+            {
+                std::size_t word = static_cast<std::size_t>(z) * wordsPerRow + w;
+
+                // clear the previous layout of this word
+                std::uint64_t cleared = breakable[word];
+                solid[word] &= ~cleared;
+                forEachBit(cleared, w, [&](int x) { cells[index(x, z)] = CellType::Floor; });
+
+                std::uint64_t candidates = ~(solid[word] | spawn[word]) & rowMask(w);
+
+                // one 16-bit draw per cell, four cells per random number
+                std::uint64_t placed = 0;
+                int cellsInWord = gridWidth - w * 64 < 64 ? gridWidth - w * 64 : 64;
+                for (int bit = 0; bit < cellsInWord; bit += 4)
+                {
+                    std::uint64_t random = nextRandom(state);
+                    for (int lane = 0; lane < 4; lane++)
+                    {
+                        std::uint64_t draw = (random >> (lane * 16)) & 0xFFFFu;
+                        placed |= static_cast<std::uint64_t>(draw < threshold) << (bit + lane);
+                    }
+                }
+                placed &= candidates;
+
+                breakable[word] = placed;
+                solid[word] |= placed;
+                forEachBit(placed, w, [&](int x) { cells[index(x, z)] = CellType::Breakable; });
+            }
+        }
+    }
+
+    // An arena is valid when no spawn cell is blocked and every non-fixed cell (floor or
+    // breakable) can be reached from the first spawn once breakable blocks are cleared,
+    // i.e. no part of the map is walled off by border and red blocks.
+    // ------------------------------------------------------------------------
+    bool validate() const
+    {
+        const std::vector<std::uint64_t>& solid = layers[SOLID];
+        const std::vector<std::uint64_t>& breakable = layers[BREAKABLE];
+        const std::vector<std::uint64_t>& spawn = layers[SPAWN];
+
+        std::vector<std::uint64_t> open(solid.size());
+        bool hasSpawn = false;
+        for (std::size_t i = 0; i < solid.size(); i++)
+        {
+            if (spawn[i] & solid[i])
+                return false;
+            hasSpawn |= spawn[i] != 0;
+            open[i] = ~(solid[i] & ~breakable[i]);
+        }
+        if (!hasSpawn)
+            return false;
+
+        // seed the flood fill with the first spawn cell
+        std::vector<std::uint64_t> reached(solid.size(), 0);
+        for (std::size_t i = 0; i < spawn.size(); i++)
+        {
+            if (spawn[i])
+            {
+                reached[i] = spawn[i] & (~spawn[i] + 1); // lowest set bit
+                break;
+            }
+        }
+
+        // bit-parallel flood fill, a whole row at a time; alternate downward and upward sweeps until stable
+        bool changed = true;
+        while (changed)
+        {
+            changed = false;
+            for (int z = 0; z < gridHeight; z++)
+                changed |= growRow(reached, open, z);
+            for (int z = gridHeight - 1; z >= 0; z--)
+                changed |= growRow(reached, open, z);
+        }
+
+        for (std::size_t i = 0; i < open.size(); i++)
+        {
+            if ((open[i] & rowMask(static_cast<int>(i % wordsPerRow))) != reached[i])
+                return false;
+        }
+        return true;
+    }
+
+    // number of breakable blocks currently on the map
+    std::size_t breakableCount() const
+    {
+        std::size_t count = 0;
+        for (std::uint64_t word : layers[BREAKABLE])
+            count += popcount(word);
+        return count;
+    }
+
+    // (x, z) of every breakable block in row-major order
+    std::vector<std::pair<int, int>> breakablePositions() const
+    {
+        std::vector<std::pair<int, int>> positions;
+        positions.reserve(breakableCount());
+        for (int z = 0; z < gridHeight; z++)
+            for (int w = 0; w < wordsPerRow; w++)
+                forEachBit(layers[BREAKABLE][static_cast<std::size_t>(z) * wordsPerRow + w], w,
+                    [&](int x) { positions.push_back({ x, z }); });
+        return positions;
+    }
+
+    const std::vector<std::uint64_t>& layer(Layer layer) const { return layers[layer]; }
+    int rowWords() const { return wordsPerRow; }
+
+private:
+    int gridWidth;
+    int gridHeight;
+    int wordsPerRow;
+    std::vector<CellType> cells;
+    std::vector<std::uint64_t> layers[LAYER_COUNT];
+
+    std::size_t wordIndex(int x, int z) const
+    {
+        return static_cast<std::size_t>(z) * wordsPerRow + (x >> 6);
+    }
+
+    // grows the reached cells of row z from its own cells and the rows above and below; returns true if it changed
+    bool growRow(std::vector<std::uint64_t>& reached, const std::vector<std::uint64_t>& open, int z) const
+    {
+        bool rowChanged = false;
+        bool changed = true;
+        while (changed)
+        {
+            changed = false;
+            for (int w = 0; w < wordsPerRow; w++)
+            {
+                std::size_t word = static_cast<std::size_t>(z) * wordsPerRow + w;
+                std::uint64_t bits = reached[word];
+                std::uint64_t grown = bits | (bits << 1) | (bits >> 1);
+                if (w > 0)
+                    grown |= reached[word - 1] >> 63;
+                if (w + 1 < wordsPerRow)
+                    grown |= reached[word + 1] << 63;
+                if (z > 0)
+                    grown |= reached[word - wordsPerRow];
+                if (z + 1 < gridHeight)
+                    grown |= reached[word + wordsPerRow];
+                grown &= open[word] & rowMask(w);
+                if (grown != bits)
+                {
+                    reached[word] = grown;
+                    changed = rowChanged = true;
+                }
+            }
+        }
+        return rowChanged;
+    }
+
+    void setBit(Layer layer, int x, int z, bool value)
+    {
+        std::uint64_t bit = std::uint64_t(1) << (x & 63);
+        std::uint64_t& word = layers[layer][wordIndex(x, z)];
+        word = value ? (word | bit) : (word & ~bit);
+    }
+
+    // valid cell bits of the w-th word of a row
+    std::uint64_t rowMask(int w) const
+    {
+        int bits = gridWidth - w * 64;
+        return bits >= 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << bits) - 1;
+    }
+
+    template <typename Fn>
+    static void forEachBit(std::uint64_t bits, int w, Fn fn)
+    {
+        while (bits)
+        {
+            fn(w * 64 + countTrailingZeros(bits));
+            bits &= bits - 1;
+        }
+    }
+
+    static int countTrailingZeros(std::uint64_t value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctzll(value);
+#else
+        int count = 0;
+        while (!(value & 1))
+        {
+            value >>= 1;
+            count++;
+        }
+        return count;
+#endif
+    }
+
+    static int popcount(std::uint64_t value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_popcountll(value);
+#else
+        int count = 0;
+        for (; value; value &= value - 1)
+            count++;
+        return count;
+#endif
+    }
+
+    // splitmix64: tiny, fast and identical on every platform (unlike std distributions)
+    static std::uint64_t nextRandom(std::uint64_t& state)
+    {
+        std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+};
+
+#endif
@@ -0,0 +1,161 @@
+#ifndef VERTEX_FORMATS_H
+#define VERTEX_FORMATS_H
+
+#include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// GPU vertex layouts for Mesh (see learnopengl/mesh.h).
+//
+// Full is LearnOpenGL's 88 byte Vertex: float normal, tangent and bitangent, int bone ids
+// and float weights, whether the mesh is skinned or not. The compact layouts store
+//     position     3 x float                    12 bytes
+//     normal       octahedral, 2 x snorm16       4 bytes
+//     tangent      octahedral, 2 x snorm8, bitangent sign as snorm8, 1 byte pad   4 bytes
+//     texCoords    2 x half float                4 bytes
+// and, for skinned meshes only,
+//     boneIds      4 x uint8                     4 bytes
+//     weights      4 x unorm8, summing to 255    4 bytes
+// shaders/model.vs (default and SKINNED variants) decodes them.
+enum class VertexFormat
+{
+    Full,
+    CompactStatic,
+    CompactSkinned
+};
+
+struct CompactStaticVertex
+{
+    glm::vec3 position;
+    int16_t normal[2];
+    int8_t tangent[4];
+    uint16_t texCoords[2];
+};
+
+struct CompactSkinnedVertex
+{
+    glm::vec3 position;
+    int16_t normal[2];
+    int8_t tangent[4];
+    uint16_t texCoords[2];
+    uint8_t boneIds[4];
+    uint8_t weights[4];
+};
+
+static_assert(sizeof(CompactStaticVertex) == 24, "CompactStaticVertex must match the attribute setup in mesh.h");
+static_assert(sizeof(CompactSkinnedVertex) == 32, "CompactSkinnedVertex must match the attribute setup in mesh.h");
+
+// GL objects of one uploaded mesh, as Mesh creates them and ResourceManager shares them. VAO
+// may be 0 for geometry whose users build their own vertex arrays around the buffers.
+struct GpuMesh
+{
+    unsigned int VAO = 0;
+    unsigned int VBO = 0;
+    unsigned int EBO = 0;
+    std::size_t vertexCount = 0;
+    std::size_t indexCount = 0;
+    std::size_t vertexBufferSize = 0; // bytes
+    std::size_t indexBufferSize = 0;  // bytes
+    VertexFormat format = VertexFormat::Full;
+};
+
+namespace VertexPacking
+{
+    // largest bone index a compact skinned vertex can reference
+    constexpr int MAX_COMPACT_BONE_ID = 255;
+
+    // unit vector to the [-1, 1]^2 octahedral square
+    inline glm::vec2 octEncode(glm::vec3 n)
+    {
+        n /= std::fabs(n.x) + std::fabs(n.y) + std::fabs(n.z);
+        glm::vec2 e(n.x, n.y);
+        if (n.z < 0.0f)
+        {
+            e = glm::vec2((1.0f - std::fabs(n.y)) * (n.x >= 0.0f ? 1.0f : -1.0f),
+                (1.0f - std::fabs(n.x)) * (n.y >= 0.0f ? 1.0f : -1.0f));
+        }
+        return e;
+    }
+
+    // inverse of octEncode; the GLSL version in the model shaders must stay identical
+    inline glm::vec3 octDecode(glm::vec2 e)
+    {
+        glm::vec3 n(e.x, e.y, 1.0f - std::fabs(e.x) - std::fabs(e.y));
+        float t = std::fmax(-n.z, 0.0f);
+        n.x += n.x >= 0.0f ? -t : t;
+        n.y += n.y >= 0.0f ? -t : t;
+        return glm::normalize(n);
+    }
+
+    inline int16_t toSnorm16(float value)
+    {
+        return static_cast<int16_t>(std::lround(glm::clamp(value, -1.0f, 1.0f) * 32767.0f));
+    }
+
+    inline int8_t toSnorm8(float value)
+    {
+        return static_cast<int8_t>(std::lround(glm::clamp(value, -1.0f, 1.0f) * 127.0f));
+    }
+
+    inline void encodeNormal(const glm::vec3& normal, int16_t out[2])
+    {
+        glm::vec2 e = octEncode(glm::dot(normal, normal) > 0.0f ? normal : glm::vec3(0.0f, 0.0f, 1.0f));
+        out[0] = toSnorm16(e.x);
+        out[1] = toSnorm16(e.y);
+    }
+
+    // tangent made orthogonal to the normal; the bitangent is rebuilt in the shader as
+    // sign * cross(normal, tangent)
+    inline void encodeTangent(const glm::vec3& normal, const glm::vec3& tangent, const glm::vec3& bitangent, int8_t out[4])
+    {
+        glm::vec3 n = glm::dot(normal, normal) > 0.0f ? glm::normalize(normal) : glm::vec3(0.0f, 0.0f, 1.0f);
+        glm::vec3 t = tangent - n * glm::dot(n, tangent);
+        if (glm::dot(t, t) < 1e-12f)
+        {
+            // no usable tangent (no UVs or tangents in the source): any perpendicular will do
+            t = std::fabs(n.x) < 0.9f ? glm::cross(n, glm::vec3(1.0f, 0.0f, 0.0f)) : glm::cross(n, glm::vec3(0.0f, 1.0f, 0.0f));
+        }
+        glm::vec2 e = octEncode(glm::normalize(t));
+        out[0] = toSnorm8(e.x);
+        out[1] = toSnorm8(e.y);
+        out[2] = glm::dot(glm::cross(n, t), bitangent) < 0.0f ? -127 : 127;
+        out[3] = 0;
+    }
+
+    inline void encodeTexCoords(const glm::vec2& texCoords, uint16_t out[2])
+    {
+        out[0] = glm::packHalf1x16(texCoords.x);
+        out[1] = glm::packHalf1x16(texCoords.y);
+    }
+
+    // bone influences to uint8 ids and unorm8 weights renormalised to sum to exactly 255.
+    // Unused slots (id < 0 or weight 0) become id 0 with weight 0; a vertex without any
+    // influence keeps all weights 0, which the skinned shader treats as "not skinned".
+    inline void encodeBoneWeights(const int ids[4], const float weights[4], uint8_t idsOut[4], uint8_t weightsOut[4])
+    {
+        float total = 0.0f;
+        for (int i = 0; i < 4; i++)
+        {
+            if (ids[i] >= 0 && weights[i] > 0.0f)
+                total += weights[i];
+        }
+        int sum = 0, largest = 0;
+        for (int i = 0; i < 4; i++)
+        {
+            bool used = ids[i] >= 0 && ids[i] <= MAX_COMPACT_BONE_ID && weights[i] > 0.0f && total > 0.0f;
+            idsOut[i] = used ? static_cast<uint8_t>(ids[i]) : 0;
+            weightsOut[i] = used ? static_cast<uint8_t>(std::lround(weights[i] / total * 255.0f)) : 0;
+            sum += weightsOut[i];
+            if (weightsOut[i] > weightsOut[largest])
+                largest = i;
+        }
+        // rounding error goes to the dominant influence
+        if (sum > 0)
+            weightsOut[largest] = static_cast<uint8_t>(weightsOut[largest] + 255 - sum);
+    }
+}
+
+#endif
@@ -0,0 +1,93 @@
+// Offline model bake: imports models and animation clips with Assimp once and writes .bmdl
+// containers (see src/model_cache.h) next to them, so Model and Animation map the processed
+// meshes, bones, hierarchy and keyframes at startup instead of importing the source file.
+//
+//     model_baker <model file | directory>...
+//
+// Directories are searched recursively for .fbx, .dae, .gltf, .glb and .obj files. The import
+// uses the same post-processing as Model, so a baked file serves both Model and Animation.
+#include <assimp/Importer.hpp>
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+
+#include "model_cache.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace
+{
+    bool bake(const std::string& path)
+    {
+        uint64_t sourceSize, sourceHash;
+        if (!TextureCache::hashFile(path, sourceSize, sourceHash))
+        {
+            std::printf("failed to read %s\n", path.c_str());
+            return false;
+        }
+
+        Assimp::Importer importer;
+        const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_CalcTangentSpace);
+        if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
+        {
+            std::printf("failed to import %s: %s\n", path.c_str(), importer.GetErrorString());
+            return false;
+        }
+        ModelCache::SceneData data;
+        ModelCache::extractScene(scene, data);
+
+        std::string output = ModelCache::bakedPath(path);
+        if (!ModelCache::writeBaked(output, data.view(), sourceSize, sourceHash))
+        {
+            std::printf("failed to write %s\n", output.c_str());
+            return false;
+        }
+        std::size_t vertices = 0, keys = 0;
+        for (const ModelCache::MeshData& mesh : data.meshes)
+            vertices += mesh.vertices.size();
+        for (const ModelCache::ChannelData& channel : data.channels)
+            keys += channel.positions.size() + channel.rotations.size() + channel.scales.size();
+        std::printf("%s -> %s (%zu meshes, %zu vertices, %d bones, %zu nodes, %zu channels, %zu keys)\n", path.c_str(),
+            output.c_str(), data.meshes.size(), vertices, data.boneCount, data.nodes.size(), data.channels.size(), keys);
+        return true;
+    }
+
+    bool isModel(const std::filesystem::path& path)
+    {
+        std::string extension = path.extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+        return extension == ".fbx" || extension == ".dae" || extension == ".gltf" || extension == ".glb" || extension == ".obj";
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        std::printf("Usage: %s <model file | directory>...\n", argv[0]);
+        return 1;
+    }
+
+    int failures = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string input = argv[i];
+        std::error_code error;
+        if (std::filesystem::is_directory(input, error))
+        {
+            for (const auto& entry : std::filesystem::recursive_directory_iterator(input, error))
+            {
+                if (entry.is_regular_file() && isModel(entry.path()))
+                    failures += !bake(entry.path().generic_string());
+            }
+        }
+        else
+        {
+            failures += !bake(input);
+        }
+    }
+    return failures == 0 ? 0 : 1;
+}
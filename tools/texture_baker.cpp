@@ -0,0 +1,211 @@
+// Offline texture bake: converts PNGs into .btex containers (see src/texture_cache.h) holding
+// the full mip chain, so the game maps them and uploads without decoding or glGenerateMipmap.
+//
+//     texture_baker [--bc1] [--no-flip] <file.png | directory>...
+//
+// Directories are searched recursively for .png files. Textures are flipped vertically like
+// the runtime loader does for 2D textures; pass --no-flip for cubemap faces. --bc1 stores
+// textures without alpha as DXT1 blocks (8:1 against RGBA, 6:1 against RGB).
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+#define STB_DXT_IMPLEMENTATION
+#include <stb_dxt.h>
+
+#include "texture_cache.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace
+{
+    struct Options
+    {
+        bool bc1 = false;
+        bool flip = true;
+    };
+
+    // 2x2 box filter; odd sizes repeat their last row/column
+    std::vector<unsigned char> downsample(const std::vector<unsigned char>& source, int width, int height, int channels)
+    {
+        int nextWidth = std::max(1, width / 2);
+        int nextHeight = std::max(1, height / 2);
+        std::vector<unsigned char> result(static_cast<std::size_t>(nextWidth) * nextHeight * channels);
+        for (int y = 0; y < nextHeight; y++)
+        {
+            int y0 = std::min(y * 2, height - 1), y1 = std::min(y * 2 + 1, height - 1);
+            for (int x = 0; x < nextWidth; x++)
+            {
+                int x0 = std::min(x * 2, width - 1), x1 = std::min(x * 2 + 1, width - 1);
+                for (int c = 0; c < channels; c++)
+                {
+                    int sum = source[(static_cast<std::size_t>(y0) * width + x0) * channels + c]
+                        + source[(static_cast<std::size_t>(y0) * width + x1) * channels + c]
+                        + source[(static_cast<std::size_t>(y1) * width + x0) * channels + c]
+                        + source[(static_cast<std::size_t>(y1) * width + x1) * channels + c];
+                    result[(static_cast<std::size_t>(y) * nextWidth + x) * channels + c] = static_cast<unsigned char>((sum + 2) / 4);
+                }
+            }
+        }
+        return result;
+    }
+
+    // DXT1-encode one level; edge blocks repeat the last row/column
+    std::vector<unsigned char> compressBC1(const std::vector<unsigned char>& source, int width, int height, int channels)
+    {
+        int blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+        std::vector<unsigned char> result(static_cast<std::size_t>(blocksX) * blocksY * 8);
+        unsigned char block[16 * 4];
+        for (int by = 0; by < blocksY; by++)
+        {
+            for (int bx = 0; bx < blocksX; bx++)
+            {
+                for (int i = 0; i < 16; i++)
+                {
+                    int x = std::min(bx * 4 + i % 4, width - 1);
+                    int y = std::min(by * 4 + i / 4, height - 1);
+                    const unsigned char* pixel = &source[(static_cast<std::size_t>(y) * width + x) * channels];
+                    block[i * 4 + 0] = pixel[0];
+                    block[i * 4 + 1] = channels >= 3 ? pixel[1] : pixel[0];
+                    block[i * 4 + 2] = channels >= 3 ? pixel[2] : pixel[0];
+                    block[i * 4 + 3] = 255;
+                }
+                stb_compress_dxt_block(&result[(static_cast<std::size_t>(by) * blocksX + bx) * 8], block, 0, STB_DXT_HIGHQUAL);
+            }
+        }
+        return result;
+    }
+
+    bool bake(const std::string& path, const Options& options)
+    {
+        TextureFileHeader header;
+        if (!TextureCache::hashFile(path, header.sourceSize, header.sourceHash))
+        {
+            std::printf("failed to read %s\n", path.c_str());
+            return false;
+        }
+
+        stbi_set_flip_vertically_on_load(options.flip);
+        int width, height, channels;
+        unsigned char* pixels = stbi_load(path.c_str(), &width, &height, &channels, 0);
+        if (pixels == NULL)
+        {
+            std::printf("failed to decode %s: %s\n", path.c_str(), stbi_failure_reason());
+            return false;
+        }
+        // two-channel images are expanded, the runtime formats are R, RGB and RGBA
+        int storedChannels = channels == 2 ? 4 : channels;
+        std::vector<unsigned char> level(static_cast<std::size_t>(width) * height * storedChannels);
+        for (std::size_t i = 0; i < static_cast<std::size_t>(width) * height; i++)
+        {
+            if (channels == 2)
+            {
+                level[i * 4 + 0] = level[i * 4 + 1] = level[i * 4 + 2] = pixels[i * 2];
+                level[i * 4 + 3] = pixels[i * 2 + 1];
+            }
+            else
+            {
+                std::memcpy(&level[i * channels], &pixels[i * channels], channels);
+            }
+        }
+        stbi_image_free(pixels);
+
+        // fully opaque RGBA images lose nothing when their alpha is dropped for BC1
+        bool opaque = storedChannels != 4;
+        if (!opaque && options.bc1)
+        {
+            opaque = true;
+            for (std::size_t i = 3; i < level.size() && opaque; i += 4)
+                opaque = level[i] == 255;
+        }
+        bool compress = options.bc1 && opaque;
+        if (compress)
+            header.format = static_cast<uint32_t>(TextureFileFormat::BC1);
+        else if (storedChannels == 1)
+            header.format = static_cast<uint32_t>(TextureFileFormat::R8);
+        else if (storedChannels == 3)
+            header.format = static_cast<uint32_t>(TextureFileFormat::RGB8);
+        else
+            header.format = static_cast<uint32_t>(TextureFileFormat::RGBA8);
+        if (options.bc1 && !compress)
+            std::printf("%s has alpha, stored uncompressed\n", path.c_str());
+        header.width = width;
+        header.height = height;
+        header.flags = options.flip ? TextureFileHeader::FLAG_FLIPPED : 0;
+
+        // full chain down to 1x1, as glGenerateMipmap would produce
+        std::vector<std::vector<unsigned char>> levels;
+        int levelWidth = width, levelHeight = height;
+        while (true)
+        {
+            levels.push_back(compress ? compressBC1(level, levelWidth, levelHeight, storedChannels) : level);
+            if (levelWidth == 1 && levelHeight == 1)
+                break;
+            level = downsample(level, levelWidth, levelHeight, storedChannels);
+            levelWidth = std::max(1, levelWidth / 2);
+            levelHeight = std::max(1, levelHeight / 2);
+        }
+        header.levelCount = static_cast<uint32_t>(levels.size());
+
+        std::vector<const unsigned char*> levelPointers;
+        uint64_t bytes = 0;
+        for (const std::vector<unsigned char>& data : levels)
+        {
+            levelPointers.push_back(data.data());
+            bytes += data.size();
+        }
+        std::string output = TextureCache::bakedPath(path);
+        if (!TextureCache::writeBaked(output, header, levelPointers))
+        {
+            std::printf("failed to write %s\n", output.c_str());
+            return false;
+        }
+        std::printf("%s -> %s (%dx%d, %u levels, %.1f KiB%s)\n", path.c_str(), output.c_str(), width, height,
+            header.levelCount, bytes / 1024.0, compress ? ", BC1" : "");
+        return true;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    std::vector<std::string> inputs;
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--bc1") == 0)
+            options.bc1 = true;
+        else if (std::strcmp(argv[i], "--no-flip") == 0)
+            options.flip = false;
+        else
+            inputs.push_back(argv[i]);
+    }
+    if (inputs.empty())
+    {
+        std::printf("Usage: %s [--bc1] [--no-flip] <file.png | directory>...\n", argv[0]);
+        return 1;
+    }
+
+    int failures = 0;
+    for (const std::string& input : inputs)
+    {
+        std::error_code error;
+        if (std::filesystem::is_directory(input, error))
+        {
+            for (const auto& entry : std::filesystem::recursive_directory_iterator(input, error))
+            {
+                std::string extension = entry.path().extension().string();
+                std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+                if (entry.is_regular_file() && extension == ".png")
+                    failures += !bake(entry.path().generic_string(), options);
+            }
+        }
+        else
+        {
+            failures += !bake(input, options);
+        }
+    }
+    return failures == 0 ? 0 : 1;
+}